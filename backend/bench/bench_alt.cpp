@@ -0,0 +1,81 @@
+// A* с ориентирами (ALT) против Дейкстры: извлеченные состояния и время запроса.
+// Без ориентиров solve_request_alt — тот же ограниченный целями Дейкстра
+// (h = 0), поэтому число извлечений сравнимо напрямую.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "landmarks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 50;
+
+    const FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 0.6, 0.2};
+    model.trans = {{{0.0, 2.0, 3.0}, {2.0, 0.0, 2.5}, {3.0, 2.5, 0.0}}};
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+
+    // Пары в случайных точках сети: одна цель на запрос.
+    unsigned seed = 2024u;
+    auto next = [&seed](int mod) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 8) % static_cast<unsigned>(mod));
+    };
+    std::vector<Request> requests;
+    for (int q = 0; q < queries; ++q) {
+        Request rq;
+        rq.start = 1 + next(fg.n);
+        rq.k = 1.0;
+        rq.targets = {1 + next(fg.n)};
+        requests.push_back(rq);
+    }
+
+    std::printf("network: %d stations, %d edges, %d queries\n", fg.n, fg.m, queries);
+
+    // Эталон: ограниченный целями Дейкстра (без двунаправленного поиска).
+    SearchOptions plain;
+    plain.bidirectional = false;
+    std::vector<std::vector<Route>> reference;
+    auto t0 = Clock::now();
+    for (const Request& rq : requests) {
+        reference.push_back(solve_request(fg, model, rq, plain));
+    }
+    const double reference_ms = ms_since(t0) / queries;
+    std::printf("dijkstra: %.3f ms per query\n", reference_ms);
+
+    double plain_settled = 0.0;
+    for (int count : {0, 4, 8, 16, 32}) {
+        t0 = Clock::now();
+        const Landmarks lm = build_landmarks(fg, count);
+        const double build_ms = ms_since(t0);
+
+        std::size_t settled = 0;
+        double max_error = 0.0;
+        t0 = Clock::now();
+        for (std::size_t q = 0; q < requests.size(); ++q) {
+            const std::vector<Route> routes = solve_request_alt(lm, fg, model, requests[q], &settled);
+            for (std::size_t i = 0; i < routes.size(); ++i) {
+                if (routes[i].reachable) {
+                    max_error = std::max(max_error, std::fabs(routes[i].time - reference[q][i].time));
+                }
+            }
+        }
+        const double ms = ms_since(t0) / queries;
+        const double per_query = static_cast<double>(settled) / queries;
+        if (count == 0) {
+            plain_settled = per_query;
+        }
+        std::printf("alt %2d landmarks: build %.1f ms, %.0f settled states per query (reduction %.2fx), "
+                    "%.3f ms per query (%.2fx), max time error %.2g\n",
+                    count, build_ms, per_query, plain_settled / per_query, ms, reference_ms / ms, max_error);
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Кэш деревьев кратчайших путей на скошенном потоке запросов: большая
+// часть запросов — из нескольких узловых станций.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "path_tree_cache.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    const int hubs = (argc > 3) ? std::atoi(argv[3]) : 8;
+    const int hub_percent = (argc > 4) ? std::atoi(argv[4]) : 90;
+    const int cache_mb = (argc > 5) ? std::atoi(argv[5]) : 256;
+
+    const FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::printf("network: %d stations, %d edges; %d queries, %d%% from %d hubs\n",
+                fg.n, fg.m, queries, hub_percent, hubs);
+
+    unsigned seed = 2024u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<Request> requests(static_cast<std::size_t>(queries));
+    for (Request& rq : requests) {
+        const bool hub = static_cast<int>(next(100)) < hub_percent;
+        rq.start = hub ? 1 + static_cast<int>(next(static_cast<unsigned>(hubs))) * (fg.n / hubs)
+                       : 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+        rq.k = 1.0;
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(1 + static_cast<int>(next(static_cast<unsigned>(fg.n))));
+        }
+    }
+
+    double checksum = 0.0;
+    auto t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (const Route& r : solve_request(fg, model, rq)) {
+            checksum += r.time;
+        }
+    }
+    const double plain_ms = ms_since(t0);
+    std::printf("no cache: %8.3f ms per query (checksum %.1f)\n", plain_ms / queries, checksum);
+
+    PathTreeCache cache(static_cast<std::size_t>(cache_mb) << 20);
+    SearchOptions options;
+    options.tree_cache = &cache;
+    options.model_fingerprint = model_fingerprint(model);
+    checksum = 0.0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (const Route& r : solve_request(fg, model, rq, options)) {
+            checksum += r.time;
+        }
+    }
+    const double cached_ms = ms_since(t0);
+    const PathTreeCacheStats stats = cache.stats();
+    std::printf("cache   : %8.3f ms per query (checksum %.1f), speedup %.2fx\n",
+                cached_ms / queries, checksum, plain_ms / cached_ms);
+    std::printf("          %llu hits, %llu misses, %llu evictions, %zu trees, %.1f MB\n",
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                static_cast<unsigned long long>(stats.evictions), stats.entries,
+                static_cast<double>(stats.bytes) / (1 << 20));
+    return 0;
+}
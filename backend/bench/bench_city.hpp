@@ -0,0 +1,53 @@
+// Общие генераторы для бенчмарков backend.
+#ifndef BENCH_CITY_HPP
+#define BENCH_CITY_HPP
+
+#include <chrono>
+
+#include "models/graph.hpp"
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// metro_step — шаг сетки линий метро (меньше — плотнее наложение метро/автобус).
+inline Graph make_city(int side, int metro_step = 8) {
+    Graph g;
+    graph_init(g, side * side);
+    auto id = [side](int r, int c) { return r * side + c + 1; };
+
+    unsigned seed = 12345u;
+    auto next_load = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<double>((seed >> 16) % 101) / 100.0;
+    };
+
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            if (c + 1 < side) graph_add_undirected(g, id(r, c), id(r, c + 1), MODE_BUS, 3.0, next_load());
+            if (r + 1 < side) graph_add_undirected(g, id(r, c), id(r + 1, c), MODE_BUS, 3.0, next_load());
+        }
+    }
+    for (int r = 0; r < side; r += metro_step) {
+        for (int c = 0; c + 4 < side; c += 4) {
+            graph_add_undirected(g, id(r, c), id(r, c + 4), MODE_METRO, 4.0, next_load());
+        }
+    }
+    for (int c = 0; c < side; c += metro_step) {
+        for (int r = 0; r + 4 < side; r += 4) {
+            graph_add_undirected(g, id(r, c), id(r + 4, c), MODE_METRO, 4.0, next_load());
+        }
+    }
+    for (int k = 0; k + 16 < side; k += 16) {
+        graph_add_undirected(g, id(k, k), id(k + 16, k + 16), MODE_RAIL, 9.0, next_load());
+    }
+    return g;
+}
+
+} // namespace bench
+
+#endif // BENCH_CITY_HPP
@@ -0,0 +1,60 @@
+// Компоненты связности: DFS с явным стеком против параллельного union-find
+// (Afforest) на 1..N потоках. Сети — решетка "города" и длинный ж/д коридор.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+Graph make_corridor(int n) {
+    Graph g;
+    graph_init(g, n);
+    for (int v = 1; v < n; ++v) {
+        graph_add_undirected(g, v, v + 1, MODE_RAIL, 1.0, 0.0);
+    }
+    return g;
+}
+
+// Время на четыре вида (metro, bus, rail, all) и число компонент как контроль.
+double run(const FrozenGraph& fg, int threads, int reps, std::size_t& zones) {
+    zones = 0;
+    const auto t0 = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+            zones += get_connected_components(fg, t, threads).size();
+        }
+    }
+    return ms_since(t0) / reps;
+}
+
+void report(const char* name, const FrozenGraph& fg, int max_threads, int reps) {
+    std::printf("%s: %d stations, %d edges\n", name, fg.n, fg.m);
+    std::size_t zones = 0;
+    const double dfs_ms = run(fg, 1, reps, zones);
+    std::printf("  dfs          : %8.2f ms (%zu zones)\n", dfs_ms, zones);
+    for (int threads = 2; threads <= max_threads; threads *= 2) {
+        const double ms = run(fg, threads, reps, zones);
+        std::printf("  union-find %2d: %8.2f ms (%zu zones), speedup %.2fx\n", threads, ms, zones, dfs_ms / ms);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 700;
+    const int corridor = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+    const int reps = (argc > 3) ? std::atoi(argv[3]) : 3;
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    const int max_threads = (argc > 4) ? std::atoi(argv[4]) : (hw > 1 ? hw : 2);
+
+    std::printf("hardware threads: %d\n", hw);
+    report("city", freeze_graph(make_city(side)), max_threads, reps);
+    report("corridor", freeze_graph(make_corridor(corridor)), max_threads, reps);
+    return 0;
+}
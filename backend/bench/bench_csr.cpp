@@ -0,0 +1,66 @@
+// Сравнение раскладок графа: списки смежности (Graph) против CSR-снимка (FrozenGraph).
+// Сеть "города": решетка автобусов side x side, радиальные линии метро, редкая ж/д.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 300;
+    const int reps = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    const Graph g = make_city(side);
+    ModelParams model{};
+    model.sensitivity = {0.3, 0.6, 0.2};
+    model.trans = {{{0.0, 2.0, 3.0}, {2.0, 0.0, 2.5}, {3.0, 2.5, 0.0}}};
+    model.station_transfer.assign(static_cast<std::size_t>(g.n) + 1, 0.5);
+
+    auto t0 = Clock::now();
+    const FrozenGraph fg = freeze_graph(g);
+    const double freeze_ms = ms_since(t0);
+
+    std::printf("network: %d stations, %d edges\n", g.n, g.m);
+    std::printf("memory: Graph %.1f MiB, FrozenGraph %.1f MiB\n",
+                static_cast<double>(graph_memory_bytes(g)) / (1024.0 * 1024.0),
+                static_cast<double>(fg.memory_bytes()) / (1024.0 * 1024.0));
+    std::printf("freeze_graph: %.2f ms\n", freeze_ms);
+
+    // Полный проход по всем рёбрам: показывает цену "прыжков" между блоками кучи.
+    double sum = 0.0;
+    t0 = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (int u = 1; u <= g.n; ++u) {
+            for (const Edge& e : g.adj[u]) sum += e.base_time * e.load + e.to;
+        }
+    }
+    const double sweep_list = ms_since(t0) / reps;
+    t0 = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (std::size_t a = 0; a < fg.arc_count(); ++a) sum += fg.base_time[a] * fg.load[a] + fg.to[a];
+    }
+    const double sweep_csr = ms_since(t0) / reps;
+    std::printf("edge sweep: lists %.2f ms, csr %.2f ms (checksum %.0f)\n", sweep_list, sweep_csr, sum);
+
+    t0 = Clock::now();
+    std::size_t zones = 0;
+    for (int r = 0; r < reps; ++r) {
+        for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+            zones += get_connected_components(fg, t).size();
+        }
+    }
+    std::printf("components x4 (csr): %.2f ms (%zu)\n", ms_since(t0) / reps, zones);
+
+    t0 = Clock::now();
+    double reach = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        const DijkstraStateResult dj = dijkstra_states(fg, model, 1 + (r * 7919) % g.n);
+        reach += dj.time(g.n, MODE_BUS);
+    }
+    std::printf("dijkstra_states (csr): %.2f ms per query (%.1f)\n", ms_since(t0) / reps, reach);
+
+    return 0;
+}
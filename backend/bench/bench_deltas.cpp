@@ -0,0 +1,67 @@
+// Поток изменений загрузки: пакеты frozen_apply_deltas против пересборки
+// снимка (freeze_graph) после каждого пакета.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 300;
+    const int batch = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    const int batches = (argc > 3) ? std::atoi(argv[3]) : 200;
+
+    Graph g = make_city(side);
+    std::printf("network: %d stations, %d edges, %d batches of %d updates\n", g.n, g.m, batches, batch);
+
+    unsigned seed = 7u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<std::vector<EdgeDelta>> feed(static_cast<std::size_t>(batches));
+    for (auto& deltas : feed) {
+        for (int i = 0; i < batch; ++i) {
+            EdgeDelta d;
+            d.id = static_cast<int>(next(static_cast<unsigned>(g.next_id)));
+            d.base_time = 1.0 + next(8);
+            d.load = static_cast<double>(next(101)) / 100.0;
+            deltas.push_back(d);
+        }
+    }
+
+    FrozenGraph fg = freeze_graph(g);
+    std::string error;
+    auto t0 = Clock::now();
+    frozen_apply_deltas(fg, {}, error);
+    frozen_update_edge(fg, 0, 3.0, 0.5); // первое изменение: копия весов и индекс
+    std::printf("first update (index): %.2f ms\n", ms_since(t0));
+
+    t0 = Clock::now();
+    for (const auto& deltas : feed) {
+        if (!frozen_apply_deltas(fg, deltas, error)) {
+            std::printf("%s\n", error.c_str());
+            return 1;
+        }
+    }
+    const double delta_ms = ms_since(t0);
+    const double updates = static_cast<double>(batch) * batches;
+    std::printf("deltas: %.3f ms per batch, %.2f M updates/s\n", delta_ms / batches, updates / delta_ms / 1000.0);
+
+    // Пересборка: Graph обновляется по id, затем новый снимок.
+    const int samples = batches < 5 ? batches : 5;
+    t0 = Clock::now();
+    for (int b = 0; b < samples; ++b) {
+        for (const EdgeDelta& d : feed[static_cast<std::size_t>(b)]) {
+            graph_update_edge(g, d.id, d.base_time, d.load);
+        }
+        fg = freeze_graph(g);
+    }
+    const double rebuild_ms = ms_since(t0) / samples;
+    std::printf("rebuild: %.3f ms per batch, speedup %.0fx\n", rebuild_ms, rebuild_ms / (delta_ms / batches));
+    return 0;
+}
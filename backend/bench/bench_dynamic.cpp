@@ -0,0 +1,79 @@
+// Закрытие и открытие перегонов: динамические зоны (HDT) против пересчета
+// компонент по снимку после каждого изменения.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "dynamic_connectivity.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 300;
+    const int changes = (argc > 2) ? std::atoi(argv[2]) : 20000;
+
+    const Graph g = make_city(side);
+    std::printf("network: %d stations, %d edges, %d changes\n", g.n, g.m, changes);
+
+    auto t0 = Clock::now();
+    DynamicGraph dg;
+    dynamic_graph_init(dg, g);
+    std::printf("dynamic_graph_init: %.1f ms\n", ms_since(t0));
+
+    // Закрыть случайный открытый перегон или вновь открыть закрытый.
+    unsigned seed = 99u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<int> open;
+    for (int id = 0; id < g.next_id; ++id) {
+        open.push_back(id);
+    }
+    std::vector<DynamicGraph::EdgeEnds> closed;
+
+    std::size_t zones = 0;
+    t0 = Clock::now();
+    for (int c = 0; c < changes; ++c) {
+        if (closed.empty() || next(2) == 0) {
+            const std::size_t i = next(static_cast<unsigned>(open.size()));
+            closed.push_back(dg.ends[static_cast<std::size_t>(open[i])]);
+            dynamic_graph_remove(dg, open[i]);
+            open[i] = open.back();
+            open.pop_back();
+        } else {
+            const std::size_t i = next(static_cast<unsigned>(closed.size()));
+            const DynamicGraph::EdgeEnds e = closed[i];
+            closed[i] = closed.back();
+            closed.pop_back();
+            open.push_back(dynamic_graph_add(dg, e.u, e.v, e.mode, 3.0, 0.5));
+        }
+        for (const DynamicConnectivity& z : dg.zones) {
+            zones += static_cast<std::size_t>(z.component_count());
+        }
+    }
+    const double dynamic_us = ms_since(t0) * 1000.0 / changes;
+    std::printf("dynamic: %.2f us per change (zone count checksum %zu)\n", dynamic_us, zones);
+
+    // Пересчет: снимок и компоненты четырех видов.
+    const int samples = 5;
+    t0 = Clock::now();
+    for (int r = 0; r < samples; ++r) {
+        const FrozenGraph fg = freeze_graph(dg.g);
+        for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+            zones += get_connected_components(fg, t).size();
+        }
+    }
+    const double static_us = ms_since(t0) * 1000.0 / samples;
+    std::printf("recompute: %.2f us per change, speedup %.0fx\n", static_us, static_us / dynamic_us);
+
+    const FrozenGraph fg = freeze_graph(dg.g);
+    bool same = true;
+    for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+        same = same && (dynamic_isolated_zones(dg, t) == get_isolated_zones(fg, t));
+    }
+    std::printf("isolated zones match recompute: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Матрица S x T: запрос solve_request на каждый источник (маршруты до всех
+// целей) против travel_time_matrix без иерархии и со схемой корзин.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "contraction.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 100;
+    const int s_count = (argc > 2) ? std::atoi(argv[2]) : 100;
+    const int t_count = (argc > 3) ? std::atoi(argv[3]) : 100;
+
+    const FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::printf("network: %d stations, %d edges; %d x %d matrix\n", fg.n, fg.m, s_count, t_count);
+
+    unsigned seed = 11u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<int> sources(static_cast<std::size_t>(s_count));
+    std::vector<int> targets(static_cast<std::size_t>(t_count));
+    for (int& s : sources) {
+        s = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+    }
+    for (int& t : targets) {
+        t = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+    }
+
+    double route_sum = 0.0;
+    auto t0 = Clock::now();
+    for (int s : sources) {
+        Request rq;
+        rq.start = s;
+        rq.targets = targets;
+        for (const Route& r : solve_request(fg, model, rq)) {
+            route_sum += r.reachable ? r.time : 0.0;
+        }
+    }
+    const double route_ms = ms_since(t0);
+
+    auto sum_of = [](const TravelMatrix& m) {
+        double sum = 0.0;
+        for (std::size_t c = 0; c < m.time.size(); ++c) {
+            sum += m.transfers[c] >= 0 ? m.time[c] : 0.0;
+        }
+        return sum;
+    };
+
+    t0 = Clock::now();
+    const TravelMatrix plain = travel_time_matrix(fg, model, sources, targets);
+    const double plain_ms = ms_since(t0);
+
+    t0 = Clock::now();
+    const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+    const double ch_build_ms = ms_since(t0);
+    SearchOptions options;
+    options.hierarchy = &ch;
+
+    double ch_route_sum = 0.0;
+    t0 = Clock::now();
+    for (int s : sources) {
+        Request rq;
+        rq.start = s;
+        rq.targets = targets;
+        for (const Route& r : solve_request(fg, model, rq, options)) {
+            ch_route_sum += r.reachable ? r.time : 0.0;
+        }
+    }
+    const double ch_route_ms = ms_since(t0);
+
+    t0 = Clock::now();
+    const TravelMatrix buckets = travel_time_matrix(fg, model, sources, targets, options);
+    const double buckets_ms = ms_since(t0);
+
+    std::printf("solve_request per source : %9.1f ms (time sum %.1f)\n", route_ms, route_sum);
+    std::printf("matrix, dijkstra         : %9.1f ms (time sum %.1f)\n", plain_ms, sum_of(plain));
+    std::printf("ch build                 : %9.1f ms\n", ch_build_ms);
+    std::printf("ch solve_request         : %9.1f ms (time sum %.1f)\n", ch_route_ms, ch_route_sum);
+    std::printf("matrix, ch buckets       : %9.1f ms (time sum %.1f), %.1fx faster than ch per source\n",
+                buckets_ms, sum_of(buckets), ch_route_ms / buckets_ms);
+    return plain.transfers == buckets.transfers ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+// Набор бенчмарков backend на нескольких масштабах сети "города":
+// микро — parse_all, validate_all, get_connected_components по видам,
+// dijkstra_states, build_route_to_target, quicksort_routes, печать готовых
+// ответов текстом и JSON; макро — запрос solve_request и полный проход CLI
+// (разбор, проверка, зоны, пакет запросов).
+// Каждый случай измеряется samples раз после прогрева; в отчет идут
+// min/mean/p50/p90/p99/max в наносекундах на операцию (ops операций в
+// замере). Формат — JSON (по умолчанию) или CSV, в stdout или в файл.
+//
+//   bench_navigator [--scales 50,100,200] [--samples 20] [--queries 200]
+//                   [--format json|csv] [--out FILE]
+#include "algorithms.hpp"
+#include "batch.hpp"
+#include "bench_city.hpp"
+#include "parser.hpp"
+#include "report.hpp"
+#include "validator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+struct Options {
+    std::vector<int> scales{50, 100, 200};
+    int samples = 20;
+    int queries = 200;
+    std::string format = "json";
+    std::string out;
+};
+
+// Результат случая: времена замеров в нс на операцию.
+struct Result {
+    std::string name;
+    int scale = 0;
+    int stations = 0;
+    int edges = 0;
+    int ops = 0;
+    std::vector<double> ns;
+};
+
+// Перцентиль по рангу (nearest rank) отсортированной выборки.
+double percentile(const std::vector<double>& sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.999999);
+    rank = std::min(std::max<std::size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+struct Summary {
+    double min = 0.0, mean = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+Summary summarize(std::vector<double> ns) {
+    Summary s;
+    if (ns.empty()) {
+        return s;
+    }
+    std::sort(ns.begin(), ns.end());
+    double sum = 0.0;
+    for (double x : ns) {
+        sum += x;
+    }
+    s.min = ns.front();
+    s.max = ns.back();
+    s.mean = sum / static_cast<double>(ns.size());
+    s.p50 = percentile(ns, 50.0);
+    s.p90 = percentile(ns, 90.0);
+    s.p99 = percentile(ns, 99.0);
+    return s;
+}
+
+// Прогрев и samples замеров; prepare (вне замера) готовит данные замера i,
+// run выполняет ops операций.
+Result measure(const std::string& name, int scale, const FrozenGraph& fg, int samples, int ops,
+               const std::function<void(int)>& prepare, const std::function<void(int)>& run) {
+    Result r;
+    r.name = name;
+    r.scale = scale;
+    r.stations = fg.n;
+    r.edges = fg.m;
+    r.ops = ops;
+    prepare(-1);
+    run(-1);
+    for (int i = 0; i < samples; ++i) {
+        prepare(i);
+        const Clock::time_point t0 = Clock::now();
+        run(i);
+        r.ns.push_back(ms_since(t0) * 1e6 / ops);
+    }
+    return r;
+}
+
+// Текст входа CLI: сеть graph с моделью model и блок запросов.
+std::string make_text(const Graph& g, const ModelParams& model, const std::vector<Request>& requests) {
+    std::ostringstream out;
+    out << g.n << ' ' << g.m << '\n';
+    out << model.sensitivity[0] << ' ' << model.sensitivity[1] << ' ' << model.sensitivity[2] << '\n';
+    for (const auto& row : model.trans) {
+        out << row[0] << ' ' << row[1] << ' ' << row[2] << '\n';
+    }
+    for (int v = 1; v <= g.n; ++v) {
+        out << model.station_transfer[static_cast<std::size_t>(v)] << (v == g.n ? '\n' : ' ');
+    }
+    // Ребра в порядке id (номер строки ребра во входе).
+    for (int id = 0; id < g.next_id; ++id) {
+        const EdgeSlot& slot = g.slots[static_cast<std::size_t>(id)];
+        if (slot.u < 0) {
+            continue;
+        }
+        const Edge& e = g.adj[static_cast<std::size_t>(slot.u)][static_cast<std::size_t>(slot.iu)];
+        out << slot.u << ' ' << e.to << ' ' << e.mode << ' ' << e.base_time << ' ' << e.load << '\n';
+    }
+    out << requests.size() << '\n';
+    for (const Request& rq : requests) {
+        out << rq.start << ' ' << rq.targets.size() << ' ' << rq.k;
+        for (int t : rq.targets) {
+            out << ' ' << t;
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+std::vector<Result> run_scale(int side, const Options& options) {
+    const Graph g = make_city(side);
+    const FrozenGraph fg = freeze_graph(g);
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+            model.trans[a][b] = a == b ? 0.0 : 1.0 + a + b;
+        }
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+
+    unsigned seed = 2024u + static_cast<unsigned>(side);
+    auto next = [&seed](int mod) {
+        seed = seed * 1103515245u + 12345u;
+        return 1 + static_cast<int>((seed >> 8) % static_cast<unsigned>(mod));
+    };
+    std::vector<Request> requests(static_cast<std::size_t>(options.queries));
+    for (Request& rq : requests) {
+        rq.start = next(fg.n);
+        rq.k = 2.0;
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(next(fg.n));
+        }
+    }
+    const std::string text = make_text(g, model, requests);
+
+    std::vector<Result> results;
+    const int samples = options.samples;
+    const auto nothing = [](int) {};
+
+    // Разбор и проверка входа.
+    InputData data;
+    std::string error;
+    results.push_back(measure("parse_all", side, fg, samples, 1, nothing, [&](int) {
+        TextCursor in = make_cursor(text.data(), text.size());
+        if (!parse_all(in, data, error)) {
+            std::cerr << "bench_navigator: " << error << "\n";
+            std::exit(1);
+        }
+    }));
+    results.push_back(measure("validate_all", side, fg, samples, 1, nothing, [&](int) {
+        if (!validate_all(data, error)) {
+            std::cerr << "bench_navigator: " << error << "\n";
+            std::exit(1);
+        }
+    }));
+
+    // Компоненты по видам транспорта.
+    const std::pair<const char*, TransportType> types[] = {
+        {"components_metro", TransportType::Metro},
+        {"components_bus", TransportType::Bus},
+        {"components_rail", TransportType::Rail},
+        {"components_all", TransportType::All},
+    };
+    std::size_t zones = 0;
+    for (const auto& [name, type] : types) {
+        results.push_back(measure(name, side, fg, samples, 1, nothing, [&, type = type](int) {
+            zones += get_connected_components(fg, type).size();
+        }));
+    }
+
+    // Полный проход Дейкстры и восстановление маршрутов по его таблицам.
+    SearchWorkspace ws;
+    results.push_back(measure("dijkstra_states", side, fg, samples, 1, nothing, [&](int i) {
+        dijkstra_states(fg, model, requests[static_cast<std::size_t>(i + 1)].start, ws);
+    }));
+    const int route_ops = 100;
+    std::vector<Route> routes;
+    routes.reserve(static_cast<std::size_t>(route_ops));
+    results.push_back(measure("build_route_to_target", side, fg, samples, route_ops,
+        [&](int) { routes.clear(); },
+        [&](int) {
+            for (int j = 0; j < route_ops; ++j) {
+                routes.push_back(build_route_to_target(ws, next(fg.n), 2.0));
+            }
+        }));
+
+    // Сортировка маршрутов: копия перемешанного списка готовится вне замера.
+    std::vector<Route> shuffled;
+    for (int j = 0; j < 1000; ++j) {
+        shuffled.push_back(build_route_to_target(ws, next(fg.n), 2.0));
+    }
+    std::vector<Route> sorted;
+    results.push_back(measure("quicksort_routes_1000", side, fg, samples, 1,
+        [&](int i) {
+            std::rotate(shuffled.begin(), shuffled.begin() + 1 + (i + 1) % 97, shuffled.end());
+            sorted = shuffled;
+        },
+        [&](int) { quicksort_routes(sorted, 0, static_cast<int>(sorted.size()) - 1); }));
+
+    // Печать готовых ответов: текстовые блоки REQUEST против --format json.
+    const int report_ops = std::min(options.queries, 50);
+    std::vector<std::vector<Route>> answers;
+    for (int j = 0; j < report_ops; ++j) {
+        answers.push_back(solve_request(fg, model, requests[static_cast<std::size_t>(j)], SearchOptions{}, ws));
+    }
+    std::size_t report_bytes = 0;
+    results.push_back(measure("report_text", side, fg, samples, report_ops, nothing, [&](int) {
+        std::ostringstream out;
+        for (int j = 0; j < report_ops; ++j) {
+            const std::size_t q = static_cast<std::size_t>(j);
+            print_request(out, q, requests[q], answers[q], static_cast<std::size_t>(report_ops));
+        }
+        report_bytes += out.str().size();
+    }));
+    results.push_back(measure("report_json", side, fg, samples, report_ops, nothing, [&](int) {
+        OutputBuffer out;
+        for (int j = 0; j < report_ops; ++j) {
+            const std::size_t q = static_cast<std::size_t>(j);
+            write_request_json(out, requests[q], answers[q]);
+        }
+        report_bytes += out.str().size();
+    }));
+
+    // Макро: запрос с тремя целями и полный проход CLI по тексту.
+    const int query_ops = std::min(options.queries, 50);
+    results.push_back(measure("solve_request", side, fg, samples, query_ops, nothing, [&](int) {
+        for (int j = 0; j < query_ops; ++j) {
+            solve_request(fg, model, requests[static_cast<std::size_t>(j)], SearchOptions{}, ws);
+        }
+    }));
+    results.push_back(measure("pipeline", side, fg, std::max(1, samples / 4), 1, nothing, [&](int) {
+        InputData input;
+        TextCursor in = make_cursor(text.data(), text.size());
+        if (!parse_all(in, input, error) || !validate_all(input, error)) {
+            std::cerr << "bench_navigator: " << error << "\n";
+            std::exit(1);
+        }
+        const FrozenGraph frozen = freeze_graph(input.g);
+        std::ostringstream out;
+        print_zones_report(out, frozen);
+        solve_batch(frozen, input.model, SearchOptions{}, input.requests, 1,
+                    [&](std::size_t i, const std::vector<Route>& answer) {
+                        print_request(out, i, input.requests[i], answer, input.requests.size());
+                    });
+    }));
+    if (zones == 0 || report_bytes == 0) {
+        std::cerr << "bench_navigator: empty result\n";
+    }
+    return results;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results) {
+    out << std::fixed << std::setprecision(1) << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const Summary s = summarize(r.ns);
+        out << "  {\"name\": \"" << r.name << "\", \"scale\": " << r.scale << ", \"stations\": " << r.stations
+            << ", \"edges\": " << r.edges << ", \"ops\": " << r.ops << ", \"samples\": " << r.ns.size()
+            << ", \"min_ns\": " << s.min << ", \"mean_ns\": " << s.mean << ", \"p50_ns\": " << s.p50
+            << ", \"p90_ns\": " << s.p90 << ", \"p99_ns\": " << s.p99 << ", \"max_ns\": " << s.max << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+void write_csv(std::ostream& out, const std::vector<Result>& results) {
+    out << std::fixed << std::setprecision(1);
+    out << "name,scale,stations,edges,ops,samples,min_ns,mean_ns,p50_ns,p90_ns,p99_ns,max_ns\n";
+    for (const Result& r : results) {
+        const Summary s = summarize(r.ns);
+        out << r.name << ',' << r.scale << ',' << r.stations << ',' << r.edges << ',' << r.ops << ','
+            << r.ns.size() << ',' << s.min << ',' << s.mean << ',' << s.p50 << ',' << s.p90 << ',' << s.p99
+            << ',' << s.max << '\n';
+    }
+}
+
+bool parse_scales(const std::string& text, std::vector<int>& scales) {
+    scales.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const int side = std::atoi(item.c_str());
+        if (side < 2) {
+            return false;
+        }
+        scales.push_back(side);
+    }
+    return !scales.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--scales" && has_value) {
+            if (!parse_scales(argv[++i], options.scales)) {
+                std::cerr << "bench_navigator: --scales expects sides >= 2, e.g. 50,100,200\n";
+                return 2;
+            }
+        } else if (arg == "--samples" && has_value) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--queries" && has_value) {
+            options.queries = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--format" && has_value) {
+            options.format = argv[++i];
+            if (options.format != "json" && options.format != "csv") {
+                std::cerr << "bench_navigator: --format expects json or csv\n";
+                return 2;
+            }
+        } else if (arg == "--out" && has_value) {
+            options.out = argv[++i];
+        } else {
+            std::cerr << "usage: bench_navigator [--scales 50,100,200] [--samples N] [--queries N]"
+                         " [--format json|csv] [--out FILE]\n";
+            return 2;
+        }
+    }
+    options.samples = std::min(options.samples, options.queries - 1); // старты запросов dijkstra_states
+
+    std::vector<Result> results;
+    for (int side : options.scales) {
+        std::cerr << "scale " << side << "x" << side << "...\n";
+        const std::vector<Result> part = run_scale(side, options);
+        results.insert(results.end(), part.begin(), part.end());
+    }
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file) {
+            std::cerr << "bench_navigator: cannot write " << options.out << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.out.empty() ? std::cout : file;
+    if (options.format == "csv") {
+        write_csv(out, results);
+    } else {
+        write_json(out, results);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Перебор k: отдельный Парето-поиск на каждое k против одного поиска для
+// всего списка; для сравнения — Дейкстра, которая на k не смотрит.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "pareto.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 120;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 40;
+    const int k_count = (argc > 3) ? std::atoi(argv[3]) : 8;
+
+    const FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::vector<double> ks;
+    for (int i = 0; i < k_count; ++i) {
+        ks.push_back(0.5 * i);
+    }
+    std::printf("network: %d stations, %d edges; %d queries x %d values of k\n", fg.n, fg.m, queries, k_count);
+
+    unsigned seed = 7u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<Request> requests(static_cast<std::size_t>(queries));
+    for (Request& rq : requests) {
+        rq.start = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(1 + static_cast<int>(next(static_cast<unsigned>(fg.n))));
+        }
+    }
+
+    double dijkstra_metric = 0.0;
+    auto t0 = Clock::now();
+    for (Request rq : requests) {
+        for (double k : ks) {
+            rq.k = k;
+            for (const Route& r : solve_request(fg, model, rq)) {
+                dijkstra_metric += r.metric;
+            }
+        }
+    }
+    const double dijkstra_ms = ms_since(t0);
+
+    double per_k_metric = 0.0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (double k : ks) {
+            const std::vector<std::vector<Route>> answers = solve_request_pareto(fg, model, rq, {k});
+            for (const Route& r : answers[0]) {
+                per_k_metric += r.metric;
+            }
+        }
+    }
+    const double per_k_ms = ms_since(t0);
+
+    double sweep_metric = 0.0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (const std::vector<Route>& routes : solve_request_pareto(fg, model, rq, ks)) {
+            for (const Route& r : routes) {
+                sweep_metric += r.metric;
+            }
+        }
+    }
+    const double sweep_ms = ms_since(t0);
+
+    std::printf("dijkstra per k : %8.2f ms per query (metric sum %.1f)\n", dijkstra_ms / queries, dijkstra_metric);
+    std::printf("pareto per k   : %8.2f ms per query (metric sum %.1f)\n", per_k_ms / queries, per_k_metric);
+    std::printf("pareto, all k  : %8.2f ms per query (metric sum %.1f), %.1fx faster than per k\n",
+                sweep_ms / queries, sweep_metric, per_k_ms / sweep_ms);
+    return per_k_metric == sweep_metric ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Пропускная способность разбора: прежний разбор через std::istream >> против
+// буферного разбора на std::from_chars (parse_all). Вход синтезируется в памяти.
+#include "parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string make_input(int n, int m, int q) {
+    std::string text;
+    text.reserve(static_cast<std::size_t>(m) * 24 + static_cast<std::size_t>(n) * 5);
+    unsigned seed = 2024u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+
+    text += std::to_string(n) + " " + std::to_string(m) + "\n0.2 0.4 0.6\n0 1 2\n1 0 1.5\n2 1.5 0\n";
+    for (int v = 1; v <= n; ++v) {
+        text += "0." + std::to_string(next(10)) + (v % 32 == 0 ? "\n" : " ");
+    }
+    text += "\n";
+    for (int i = 0; i < m; ++i) {
+        const int u = 1 + static_cast<int>(next(static_cast<unsigned>(n)));
+        const int v = 1 + static_cast<int>(next(static_cast<unsigned>(n)));
+        text += std::to_string(u) + " " + std::to_string(v) + " " + std::to_string(next(3)) + " "
+              + std::to_string(1 + next(30)) + "." + std::to_string(next(100)) + " 0."
+              + std::to_string(next(100)) + "\n";
+    }
+    text += std::to_string(q) + "\n";
+    for (int i = 0; i < q; ++i) {
+        text += std::to_string(1 + next(static_cast<unsigned>(n))) + " 2 0.5 "
+              + std::to_string(1 + next(static_cast<unsigned>(n))) + " "
+              + std::to_string(1 + next(static_cast<unsigned>(n))) + "\n";
+    }
+    return text;
+}
+
+// Прежняя реализация parse_all (istream >> и push_back на каждое ребро).
+bool legacy_parse_all(std::istream& in, InputData& data) {
+    int N = 0, M = 0;
+    if (!(in >> N >> M) || N <= 0 || M < 0) return false;
+    graph_init(data.g, N);
+    for (int i = 0; i < 3; ++i) {
+        if (!(in >> data.model.sensitivity[i])) return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (!(in >> data.model.trans[i][j])) return false;
+        }
+    }
+    data.model.station_transfer.assign(static_cast<std::size_t>(N) + 1, 0.0);
+    for (int v = 1; v <= N; ++v) {
+        if (!(in >> data.model.station_transfer[v])) return false;
+    }
+    for (int i = 0; i < M; ++i) {
+        int u = 0, v = 0, mode = 0;
+        double base_time = 0.0, load = 0.0;
+        if (!(in >> u >> v >> mode >> base_time >> load)) return false;
+        graph_add_undirected(data.g, u, v, mode, base_time, load);
+    }
+    int Q = 0;
+    if (!(in >> Q) || Q < 0) return false;
+    data.requests.clear();
+    for (int qi = 0; qi < Q; ++qi) {
+        Request rq;
+        int T = 0;
+        if (!(in >> rq.start >> T >> rq.k)) return false;
+        for (int j = 0; j < T; ++j) {
+            int t = 0;
+            if (!(in >> t)) return false;
+            rq.targets.push_back(t);
+        }
+        data.requests.push_back(rq);
+    }
+    return true;
+}
+
+double mb_per_s(std::size_t bytes, double ms) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0) / (ms / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int n = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    const int m = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+    const int reps = (argc > 3) ? std::atoi(argv[3]) : 3;
+
+    const std::string text = make_input(n, m, n / 10);
+    std::printf("input: %d stations, %d edges, %.1f MiB\n", n, m,
+                static_cast<double>(text.size()) / (1024.0 * 1024.0));
+
+    double legacy_ms = 1e100;
+    double buffer_ms = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        {
+            std::istringstream in(text);
+            InputData data;
+            const auto t0 = Clock::now();
+            if (!legacy_parse_all(in, data)) {
+                std::printf("legacy parse failed\n");
+                return 1;
+            }
+            legacy_ms = std::min(legacy_ms, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+        {
+            InputData data;
+            std::string error;
+            const auto t0 = Clock::now();
+            TextCursor in = make_cursor(text.data(), text.size());
+            if (!parse_all(in, data, error)) {
+                std::printf("parse failed: %s\n", error.c_str());
+                return 1;
+            }
+            buffer_ms = std::min(buffer_ms, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+    }
+
+    std::printf("istream >>:     %8.1f ms  %7.1f MB/s\n", legacy_ms, mb_per_s(text.size(), legacy_ms));
+    std::printf("from_chars:     %8.1f ms  %7.1f MB/s\n", buffer_ms, mb_per_s(text.size(), buffer_ms));
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Очереди поиска: двоичная куча против radix-кучи, точное время против фиксированной точки.
+// Сеть — плотное наложение метро на автобусную решетку (metro_step = 2).
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+struct Variant {
+    const char* name;
+    SearchOptions options;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 20;
+    const double resolution = (argc > 3) ? std::atof(argv[3]) : 0.01;
+
+    const FrozenGraph fg = freeze_graph(make_city(side, 2));
+    ModelParams model{};
+    model.sensitivity = {0.3, 0.6, 0.2};
+    model.trans = {{{0.0, 2.0, 3.0}, {2.0, 0.0, 2.5}, {3.0, 2.5, 0.0}}};
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+
+    // Цели в дальнем углу: поиск проходит почти всю сеть.
+    std::vector<Request> requests;
+    for (int q = 0; q < queries; ++q) {
+        Request rq;
+        rq.start = 1 + (q * 7919) % (side * 8);
+        rq.k = 1.0;
+        rq.targets = {fg.n - (q * 31) % side, fg.n / 2 + (q * 17) % side};
+        requests.push_back(rq);
+    }
+
+    std::printf("network: %d stations, %d edges, %d queries, resolution %g\n", fg.n, fg.m, queries, resolution);
+
+    const Variant variants[] = {
+        {"heap  exact", SearchOptions{QueueKind::BinaryHeap, 0.0}},
+        {"radix exact", SearchOptions{QueueKind::Radix, 0.0}},
+        {"heap  fixed", SearchOptions{QueueKind::BinaryHeap, resolution}},
+        {"radix fixed", SearchOptions{QueueKind::Radix, resolution}},
+    };
+
+    std::vector<std::vector<Route>> reference;
+    double reference_ms = 0.0;
+    for (const Variant& variant : variants) {
+        std::vector<std::vector<Route>> answers;
+        const auto t0 = Clock::now();
+        for (const Request& rq : requests) {
+            answers.push_back(solve_request(fg, model, rq, variant.options));
+        }
+        const double ms = ms_since(t0) / queries;
+        if (reference.empty()) {
+            reference = answers;
+            reference_ms = ms;
+        }
+
+        double max_error = 0.0;
+        for (std::size_t q = 0; q < answers.size(); ++q) {
+            for (std::size_t i = 0; i < answers[q].size(); ++i) {
+                if (answers[q][i].reachable) {
+                    max_error = std::max(max_error, answers[q][i].time - reference[q][i].time);
+                }
+            }
+        }
+        std::printf("%s: %.2f ms per query, speedup %.2fx, max time error %.4f\n",
+                    variant.name, ms, reference_ms / ms, max_error);
+    }
+    return 0;
+}
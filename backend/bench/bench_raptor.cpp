@@ -0,0 +1,174 @@
+// Полный компромисс "время — пересадки" для запроса: поиск по раундам
+// против метода меток и против Дейкстры по состояниям (v, m, j) с числом
+// пересадок j в состоянии — так фронт дает обычная Дейкстра. Для
+// сравнения — Дейкстра по (v, m), которая дает одну точку фронта.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+#include "pareto.hpp"
+#include "raptor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+// Дейкстра по слоям (v, m, j), j <= max_j; сумма фронтов целей.
+double layered_front_sum(const FrozenGraph& g, const ModelParams& model, const Request& rq, int max_j,
+                         std::size_t& points) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const int layers = max_j + 1;
+    auto id = [layers](int v, int m, int j) { return (static_cast<std::size_t>(v) * 4 + m) * layers + j; };
+    std::vector<double> dist((static_cast<std::size_t>(g.n) + 1) * 4 * layers, inf);
+    using Item = std::tuple<double, int, int, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+    dist[id(rq.start, 3, 0)] = 0.0;
+    q.push({0.0, rq.start, 3, 0});
+    while (!q.empty()) {
+        const auto [t, u, a, j] = q.top();
+        q.pop();
+        if (t > dist[id(u, a, j)]) {
+            continue;
+        }
+        for (int b = 0; b < 3; ++b) {
+            const bool change = a != 3 && a != b;
+            const int nj = j + (change ? 1 : 0);
+            if (nj > max_j) {
+                continue;
+            }
+            const double penalty = change ? model.trans[a][b] + model.station_transfer[u] : 0.0;
+            for (int arc = g.mode_begin(u, b); arc < g.mode_end(u, b); ++arc) {
+                const int v = g.to[static_cast<std::size_t>(arc)];
+                const double nt = t + (arc_time(g, arc, b, model.sensitivity) + penalty);
+                if (nt < dist[id(v, b, nj)]) {
+                    dist[id(v, b, nj)] = nt;
+                    q.push({nt, v, b, nj});
+                }
+            }
+        }
+    }
+    double sum = 0.0;
+    for (int t : rq.targets) {
+        double last = inf;
+        for (int j = 0; j < layers; ++j) {
+            double best = inf;
+            for (int m = 0; m < 3; ++m) {
+                best = std::min(best, dist[id(t, m, j)]);
+            }
+            if (best < last) {
+                sum += best + j;
+                last = best;
+                ++points;
+            }
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 120;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 40;
+    const int metro_step = (argc > 3) ? std::atoi(argv[3]) : 8;
+
+    const FrozenGraph fg = freeze_graph(make_city(side, metro_step));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::printf("network: %d stations, %d edges; %d queries\n", fg.n, fg.m, queries);
+
+    unsigned seed = 7u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<Request> requests(static_cast<std::size_t>(queries));
+    for (Request& rq : requests) {
+        rq.start = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(1 + static_cast<int>(next(static_cast<unsigned>(fg.n))));
+        }
+    }
+
+    double dijkstra_sum = 0.0;
+    auto t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (const Route& r : solve_request(fg, model, rq)) {
+            dijkstra_sum += r.time;
+        }
+    }
+    const double dijkstra_ms = ms_since(t0);
+
+    auto front_sum = [](const ParetoResult& result, const Request& rq, std::size_t& points) {
+        double sum = 0.0;
+        for (int t : rq.targets) {
+            for (const ParetoLabel& label : pareto_front(result, t)) {
+                sum += label.time + label.transfers;
+                ++points;
+            }
+        }
+        return sum;
+    };
+
+    double labels_sum = 0.0;
+    std::size_t labels_points = 0;
+    std::size_t labels_count = 0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        const ParetoResult result = pareto_search(fg, model, rq.start, rq.targets);
+        labels_count += result.labels.size();
+        labels_sum += front_sum(result, rq, labels_points);
+    }
+    const double labels_ms = ms_since(t0);
+
+    double rounds_sum = 0.0;
+    std::size_t rounds_points = 0;
+    std::size_t rounds_count = 0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        const ParetoResult result = round_search(fg, model, rq.start, rq.targets);
+        rounds_count += result.labels.size();
+        rounds_sum += front_sum(result, rq, rounds_points);
+    }
+    const double rounds_ms = ms_since(t0);
+
+    // Предел слоев — наибольшее число пересадок во фронтах.
+    int max_j = 0;
+    for (const Request& rq : requests) {
+        const ParetoResult result = round_search(fg, model, rq.start, rq.targets);
+        for (int t : rq.targets) {
+            for (const ParetoLabel& label : pareto_front(result, t)) {
+                max_j = std::max(max_j, label.transfers);
+            }
+        }
+    }
+    double layered_sum = 0.0;
+    std::size_t layered_points = 0;
+    t0 = Clock::now();
+    for (const Request& rq : requests) {
+        layered_sum += layered_front_sum(fg, model, rq, max_j, layered_points);
+    }
+    const double layered_ms = ms_since(t0);
+
+    std::printf("dijkstra (one point)  : %8.2f ms per query (time sum %.1f)\n", dijkstra_ms / queries, dijkstra_sum);
+    std::printf("dijkstra (v, m, j<=%d) : %8.2f ms per query, %zu front points (sum %.1f)\n",
+                max_j, layered_ms / queries, layered_points, layered_sum);
+    std::printf("label-setting fronts  : %8.2f ms per query, %zu labels, %zu front points (sum %.1f)\n",
+                labels_ms / queries, labels_count / queries, labels_points, labels_sum);
+    std::printf("round-based fronts    : %8.2f ms per query, %zu labels, %zu front points (sum %.1f), "
+                "%.1fx faster than label-setting, %.1fx than (v, m, j)\n",
+                rounds_ms / queries, rounds_count / queries, rounds_points, rounds_sum, labels_ms / rounds_ms,
+                layered_ms / rounds_ms);
+    return labels_points == rounds_points ? 0 : 1;
+}
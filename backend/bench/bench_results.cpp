@@ -0,0 +1,93 @@
+// Упакованные результаты поиска: объем и скорость чтения пакета деревьев
+// кратчайших путей в раскладках DijkstraStateResult, PathTree и
+// CompactPathTree (прежние строки по вершинам — 72 байта на станцию).
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+constexpr double kWideBytesPerStation = 72.0;
+
+template <typename Result>
+void run(const char* name, const FrozenGraph& fg, const ModelParams& model, int trees, int passes) {
+    std::vector<Result> results(static_cast<std::size_t>(trees));
+    int failed = 0;
+    auto t0 = Clock::now();
+    for (int i = 0; i < trees; ++i) {
+        const int start = 1 + static_cast<int>((static_cast<long long>(i) * 7919) % fg.n);
+        failed += build_path_tree(fg, model, start, results[static_cast<std::size_t>(i)]) ? 0 : 1;
+    }
+    const double build_ms = ms_since(t0);
+
+    std::size_t bytes = 0;
+    for (const Result& r : results) {
+        bytes += r.memory_bytes();
+    }
+
+    // Проход по всем станциям всех деревьев: лучшее время и пересадки.
+    double checksum = 0.0;
+    t0 = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        for (const Result& r : results) {
+            for (int v = 1; v <= fg.n; ++v) {
+                double best = r.time(v, 0);
+                int tr = r.transfers(v, 0);
+                for (int m = 1; m < 3; ++m) {
+                    if (r.time(v, m) < best) {
+                        best = r.time(v, m);
+                        tr = r.transfers(v, m);
+                    }
+                }
+                checksum += best + tr;
+            }
+        }
+    }
+    const double scan_ms = ms_since(t0) / passes;
+
+    // Восстановление маршрутов до разбросанных целей.
+    const int routes = 64;
+    t0 = Clock::now();
+    for (const Result& r : results) {
+        for (int t = 0; t < routes; ++t) {
+            const int target = 1 + static_cast<int>((static_cast<long long>(t) * 104729 + r.start()) % fg.n);
+            checksum += static_cast<double>(build_route_to_target(r, target, 1.0).steps.size());
+        }
+    }
+    const double route_us = ms_since(t0) * 1000.0 / (static_cast<double>(trees) * routes);
+
+    const double per_station = static_cast<double>(bytes) / trees / (fg.n + 1);
+    std::printf("%-20s %6.1f MB (%4.1f B/station, %4.0f%% of wide), build %.1f ms/tree, "
+                "scan %.2f ms (%.2f GB/s), route %.2f us%s (checksum %.0f)\n",
+                name, static_cast<double>(bytes) / (1 << 20), per_station,
+                100.0 * per_station / kWideBytesPerStation, build_ms / trees, scan_ms,
+                static_cast<double>(bytes) / (scan_ms * 1e6), route_us,
+                failed != 0 ? " (some trees overflowed)" : "", checksum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int trees = (argc > 2) ? std::atoi(argv[2]) : 32;
+    const int passes = (argc > 3) ? std::atoi(argv[3]) : 3;
+
+    const FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::printf("network: %d stations, %d edges; %d trees\n", fg.n, fg.m, trees);
+
+    run<DijkstraStateResult>("DijkstraStateResult", fg, model, trees, passes);
+    run<PathTree>("PathTree", fg, model, trees, passes);
+    run<CompactPathTree>("CompactPathTree", fg, model, trees, passes);
+    return 0;
+}
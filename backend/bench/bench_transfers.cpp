@@ -0,0 +1,85 @@
+// Поиск по состояниям для простых моделей пересадок: без штрафов (поиск по
+// станциям) и с одинаковым штрафом (константа вместо таблиц) против общего
+// поиска с матрицей штрафов. Ответы сравниваются с общим поиском.
+#include "algorithms.hpp"
+#include "bench_city.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace bench;
+
+namespace {
+
+struct Totals {
+    double ms = 0.0;
+    double time_sum = 0.0;
+    long transfers_sum = 0;
+};
+
+Totals run(const FrozenGraph& fg, const ModelParams& model, const std::vector<Request>& requests,
+           const SearchOptions& options) {
+    Totals totals;
+    const Clock::time_point t0 = Clock::now();
+    for (const Request& rq : requests) {
+        for (const Route& route : solve_request(fg, model, rq, options)) {
+            totals.time_sum += route.time;
+            totals.transfers_sum += route.transfers;
+        }
+    }
+    totals.ms = ms_since(t0);
+    return totals;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 100;
+    const int metro_step = (argc > 3) ? std::atoi(argv[3]) : 2;
+
+    const FrozenGraph fg = freeze_graph(make_city(side, metro_step));
+    std::printf("network: %d stations, %d edges; %d queries, 3 targets each\n", fg.n, fg.m, queries);
+
+    ModelParams plain{};
+    plain.sensitivity = {0.3, 1.0, 0.2};
+    plain.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.0);
+    ModelParams uniform = plain;
+    for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+            uniform.trans[a][b] = a == b ? 0.0 : 1.5;
+        }
+    }
+    uniform.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+
+    unsigned seed = 11u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<Request> requests(static_cast<std::size_t>(queries));
+    for (Request& rq : requests) {
+        rq.start = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(1 + static_cast<int>(next(static_cast<unsigned>(fg.n))));
+        }
+    }
+
+    bool same = true;
+    for (const ModelParams* model : {&plain, &uniform}) {
+        SearchOptions general;
+        general.bidirectional = false;
+        SearchOptions special = general;
+        special.transfer_model = classify_transfer_model(*model);
+        const Totals b = run(fg, *model, requests, special);
+        const Totals a = run(fg, *model, requests, general);
+        same = same && a.time_sum == b.time_sum && a.transfers_sum == b.transfers_sum;
+        std::printf("%-8s model, matrix kernel : %8.2f ms per query (time sum %.1f, transfers %ld)\n",
+                    model == &plain ? "plain" : "uniform", a.ms / queries, a.time_sum, a.transfers_sum);
+        std::printf("%-8s model, %-7s kernel: %8.2f ms per query (time sum %.1f, transfers %ld), %.2fx\n",
+                    model == &plain ? "plain" : "uniform", model == &plain ? "plain" : "uniform", b.ms / queries,
+                    b.time_sum, b.transfers_sum, a.ms / b.ms);
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// Материализованные веса дуг: стоимость построения массива, пересчета для
+// новой чувствительности (ядро SSE2 против скалярного цикла по arc_time),
+// пересчета после пакета изменений и запросов с массивом и без него.
+#include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "bench_city.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace bench;
+
+int main(int argc, char** argv) {
+    const int side = (argc > 1) ? std::atoi(argv[1]) : 300;
+    const int queries = (argc > 2) ? std::atoi(argv[2]) : 200;
+    const int rounds = (argc > 3) ? std::atoi(argv[3]) : 20;
+
+    FrozenGraph fg = freeze_graph(make_city(side));
+    ModelParams model{};
+    model.sensitivity = {0.3, 1.0, 0.2};
+    for (auto& row : model.trans) {
+        row = {1.0, 2.0, 3.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(fg.n) + 1, 0.5);
+    std::printf("network: %d stations, %zu arcs; %d queries\n", fg.n, fg.arc_count(), queries);
+
+    // Построение: массив целиком.
+    ArcWeights w;
+    auto t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        w = materialize_arc_weights(fg, model.sensitivity);
+    }
+    const double materialize_ms = ms_since(t0) / rounds;
+
+    // Пересчет для новой чувствительности: ядро по готовому массиву.
+    std::array<double, 3> other = model.sensitivity;
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        other[r % 3] += 0.125;
+        update_arc_weights(w, fg, other, {});
+    }
+    const double kernel_ms = ms_since(t0) / rounds;
+    w = materialize_arc_weights(fg, model.sensitivity);
+
+    // Тот же массив скалярным циклом по срезам (без ядра).
+    std::vector<double> scalar(fg.arc_count());
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int u = 1; u <= fg.n; ++u) {
+            for (int m = 0; m < 3; ++m) {
+                for (int a = fg.mode_begin(u, m); a < fg.mode_end(u, m); ++a) {
+                    scalar[static_cast<std::size_t>(a)] = arc_time(fg, a, m, model.sensitivity);
+                }
+            }
+        }
+    }
+    const double scalar_ms = ms_since(t0) / rounds;
+    if (scalar != w.time) {
+        std::printf("scalar and kernel weights differ\n");
+        return 1;
+    }
+
+    // Пересчет после пакета из 1000 изменений против нового массива.
+    unsigned seed = 7u;
+    auto next = [&seed](unsigned mod) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % mod;
+    };
+    std::vector<EdgeDelta> deltas;
+    for (int i = 0; i < 1000; ++i) {
+        deltas.push_back(EdgeDelta{static_cast<int>(next(static_cast<unsigned>(fg.m))), 2.0 + next(5),
+                                   0.01 * next(100)});
+    }
+    std::string error;
+    double update_ms = 0.0;
+    for (int r = 0; r < rounds; ++r) {
+        if (!frozen_apply_deltas(fg, deltas, error)) {
+            std::printf("%s\n", error.c_str());
+            return 1;
+        }
+        t0 = Clock::now();
+        update_arc_weights(w, fg, model.sensitivity, deltas);
+        update_ms += ms_since(t0);
+    }
+    update_ms /= rounds;
+    if (w.time != materialize_arc_weights(fg, model.sensitivity).time) {
+        std::printf("updated and fresh weights differ\n");
+        return 1;
+    }
+
+    std::vector<Request> requests(static_cast<std::size_t>(queries));
+    for (Request& rq : requests) {
+        rq.start = 1 + static_cast<int>(next(static_cast<unsigned>(fg.n)));
+        for (int t = 0; t < 3; ++t) {
+            rq.targets.push_back(1 + static_cast<int>(next(static_cast<unsigned>(fg.n))));
+        }
+    }
+    auto run = [&](const SearchOptions& options, double& sum) {
+        const Clock::time_point start = Clock::now();
+        for (const Request& rq : requests) {
+            for (const Route& route : solve_request(fg, model, rq, options)) {
+                sum += route.time;
+            }
+        }
+        return ms_since(start);
+    };
+    SearchOptions computed;
+    SearchOptions materialized;
+    materialized.arc_weights = &w;
+    double computed_sum = 0.0;
+    double materialized_sum = 0.0;
+    const double computed_ms = run(computed, computed_sum);
+    const double materialized_ms = run(materialized, materialized_sum);
+
+    std::printf("materialize           : %8.3f ms\n", materialize_ms);
+    std::printf("recompute (kernel)    : %8.3f ms\n", kernel_ms);
+    std::printf("recompute (scalar)    : %8.3f ms, %.2fx\n", scalar_ms, scalar_ms / kernel_ms);
+    std::printf("update, 1000 deltas   : %8.3f ms\n", update_ms);
+    std::printf("queries, arc_time     : %8.3f ms per query (time sum %.1f)\n", computed_ms / queries, computed_sum);
+    std::printf("queries, materialized : %8.3f ms per query (time sum %.1f), %.2fx\n",
+                materialized_ms / queries, materialized_sum, computed_ms / materialized_ms);
+    return computed_sum == materialized_sum ? 0 : 1;
+}
@@ -3,10 +3,14 @@
 
 #include <vector>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 
 #include "models/graph.hpp"
+#include "frozen_graph.hpp"
 #include "parser.hpp"   // ModelParams, Request
+#include "stamped_table.hpp"
 
 // -------------------- DFS: компоненты связности --------------------
 // DFS с цветами, временем открытия/закрытия и деревом предков (CLRS, гл. 22.3).
@@ -14,6 +18,25 @@
 std::vector<std::vector<int>> get_connected_components(const Graph& g, TransportType type);
 std::vector<int> get_isolated_zones(const Graph& g, TransportType type);
 
+// То же на CSR-снимке: срезы Adj_mode[u] обходятся без отдельных списков.
+// threads <= 1 — DFS с явным стеком; threads > 1 — параллельный union-find
+// (component_roots). Результат одинаков: компоненты по убыванию размера,
+// при равном — по наименьшей станции.
+std::vector<std::vector<int>> get_connected_components(const FrozenGraph& g, TransportType type, int threads = 1);
+std::vector<int> get_isolated_zones(const FrozenGraph& g, TransportType type, int threads = 1);
+
+// Метки компонент: label[v] — номер компоненты v в порядке get_connected_components
+// (0 — крупнейшая), label[0] = -1. Это индекс, который хранится в снимке сети.
+std::vector<int> component_labels(const FrozenGraph& g, TransportType type, int threads = 1);
+
+// Корни компонент: root[v] — наименьшая станция компоненты v (root[0] = 0).
+// Afforest: union-find без блокировок, связывание сначала по выборке рёбер,
+// затем по остальным рёбрам вершин вне крупнейшей компоненты; threads потоков.
+std::vector<int> component_roots(const FrozenGraph& g, TransportType type, int threads);
+
+// Обратно из меток в список компонент за O(V) без обхода графа.
+std::vector<std::vector<int>> components_from_labels(ArrayView<int> labels, int n);
+
 
 // -------------------- Маршруты / Дейкстра --------------------
 // Дейкстра для графа состояний (v, last_mode) с неотрицательными весами.
@@ -33,26 +56,194 @@ struct Route {
     std::vector<Step> steps;          // последовательность переходов
 };
 
-// Результат Дейкстры по состояниям (v, last_mode).
-struct DijkstraStateResult {
-    // d_time[v][m], d_tr[v][m] — оценки расстояний/пересадок.
-    std::vector<std::array<double, 3>> dist_time;
-    std::vector<std::array<int, 3>> dist_transfers;
+// Рабочая область поиска: таблицы Дейкстры по состояниям (v, last_mode),
+// переиспользуемые между поисками. Строки вершин лежат в StampedTable
+// (stamped_table.hpp): новый поиск начинается увеличением эпохи за O(1), а
+// строка инициализируется при первом касании.
+// Стоимость поиска пропорциональна исследованной области, а не |V|.
+// Результат последнего поиска читается прямо из области (представление, а
+// не копия) и действителен до следующего поиска в ней. Область не
+// потокобезопасна: у каждого потока своя.
+class SearchWorkspace {
+public:
+    static constexpr int kModes = 4;  // виды 0..2 и kNoMode = 3 (до первой посадки)
+    static constexpr int kNoMode = 3;
+    static constexpr int kUnreachedTransfers = std::numeric_limits<int>::max() / 4;
+
+    // Новый поиск на графе из n станций: O(1); O(V) — при первом вызове,
+    // при смене n и раз в 2^32 поисков (переполнение эпохи).
+    void begin(int n, int start);
+
+    int start() const { return start_; }
+    int size() const { return size_; }
+    // Вершина затронута последним поиском (есть конечная оценка).
+    bool reached(int v) const { return rows_.contains(static_cast<std::size_t>(v)); }
+    // Число вершин, затронутых последним поиском.
+    std::size_t explored() const { return explored_; }
+
+    // Незатронутая вершина читается как строка заполнения (inf, -1).
+    double time(int v, int m) const { return row(v).time[static_cast<std::size_t>(m)]; }
+    int transfers(int v, int m) const { return row(v).transfers[static_cast<std::size_t>(m)]; }
+    int parent_v(int v, int m) const { return row(v).parent_v[static_cast<std::size_t>(m)]; }
+    int parent_mode(int v, int m) const { return row(v).parent_mode[static_cast<std::size_t>(m)]; }
+    // В (v, m) приходят по ребру вида m: вид ребра не хранится.
+    int parent_edge_mode(int v, int m) const { return parent_v(v, m) == -1 ? -1 : m; }
+
+    // Для алгоритма поиска: сделать строку v действительной в текущем поиске
+    // и записать оценку состояния (v, m).
+    void touch(int v) {
+        if (!reached(v)) {
+            rows_.touch(static_cast<std::size_t>(v));
+            ++explored_;
+        }
+    }
+    void set(int v, int m, double time, int transfers, int parent_v, int parent_mode) {
+        Row& r = rows_.touch(static_cast<std::size_t>(v));
+        const std::size_t j = static_cast<std::size_t>(m);
+        r.time[j] = time;
+        r.transfers[j] = transfers;
+        r.parent_v[j] = parent_v;
+        r.parent_mode[j] = static_cast<std::int8_t>(parent_mode);
+    }
+
+    // Метки целей ограниченного поиска: 0 — не цель, 1 — цель, 2 — достигнута.
+    // Поиск снимает свои метки сам.
+    std::vector<char> target_flag;
 
-    // pi_v[v][m], pi_mode[v][m], pi_edge_mode[v][m] — дерево предков.
-    std::vector<std::array<int, 3>> parent_v;
-    std::vector<std::array<int, 3>> parent_mode;
-    std::vector<std::array<int, 3>> parent_edge_mode; // mode ребра, по которому пришли
+private:
+    // Оценки и предки всех видов вершины v.
+    struct Row {
+        std::array<double, kModes> time;
+        std::array<int, kModes> transfers;
+        std::array<int, kModes> parent_v;
+        std::array<std::int8_t, kModes> parent_mode;
+    };
+
+    const Row& row(int v) const { return rows_[static_cast<std::size_t>(v)]; }
+
+    StampedTable<Row> rows_;
+    std::size_t explored_ = 0;
+    int size_ = 0;
+    int start_ = 0;
 };
 
+// Результат Дейкстры по состояниям (v, m), m = 0..2, в упакованном виде:
+// структура массивов по состояниям s = 3*v + m вместо строк по вершинам.
+// Предок хранится одним номером состояния 4*u + m_u (m_u = kNoMode — старт
+// до первой посадки; -1 — предка нет), вид ребра не хранится: в (v, m)
+// приходят по ребру вида m. Time — double или float (время маршрута тогда
+// приближенное, ~1e-7 относительно), Transfers — int, uint16_t или uint8_t;
+// наибольшее значение Transfers означает "не достигнуто".
+// На станцию: 3 * (sizeof(Time) + sizeof(Transfers) + 4) байт.
+template <typename Time, typename Transfers>
+class PackedStateResult {
+public:
+    // Упаковать результат последнего поиска в ws. false — число пересадок
+    // не помещается в Transfers (результат тогда не определен).
+    bool assign(const SearchWorkspace& ws) {
+        const std::size_t states = 3 * static_cast<std::size_t>(ws.size());
+        start_ = ws.start();
+        time_.assign(states, std::numeric_limits<Time>::infinity());
+        transfers_.assign(states, kUnreached);
+        parent_.assign(states, -1);
+        for (int v = 0; v < ws.size(); ++v) {
+            if (!ws.reached(v)) {
+                continue;
+            }
+            for (int m = 0; m < 3; ++m) {
+                const std::size_t s = state(v, m);
+                const int tr = ws.transfers(v, m);
+                if (tr == SearchWorkspace::kUnreachedTransfers) {
+                    continue;
+                }
+                if (tr < 0 || static_cast<long long>(tr) >= static_cast<long long>(kUnreached)) {
+                    return false;
+                }
+                time_[s] = static_cast<Time>(ws.time(v, m));
+                transfers_[s] = static_cast<Transfers>(tr);
+                const int u = ws.parent_v(v, m);
+                parent_[s] = u == -1 ? -1 : 4 * u + ws.parent_mode(v, m);
+            }
+        }
+        return true;
+    }
+
+    int start() const { return start_; }
+    // Число строк (станций 0..n).
+    int size() const { return static_cast<int>(time_.size() / 3); }
+    bool has(int v) const { return v >= 0 && v < size(); }
+
+    double time(int v, int m) const { return static_cast<double>(time_[state(v, m)]); }
+    int transfers(int v, int m) const {
+        const Transfers tr = transfers_[state(v, m)];
+        return tr == kUnreached ? SearchWorkspace::kUnreachedTransfers : static_cast<int>(tr);
+    }
+    // Номер состояния предка 4*u + m_u или -1.
+    std::int32_t parent_state(int v, int m) const { return parent_[state(v, m)]; }
+    int parent_v(int v, int m) const {
+        const std::int32_t p = parent_state(v, m);
+        return p == -1 ? -1 : static_cast<int>(p >> 2);
+    }
+    int parent_mode(int v, int m) const {
+        const std::int32_t p = parent_state(v, m);
+        return p == -1 ? -1 : static_cast<int>(p & 3);
+    }
+    int parent_edge_mode(int v, int m) const { return parent_state(v, m) == -1 ? -1 : m; }
+
+    std::size_t memory_bytes() const {
+        return time_.capacity() * sizeof(Time) + transfers_.capacity() * sizeof(Transfers)
+             + parent_.capacity() * sizeof(std::int32_t);
+    }
+
+private:
+    static constexpr Transfers kUnreached = std::numeric_limits<Transfers>::max();
+
+    static std::size_t state(int v, int m) {
+        return 3 * static_cast<std::size_t>(v) + static_cast<std::size_t>(m);
+    }
+
+    int start_ = 0;
+    std::vector<Time> time_;
+    std::vector<Transfers> transfers_;
+    std::vector<std::int32_t> parent_;
+};
+
+// Полный результат dijkstra_states: точное время и пересадки (48 байт на
+// станцию против 72 у прежних строк по вершинам).
+using DijkstraStateResult = PackedStateResult<double, int>;
+
+// Дерево кратчайших путей для кэша деревьев (path_tree_cache.hpp): точное
+// время и до 65534 пересадок, 42 байта на станцию.
+using PathTree = PackedStateResult<double, std::uint16_t>;
+
+// Сжатое дерево для пакетов и больших кэшей: время в float и до 254
+// пересадок, 27 байт на станцию.
+using CompactPathTree = PackedStateResult<float, std::uint8_t>;
+
 // Запускает Дейкстру от start.
 // Важно: учитывать штрафы пересадки (матрица + локальная пересадка на станции),
 // а первую посадку делать без штрафа.
+// Перегрузка для Graph строит CSR-снимок на каждый вызов; при серии запросов
+// снимок нужно строить один раз (freeze_graph) и передавать его.
 DijkstraStateResult dijkstra_states(
     const Graph& g,
     const ModelParams& model,
     int start
 );
+DijkstraStateResult dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start
+);
+
+// То же в рабочую область ws без выделения памяти и копирования: результат
+// читается из ws (в том числе build_route_to_target ниже).
+void dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    SearchWorkspace& ws
+);
 
 // Восстановить лучший маршрут до target (с выбором лучшего среди last_mode=0..2,
 // при равном времени — меньшие пересадки)
@@ -64,12 +255,165 @@ Route build_route_to_target(
     double k
 );
 
-// Для одного запроса построить маршруты до всех целей
+// Полный проход Дейкстры от start (двоичная куча, точное время) с
+// упаковкой в out. false — пересадки не помещаются в тип out.
+template <typename Time, typename Transfers>
+bool build_path_tree(const FrozenGraph& g, const ModelParams& model, int start,
+                     PackedStateResult<Time, Transfers>& out);
+
+// То же для PathTree; std::overflow_error — больше 65534 пересадок.
+PathTree build_path_tree(const FrozenGraph& g, const ModelParams& model, int start);
+
+// Маршрут до target по упакованному результату; совпадает с маршрутом
+// solve_request (для CompactPathTree — с точностью float по времени).
+template <typename Time, typename Transfers>
+Route build_route_to_target(const PackedStateResult<Time, Transfers>& result, int target, double k);
+
+// Маршрут до target по результату последнего поиска в ws.
+Route build_route_to_target(const SearchWorkspace& ws, int target, double k);
+
+// Очередь приоритетов поиска.
+//   BinaryHeap — двоичная куча с ленивым удалением (эталон);
+//   Radix      — монотонная radix-куча по целочисленному ключу (time, transfers).
+enum class QueueKind {
+    BinaryHeap,
+    Radix
+};
+
+struct ContractionHierarchy; // contraction.hpp
+struct Landmarks;            // landmarks.hpp
+class PathTreeCache;         // path_tree_cache.hpp
+struct ArcWeights;           // arc_weights.hpp
+
+// Модель пересадок ModelParams: от нее зависит, какой вариант поиска по
+// состояниям нужен (шаблон, выбирается при компиляции для каждой модели).
+//   Plain   — все trans[a][b] (a != b) и station_transfer равны нулю: штраф
+//             не считается, доминируемые состояния станции не раскрываются;
+//   Uniform — штраф trans[a][b] + station_transfer[u] одинаков для всех
+//             a != b и всех станций: одна константа вместо таблиц;
+//   Matrix  — общий случай.
+enum class TransferModel {
+    Matrix,
+    Uniform,
+    Plain
+};
+
+// CLASSIFY-TRANSFER-MODEL(model): самая дешевая подходящая модель; O(V).
+TransferModel classify_transfer_model(const ModelParams& model);
+
+struct SearchOptions {
+    QueueKind queue = QueueKind::BinaryHeap;
+
+    // > 0: времена дуг округляются до кратных time_resolution (фиксированная
+    // точка, целые тики). Время найденного маршрута затем пересчитывается
+    // точно; оно превышает оптимальное P* не более чем на
+    // (|P| + |P*|) * time_resolution / 2 (ошибка округления на каждом шаге).
+    // 0: точное время в double.
+    double time_resolution = 0.0;
+
+    // Запрос с одной целью решается двунаправленным поиском
+    // (bidirectional_route). Применяется при точном времени и двоичной куче:
+    // radix-куча и фиксированная точка — явный выбор эталонного поиска.
+    // Выключен по умолчанию: время встречи складывается из двух половин, а
+    // не слева направо, и при равных в последнем знаке путях выбор может
+    // отличаться от Дейкстры.
+    bool bidirectional = false;
+
+    // Не nullptr: запрос решается по иерархии сжатий (построенной для той же
+    // модели), queue и time_resolution не используются.
+    const ContractionHierarchy* hierarchy = nullptr;
+
+    // Не nullptr: запрос решается поиском A* с оценкой по ориентирам
+    // (solve_request_alt); queue и time_resolution не используются.
+    const Landmarks* landmarks = nullptr;
+
+    // Не nullptr (и точное время): маршруты восстанавливаются по дереву
+    // кратчайших путей от start из кэша, при промахе дерево строится.
+    // model_fingerprint — model_fingerprint(model), посчитанный один раз на
+    // пакет; 0 — считать на каждый запрос (O(V)).
+    PathTreeCache* tree_cache = nullptr;
+    std::uint64_t model_fingerprint = 0;
+
+    // true: маршрут с наименьшей метрикой time + k * transfers по
+    // Парето-поиску (pareto.hpp) среди путей не более чем с max_transfers
+    // пересадками; остальные поля не используются.
+    bool pareto = false;
+    int max_transfers = std::numeric_limits<int>::max();
+    // true (вместе с pareto): фронт считается поиском по раундам пересадок
+    // (raptor.hpp) вместо метода меток; ответы те же.
+    bool rounds = false;
+
+    // Не nullptr: Дейкстра и двунаправленный поиск читают времена дуг из
+    // материализованного массива (arc_weights.hpp), если он посчитан для
+    // весов снимка и чувствительности модели; иначе — по формуле arc_time.
+    const ArcWeights* arc_weights = nullptr;
+
+    // Модель пересадок поиска по состояниям: classify_transfer_model(model),
+    // посчитанная один раз на пакет. Matrix верна для любой модели.
+    TransferModel transfer_model = TransferModel::Matrix;
+};
+
+// То же, что dijkstra_states, с остановом, как только окончательны лучшие
+// состояния всех станций targets (поиск solve_request: двоичная куча, точное
+// время); оценки остальных станций в ws не окончательны. Из options берутся
+// arc_weights и transfer_model.
+void dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    SearchWorkspace& ws,
+    const SearchOptions& options = SearchOptions{}
+);
+
+// Для одного запроса построить маршруты до всех целей. Запрос со своим
+// пределом пересадок (rq.max_transfers) без options.pareto решает поиск по
+// раундам.
 std::vector<Route> solve_request(
     const Graph& g,
     const ModelParams& model,
     const Request& rq
 );
+std::vector<Route> solve_request(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const SearchOptions& options = SearchOptions{}
+);
+// С явной рабочей областью для ограниченной Дейкстры (перегрузка выше берет
+// область потока); иерархия, ориентиры и двунаправленный поиск используют
+// свои области.
+std::vector<Route> solve_request(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const SearchOptions& options,
+    SearchWorkspace& ws
+);
+
+// Двунаправленная Дейкстра по графу состояний для одной цели: прямой поиск
+// из (start, kNoMode), обратный — из (target, 0..2) по обращенным переходам.
+// Останов — когда сумма ключей вершин двух очередей превышает лучшую
+// найденную встречу (пара (время, пересадки), порядок лексикографический).
+// Результат совпадает с build_route_to_target (при равных путях шаги могут
+// отличаться). weights — материализованные веса дуг, как в SearchOptions.
+Route bidirectional_route(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    int target,
+    double k,
+    const ArcWeights* weights = nullptr
+);
+
+// Пересчитать time, transfers и metric маршрута по его шагам в точной
+// арифметике (для параллельных рёбер берется самое быстрое).
+void evaluate_route(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    Route& route,
+    double k
+);
 
 
 // -------------------- Быстрая сортировка (своя) --------------------
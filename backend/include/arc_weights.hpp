@@ -0,0 +1,77 @@
+#ifndef ARC_WEIGHTS_HPP
+#define ARC_WEIGHTS_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "frozen_graph.hpp"
+
+/*
+----------------------------------------------------------------------
+МАТЕРИАЛИЗОВАННЫЕ ВЕСА ДУГ
+
+arc_time считает base_time * (1 + load * sensitivity[mode]) при каждой
+релаксации, и каждый запрос повторяет ту же работу для тех же ModelParams.
+ArcWeights хранит эффективные времена всех дуг снимка для одной
+чувствительности в массиве, выровненном с дугами CSR: time[arc]. Поиск
+читает одно число вместо двух массивов и умножений.
+
+Массив считается одним проходом по дугам (ядро SSE2 по две дуги, скалярный
+хвост; на других архитектурах — скалярный цикл). Вид дуги в CSR не хранится
+(он задан срезом строки), поэтому ArcWeights один раз на топологию строит
+mode[arc]. Значения бит в бит равны arc_time: та же формула в том же
+порядке операций, без FMA.
+
+Пересчет при изменениях (update_arc_weights):
+  изменились base_time / load ребер (frozen_apply_deltas) — пересчитываются
+    только дуги этих ребер, O(число изменений);
+  изменилась чувствительность — один проход ядра по массиву (mode[] уже
+    построен, топология не читается);
+  изменилась топология (другое число дуг) — полный пересчет.
+version и sensitivity показывают, для каких весов посчитан массив: чужой
+массив поиск не использует (matches).
+----------------------------------------------------------------------
+*/
+
+struct ArcWeights {
+    std::uint64_t version = 0;             // FrozenGraph::version
+    std::array<double, 3> sensitivity{};
+    std::vector<double> time;              // эффективное время дуги
+    std::vector<std::uint8_t> mode;        // вид дуги (по срезам CSR)
+
+    // Посчитан для этих весов снимка и этой чувствительности.
+    bool matches(const FrozenGraph& g, const std::array<double, 3>& s) const {
+        return version == g.version && sensitivity == s && time.size() == g.arc_count();
+    }
+};
+
+// MATERIALIZE-WEIGHTS(G, sensitivity): O(E).
+ArcWeights materialize_arc_weights(const FrozenGraph& g, const std::array<double, 3>& sensitivity);
+
+// Привести w к весам снимка g (после frozen_apply_deltas с пакетом deltas) и
+// к чувствительности sensitivity; O(|deltas|), если чувствительность та же.
+// deltas — изменения, примененные к g с момента, когда w совпадал с g.
+void update_arc_weights(
+    ArcWeights& w,
+    const FrozenGraph& g,
+    const std::array<double, 3>& sensitivity,
+    const std::vector<EdgeDelta>& deltas
+);
+
+// Вес дуги для поиска: по формуле или из материализованного массива.
+// Поиски параметризуются одним из них (шаблон), обращение одинаковое.
+struct ComputedArcs {
+    const FrozenGraph& g;
+    const std::array<double, 3>& sensitivity;
+
+    double operator()(int arc, int mode) const { return arc_time(g, arc, mode, sensitivity); }
+};
+
+struct MaterializedArcs {
+    const double* time;
+
+    double operator()(int arc, int) const { return time[static_cast<std::size_t>(arc)]; }
+};
+
+#endif // ARC_WEIGHTS_HPP
@@ -0,0 +1,41 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "algorithms.hpp"
+
+// Получатель результатов пакета: вызывается в вызывающем потоке строго
+// в порядке запросов (index = 0, 1, 2, ...).
+using BatchSink = std::function<void(std::size_t index, const std::vector<Route>& routes)>;
+
+// Число рабочих потоков по умолчанию (hardware_concurrency, не меньше 1).
+int default_thread_count();
+
+// Вызвать body(i) для i = 0..count-1: индексы разбираются потоками через
+// общий атомарный счетчик, порядок вызовов не определен. threads <= 1 —
+// последовательно в вызывающем потоке. Первое исключение body прекращает
+// раздачу индексов и передается вызывающему после join.
+void parallel_for(std::size_t count, int threads, const std::function<void(std::size_t)>& body);
+
+// SOLVE-BATCH(G, model, options, requests, threads)
+// Запросы независимы и только читают G и model, поэтому решаются параллельно:
+// потоки разбирают индексы через общий атомарный счетчик, у каждого потока
+// свои рабочие таблицы поиска (thread_local в solve_request). Готовые
+// результаты лежат в кольце окна, которое вызывающий поток отдает в sink по
+// порядку; окно ограничивает память, если вывод отстает от вычислений.
+// threads <= 1 — последовательное выполнение без создания потоков.
+// Исключение потока (например, bad_alloc) или sink прерывает пакет: потоки
+// присоединяются, и первое исключение передается вызывающему.
+void solve_batch(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const SearchOptions& options,
+    const std::vector<Request>& requests,
+    int threads,
+    const BatchSink& sink
+);
+
+#endif // BATCH_HPP
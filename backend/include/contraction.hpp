@@ -0,0 +1,118 @@
+#ifndef CONTRACTION_HPP
+#define CONTRACTION_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+ИЕРАРХИЯ СЖАТИЙ (Contraction Hierarchies, Geisberger и др., 2008)
+НАД ГРАФОМ СОСТОЯНИЙ (v, last_mode)
+
+Узел иерархии — состояние x = 3 * v + mode ("прибыли в v видом mode").
+Дуга u -> v вида b дает три ребра (u, a) -> (v, b), a = 0..2, с весом
+  (w(u, v) + [a != b] * (trans[a][b] + station_transfer[u]),  [a != b]),
+то есть ровно те переходы, что выполняет run_dijkstra_states. Вес — тройка
+(время, пересадки, число рёбер) с точным лексикографическим порядком;
+сложение покомпонентное, поэтому сжатие сохраняет и кратчайшее время, и
+выбор по пересадкам, а из путей равной цены — путь без циклов нулевой
+стоимости (рёбра с base_time = 0).
+
+Предобработка сжимает узлы по возрастанию приоритета (разность рёбер +
+число сжатых соседей, ленивое обновление). Для пары (x, v, y) добавляется
+ярлык x -> y через v, если локальный поиск свидетеля в оставшемся графе не
+нашел путь не дороже. Ярлык хранит средний узел для распаковки.
+
+Запрос из s: начальные состояния — дуги из s (первая посадка без штрафа),
+прямой поиск идет только вверх по рангу. Для каждой цели t — обратный поиск
+вверх от (t, 0..2); лучшая точка встречи дает маршрут, ярлыки
+раскрываются рекурсивно до Step{from, to, mode}. Время маршрута
+пересчитывается вдоль шагов (evaluate_route) в том же порядке сложения, что
+и у Дейкстры, поэтому значения совпадают с build_route_to_target.
+
+Матрица "многие ко многим" (matrix.hpp) использует те же поиски вверх:
+обратные поиски от целей раскладывают стоимости по корзинам узлов
+(build_ch_buckets), прямой поиск от источника собирает из корзин всю
+строку матрицы (ch_bucket_row).
+
+Иерархия строится для конкретных ModelParams (веса зависят от sensitivity
+и штрафов) и должна использоваться только с ними.
+----------------------------------------------------------------------
+*/
+
+// Ребро иерархии: к узлу с большим рангом (или от него — для входящих).
+struct ChArc {
+    int node = 0;      // другой конец ребра (узел состояния)
+    double time = 0.0;
+    int transfers = 0;
+    int middle = -1;   // средний узел ярлыка; -1 — исходное ребро
+    int hops = 1;      // число исходных рёбер
+};
+
+struct ContractionHierarchy {
+    int n = 0; // |V| исходного графа; узлов иерархии 3 * (n + 1)
+
+    std::vector<int> rank;      // порядок сжатия узла
+    // up_out[x] — рёбра x -> y, up_in[x] — рёбра y -> x; в обоих rank[y] > rank[x].
+    std::vector<int> out_offsets;
+    std::vector<ChArc> up_out;
+    std::vector<int> in_offsets;
+    std::vector<ChArc> up_in;
+
+    int shortcuts = 0; // число добавленных ярлыков
+    std::uint64_t version = 0; // FrozenGraph::version, для которого построена
+};
+
+// BUILD-CH(G, model): предобработка иерархии сжатий.
+ContractionHierarchy build_contraction_hierarchy(const FrozenGraph& g, const ModelParams& model);
+
+// Маршруты запроса по иерархии; результат совпадает с solve_request
+// (при равных по (время, пересадки) путях шаги могут отличаться).
+std::vector<Route> solve_request_ch(
+    const ContractionHierarchy& ch,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq
+);
+
+// Запись корзины узла x: стоимость пути в иерархии x -> (targets[target], *)
+// и первый шаг этого пути (предок x в дереве обратного поиска цели).
+struct ChBucketEntry {
+    int target = 0; // номер цели в списке targets
+    double time = 0.0;
+    int transfers = 0;
+    int parent = -1;     // -1 — x сам состояние цели
+    int parent_arc = -1; // индекс ребра в up_in
+    int hops = 0;        // число исходных рёбер до цели
+};
+
+// Корзины узлов иерархии: записи узла x — entries[offsets[x] .. offsets[x + 1]),
+// по возрастанию target.
+struct ChBuckets {
+    std::vector<int> offsets;
+    std::vector<ChBucketEntry> entries;
+};
+
+// Обратный поиск вверх от (t, 0..2) для каждой цели t; некорректные цели
+// записей не дают.
+ChBuckets build_ch_buckets(const ContractionHierarchy& ch, const FrozenGraph& g, const std::vector<int>& targets);
+
+// Строка матрицы для source по корзинам: time[j] и transfers[j] для
+// targets[j] (недостижима — inf и -1; source == targets[j] — 0 и 0).
+// Сумма по иерархии только выбирает путь: его время пересчитывается вдоль
+// исходных шагов, как у solve_request_ch, и ячейка совпадает с маршрутом.
+// Потокобезопасна: таблицы поиска у каждого потока свои.
+void ch_bucket_row(
+    const ContractionHierarchy& ch,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const ChBuckets& buckets,
+    int source,
+    const std::vector<int>& targets,
+    double* time,
+    int* transfers
+);
+
+#endif // CONTRACTION_HPP
@@ -0,0 +1,173 @@
+#ifndef DYNAMIC_CONNECTIVITY_HPP
+#define DYNAMIC_CONNECTIVITY_HPP
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+ДИНАМИЧЕСКАЯ СВЯЗНОСТЬ (Holm, de Lichtenberg, Thorup, 2001)
+
+Рёбра вставляются и удаляются по одному; после каждого изменения известно
+разбиение вершин на компоненты. Каждому ребру назначен уровень l(e) от 0
+до log2 V. F_i — остовный лес из древесных рёбер уровня >= i; F_0 —
+остовный лес всего графа, F_0 ⊇ F_1 ⊇ ... Инвариант: дерево F_i содержит
+не больше V / 2^i вершин.
+
+  INSERT(u, v): если u и v в разных деревьях F_0 — древесное ребро уровня 0,
+                иначе недревесное уровня 0.
+  DELETE(e):    недревесное — просто убрать. Древесное уровня l — разрезать
+                F_0..F_l, затем для i = l..0 в меньшем из двух деревьев F_i
+                поднять древесные рёбра уровня i на i + 1 и перебирать
+                недревесные рёбра уровня i: ребро в другое дерево — замена
+                (связать F_0..F_i, конец), иначе поднять его на i + 1.
+
+Каждое ребро поднимается не больше log2 V раз, поэтому изменение стоит
+O(log^2 V) амортизированно. Деревья F_i хранятся как эйлеровы обходы
+(Euler tour trees) в декартовых деревьях по неявному ключу: узел на вершину
+и по узлу на каждое направление древесного ребра; перекоренение, связывание
+и разрез — O(log V) операций split/merge. Агрегаты поддерева: число
+вершин, наименьшая вершина и флаги "есть вершина с древесными/недревесными
+рёбрами уровня i" — по ним поиск замены спускается прямо к нужной вершине.
+
+Зоны (компоненты F_0) упорядочены как в get_connected_components: по
+убыванию размера, при равном — по наименьшей станции. Компоненты из двух
+и более вершин лежат в упорядоченном множестве, одиночные станции — в
+битовой маске, поэтому запрос зон стоит O(размер ответа), а не O(V + E).
+----------------------------------------------------------------------
+*/
+
+class DynamicConnectivity {
+public:
+    DynamicConnectivity() = default;
+    explicit DynamicConnectivity(int n) { reset(n); }
+
+    // V = n вершин 1..n без рёбер.
+    void reset(int n);
+
+    // id — неотрицательный ключ ребра, уникальный среди присутствующих.
+    // Петли (u == v) принимаются, но на связность не влияют.
+    void insert(int id, int u, int v);
+    // false — ребра id нет.
+    bool erase(int id);
+
+    bool connected(int u, int v) const;
+    int component_count() const;
+    int component_size(int v) const;
+
+    // Компоненты в порядке get_connected_components (вершины по возрастанию).
+    std::vector<std::vector<int>> components() const;
+    // Все вершины вне крупнейшей компоненты, в том же порядке (get_isolated_zones).
+    std::vector<int> isolated() const;
+
+private:
+    static constexpr unsigned char kTreeFlag = 1;    // древесные рёбра уровня i
+    static constexpr unsigned char kNonTreeFlag = 2; // недревесные рёбра уровня i
+
+    struct Node {
+        int left = -1;
+        int right = -1;
+        int parent = -1;
+        std::uint32_t priority = 0;
+        int count = 1;      // узлов в поддереве
+        int vertices = 0;   // узлов-вершин в поддереве
+        int min_vertex = 0; // наименьшая вершина поддерева (INT_MAX — нет)
+        int vertex = -1;    // вершина узла; -1 — узел дуги
+        unsigned char own = 0;
+        unsigned char agg = 0;
+    };
+
+    struct EdgeRecord {
+        int u = 0;
+        int v = 0;
+        int level = 0;
+        bool live = false;
+        bool tree = false;
+        int pos_u = -1; // позиция в списке рёбер u своего уровня и вида
+        int pos_v = -1;
+        std::vector<std::pair<int, int>> arcs; // узлы дуг (u, v), (v, u) в F_0..F_level
+    };
+
+    using IncidentLists = std::unordered_map<int, std::vector<int>>;
+
+    // Декартово дерево эйлерова обхода.
+    int new_node(int vertex);
+    void free_node(int x);
+    void pull(int x);
+    void update_up(int x);
+    int merge(int a, int b);
+    void split(int t, int k, int& a, int& b);
+    int root_of(int x) const;
+    int index_of(int x) const;
+    int reroot(int x);
+    int find_flagged(int root, unsigned char flag) const;
+
+    // Уровни и вершины.
+    void ensure_level(int level);
+    int vertex_node(int level, int x) const;
+    int ensure_vertex_node(int level, int x);
+    void refresh_own(int level, int x);
+    IncidentLists& lists(bool tree, int level);
+    void list_add(int id);
+    void list_remove(int id);
+
+    void link(int level, int id);
+    void cut(int level, int id);
+    bool find_replacement(int level, int id);
+
+    // Зоны F_0.
+    void zone_remove(int root);
+    void zone_add(int root);
+    void collect(int root, std::vector<int>& out) const;
+
+    std::vector<Node> nodes_;
+    std::vector<int> free_;
+    std::uint32_t seed_ = 2463534242u;
+
+    std::vector<int> vertex0_;                               // узлы вершин в F_0
+    std::vector<std::unordered_map<int, int>> vertex_upper_; // F_i, i >= 1: вершина -> узел
+    std::vector<IncidentLists> tree_lists_;                  // по уровням
+    std::vector<IncidentLists> nontree_lists_;
+    std::vector<EdgeRecord> edges_;                          // по id
+
+    std::set<std::pair<int, int>> zones_;   // (-размер, наименьшая вершина), размер >= 2
+    std::vector<std::uint64_t> singletons_; // одиночные вершины
+    int singleton_count_ = 0;
+};
+
+
+// -------------------- Сеть с изменяемыми рёбрами --------------------
+// Graph плюс динамические зоны для metro, bus, rail и all: закрытие и
+// открытие перегона обновляет списки смежности и четыре структуры
+// связности, а не пересчитывает компоненты заново.
+struct DynamicGraph {
+    Graph g;
+    std::array<DynamicConnectivity, 4> zones; // metro, bus, rail, all
+
+    struct EdgeEnds {
+        int u = 0;
+        int v = 0;
+        int mode = -1; // -1 — ребра нет (удалено)
+    };
+    std::vector<EdgeEnds> ends; // по id ребра
+};
+
+// Взять сеть g с ее рёбрами: O(E log V).
+void dynamic_graph_init(DynamicGraph& dg, const Graph& g);
+
+// Открыть перегон; возвращает id нового ребра (исключения — как у graph_add_undirected).
+int dynamic_graph_add(DynamicGraph& dg, int u, int v, int mode, double base_time, double load);
+
+// Закрыть перегон id; false — такого ребра нет.
+bool dynamic_graph_remove(DynamicGraph& dg, int id);
+
+std::vector<std::vector<int>> dynamic_connected_components(const DynamicGraph& dg, TransportType type);
+std::vector<int> dynamic_isolated_zones(const DynamicGraph& dg, TransportType type);
+
+#endif // DYNAMIC_CONNECTIVITY_HPP
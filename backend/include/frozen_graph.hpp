@@ -0,0 +1,136 @@
+// backend/include/frozen_graph.hpp
+#ifndef FROZEN_GRAPH_HPP
+#define FROZEN_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+
+/*
+----------------------------------------------------------------------
+"ЗАМОРОЖЕННОЕ" ПРЕДСТАВЛЕНИЕ ГРАФА (CSR, compressed sparse row)
+
+Graph хранит Adj[u] как отдельный вектор на каждую вершину и дублирует
+топологию в adjacency[3]. Для горячих циклов (Дейкстра, DFS) строится
+снимок только для чтения: все ориентированные рёбра лежат подряд в общих
+массивах, строка вершины u упорядочена по виду транспорта (устойчиво),
+поэтому срез Adj_mode[u] — это непрерывный подотрезок строки Adj[u].
+
+  offsets[3 * u + mode] .. offsets[3 * u + mode + 1] — рёбра (u, v) вида mode;
+  offsets[3 * u]        .. offsets[3 * u + 3]        — вся строка Adj[u].
+
+Вид ребра не хранится: он однозначно задаётся срезом.
+
+Массивы — представления (ArrayView) над общим хранилищем storage: это либо
+векторы, построенные freeze_graph, либо отображенный в память файл снимка
+(snapshot.hpp). Копия FrozenGraph разделяет то же хранилище.
+
+ИЗМЕНЕНИЕ ВЕСОВ БЕЗ ПЕРЕСТРОЙКИ. Топология снимка неизменна, но base_time и
+load ребра можно заменить по его id (поток данных о загрузке). При первом
+изменении массивы весов копируются в собственную память снимка (weights) и
+строится индекс id -> две дуги ребра; дальше каждое изменение — O(1).
+Копии FrozenGraph, сделанные до изменения, видят прежние веса: если weights
+разделены с копией, они копируются заново (copy-on-write). version — номер
+весов, уникальный в процессе: новый при построении, загрузке снимка и
+каждом изменении. По нему видно, что предобработка (иерархия, ориентиры)
+или кэш деревьев поиска относятся к другим весам.
+----------------------------------------------------------------------
+*/
+
+// Непрерывный массив только для чтения, память которого принадлежит другому объекту.
+template <typename T>
+struct ArrayView {
+    const T* ptr = nullptr;
+    std::size_t count = 0;
+
+    ArrayView() = default;
+    ArrayView(const T* p, std::size_t c) : ptr(p), count(c) {}
+    ArrayView(const std::vector<T>& v) : ptr(v.data()), count(v.size()) {}
+
+    const T& operator[](std::size_t i) const { return ptr[i]; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    const T& back() const { return ptr[count - 1]; }
+};
+
+// Собственные веса снимка после изменений и индекс дуг по id ребра.
+struct FrozenWeights {
+    std::vector<double> base_time;
+    std::vector<double> load;
+    std::vector<int> arc_of_edge; // [2 * id], [2 * id + 1] — дуги ребра id; -1 — нет
+};
+
+// Новые base_time и load неориентированного ребра id.
+struct EdgeDelta {
+    int id = 0;
+    double base_time = 0.0;
+    double load = 0.0;
+};
+
+struct FrozenGraph {
+    int n = 0; // |V|
+    int m = 0; // |E| — число неориентированных рёбер
+
+    ArrayView<int> offsets;       // размер 3 * (n + 1) + 1
+    ArrayView<int> to;            // конечная вершина v
+    ArrayView<int> edge_id;       // id неориентированного ребра
+    ArrayView<double> base_time;  // w(u, v) без учета загрузки
+    ArrayView<double> load;       // загрузка [0..1]
+
+    std::shared_ptr<const void> storage; // владелец памяти массивов
+    std::shared_ptr<FrozenWeights> weights; // измененные веса; пусто — веса из storage
+    std::uint64_t version = 0;              // номер весов (next_weights_version)
+
+    int row_begin(int u) const { return offsets[3 * static_cast<std::size_t>(u)]; }
+    int row_end(int u) const { return offsets[3 * static_cast<std::size_t>(u) + 3]; }
+    int mode_begin(int u, int mode) const {
+        return offsets[3 * static_cast<std::size_t>(u) + static_cast<std::size_t>(mode)];
+    }
+    int mode_end(int u, int mode) const {
+        return offsets[3 * static_cast<std::size_t>(u) + static_cast<std::size_t>(mode) + 1];
+    }
+
+    // Число ориентированных рёбер (2 * m).
+    std::size_t arc_count() const { return to.size(); }
+
+    // Объем памяти снимка в байтах (без учета заголовков векторов).
+    std::size_t memory_bytes() const;
+};
+
+// Новый номер весов; номера растут и не повторяются в пределах процесса.
+std::uint64_t next_weights_version();
+
+// FREEZE-GRAPH(G): O(V + E), подсчетом по (u, mode).
+FrozenGraph freeze_graph(const Graph& g);
+
+// FROZEN-UPDATE-EDGE(G, id, base_time, load): новые веса обеих дуг ребра id;
+// O(1), кроме первого изменения (копия весов и индекс — O(E)). Значения
+// проверяются как в graph_update_edge (исключение); false — ребра id нет.
+bool frozen_update_edge(FrozenGraph& g, int id, double base_time, double load);
+
+// Пакет изменений: сначала проверяется весь пакет, при ошибке снимок не
+// меняется и error описывает первое неверное изменение; новый version — один
+// на пакет.
+bool frozen_apply_deltas(FrozenGraph& g, const std::vector<EdgeDelta>& deltas, std::string& error);
+
+// Объем памяти исходного Graph (adj + adjacency[3]) в байтах, для сравнения.
+std::size_t graph_memory_bytes(const Graph& g);
+
+inline bool valid_vertex(const FrozenGraph& g, int v) {
+    return (1 <= v && v <= g.n);
+}
+
+// Вес ребра с учетом загрузки (см. edge_time для Edge).
+inline double arc_time(const FrozenGraph& g, int arc, int mode, const std::array<double, 3>& sensitivity) {
+    const std::size_t i = static_cast<std::size_t>(arc);
+    return g.base_time[i] * (1.0 + g.load[i] * sensitivity[static_cast<std::size_t>(mode)]);
+}
+
+#endif // FROZEN_GRAPH_HPP
@@ -0,0 +1,96 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "graph.hpp"
+#include "parser.hpp" // ModelParams, Request, MatrixRequest
+
+// Распределение нагрузки рёбер.
+enum class LoadProfile {
+    Uniform, // равномерно в [0, load_max]
+    Center,  // к центру города выше, к окраинам ниже
+    Bimodal  // большинство рёбер почти свободны, часть загружена до предела
+};
+
+// Параметры синтетического мегаполиса. Станции города лежат на сетке
+// side x side (side = floor(sqrt(stations - pockets * pocket_size))),
+// нумерация по строкам; изолированные карманы — в конце нумерации.
+struct GeneratorParams {
+    std::uint64_t seed = 1;
+    int stations = 10000;        // общее число станций N
+
+    // Автобусы: рёбра между соседями сетки, каждое с вероятностью bus_density.
+    double bus_density = 0.9;
+
+    // Метро: радиальные линии из центра и кольца вокруг него, станции через
+    // metro_spacing клеток; кольца через ring_spacing клеток радиуса.
+    int metro_radials = 8;
+    int metro_rings = 2;
+    int metro_spacing = 4;
+    int ring_spacing = 0;        // 0 — по размеру города (side / (2 * (rings + 1)))
+
+    // Железная дорога: длинные коридоры через город с остановками через
+    // rail_spacing клеток.
+    int rail_corridors = 3;
+    int rail_spacing = 16;
+
+    LoadProfile load = LoadProfile::Center;
+    double load_max = 1.0;
+
+    // Изолированные карманы: маленькие районы без связи с городом.
+    int pockets = 2;
+    int pocket_size = 5;
+
+    // Смесь запросов (доли нормируются): местные (цели в окрестности
+    // local_radius клеток от старта), через весь город, от узлов метро и
+    // с целью в кармане (маршрута нет).
+    int queries = 100;
+    int max_targets = 3;
+    int local_radius = 8;
+    double mix_local = 0.5;
+    double mix_cross = 0.3;
+    double mix_hub = 0.15;
+    double mix_pocket = 0.05;
+
+    // Запросы матриц "многие ко многим" (блок P) и их размер S x S.
+    int matrices = 0;
+    int matrix_size = 8;
+};
+
+struct GeneratedEdge {
+    int u = 0;
+    int v = 0;
+    int mode = 0;
+    double base_time = 0.0;
+    double load = 0.0;
+};
+
+// Сеть в порядке входного формата: рёбра получают id в порядке edges.
+struct GeneratedNetwork {
+    int n = 0;
+    int side = 0;                // сторона сетки города
+    ModelParams model;
+    std::vector<GeneratedEdge> edges;
+    std::vector<Request> requests;
+    std::vector<MatrixRequest> matrices;
+};
+
+// GENERATE-NETWORK(params)
+// Детерминирована: одинаковые params дают одинаковую сеть на любой платформе
+// (свой генератор splitmix64, без std::*_distribution). Времена и нагрузки
+// округлены до сотых, чтобы текст читался обратно без потерь.
+// Бросает std::invalid_argument при недопустимых параметрах.
+GeneratedNetwork generate_network(const GeneratorParams& params);
+
+// Сеть в Graph (graph_add_undirected по порядку edges).
+Graph generated_graph(const GeneratedNetwork& net);
+
+// Текст в формате parse_all: сеть, блок запросов и (если есть) блок матриц.
+// Только блок запросов и матриц — для --snapshot, где сеть лежит в снимке.
+void write_network_text(std::ostream& out, const GeneratedNetwork& net);
+void write_requests_text(std::ostream& out, const GeneratedNetwork& net);
+
+#endif // GENERATOR_HPP
@@ -4,6 +4,8 @@
 
 #include <vector>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 
 /*
@@ -41,12 +43,24 @@ struct Edge {
     int id;            // идентификатор неориентированного ребра (общий для обеих сторон)
 };
 
+// Положение сторон ребра id в списках смежности: Adj[u][iu] и Adj[v][iv].
+struct EdgeSlot {
+    int u = -1; // -1 — ребра нет (удалено)
+    int iu = -1;
+    int v = -1;
+    int iv = -1;
+};
+
 struct Graph {
     int n; // |V| — число вершин
     int m; // |E| — число неориентированных ребер
+    int next_id = 0; // id следующего ребра; после удалений id не переиспользуются
     std::vector<std::vector<Edge>> adj; // Adj[u], u = 1..n
     std::array<std::vector<std::vector<int>>, 3> adjacency; // Adj_mode[u], u = 1..n
 
+    std::vector<EdgeSlot> slots; // индекс id -> стороны ребра
+    std::uint64_t version = 0;   // растет при каждом изменении рёбер
+
     std::vector<std::vector<int>> getConnectedComponents(TransportType type) const;
     std::vector<int> getIsolatedZones(TransportType type) const;
 };
@@ -62,6 +76,9 @@ inline void graph_init(Graph& g, int n) {
     if (n < 0) throw std::invalid_argument("graph_init: n must be >= 0");
     g.n = n;
     g.m = 0;
+    g.next_id = 0;
+    g.slots.clear();
+    g.version = 0;
     g.adj.assign(static_cast<std::size_t>(n) + 1, std::vector<Edge>{});
     for (auto& by_mode : g.adjacency) {
         by_mode.assign(static_cast<std::size_t>(n) + 1, std::vector<int>{});
@@ -73,8 +90,8 @@ inline bool valid_vertex(const Graph& g, int v) {
     return (1 <= v && v <= g.n);
 }
 
-// GRAPH-ADD-UNDIRECTED(G, u, v, mode, base_time, load)
-inline void graph_add_undirected(Graph& g, int u, int v, int mode, double base_time, double load) {
+// Проверки GRAPH-ADD-UNDIRECTED без вставки (те же исключения и сообщения).
+inline void graph_check_undirected(const Graph& g, int u, int v, int mode, double base_time, double load) {
     if (!valid_vertex(g, u) || !valid_vertex(g, v))
         throw std::out_of_range("graph_add_undirected: vertex out of range");
     if (mode < 0 || mode > 2)
@@ -83,16 +100,96 @@ inline void graph_add_undirected(Graph& g, int u, int v, int mode, double base_t
         throw std::invalid_argument("graph_add_undirected: base_time must be >= 0");
     if (load < 0.0 || load > 1.0)
         throw std::invalid_argument("graph_add_undirected: load must be in [0,1]");
+}
+
+// GRAPH-ADD-UNDIRECTED(G, u, v, mode, base_time, load)
+inline void graph_add_undirected(Graph& g, int u, int v, int mode, double base_time, double load) {
+    graph_check_undirected(g, u, v, mode, base_time, load);
 
-    const int id = g.m++; // новый id неориентированного ребра
+    const int id = g.next_id++; // новый id неориентированного ребра
+    ++g.m;
+    ++g.version;
 
     // добавить обе стороны (u->v и v->u)
+    EdgeSlot slot;
+    slot.u = u;
+    slot.iu = static_cast<int>(g.adj[u].size());
     g.adj[u].push_back(Edge{v, mode, base_time, load, id});
+    slot.v = v;
+    slot.iv = static_cast<int>(g.adj[v].size());
     g.adj[v].push_back(Edge{u, mode, base_time, load, id});
+    g.slots.push_back(slot);
     g.adjacency[static_cast<std::size_t>(mode)][u].push_back(v);
     g.adjacency[static_cast<std::size_t>(mode)][v].push_back(u);
 }
 
+// Удалить сторону Adj[x][i]; стороны правее сдвигаются, их индексы в slots
+// уменьшаются. У петли обе стороны в одной строке и различаются индексом.
+inline void graph_erase_side(Graph& g, int x, int i) {
+    std::vector<Edge>& row = g.adj[x];
+    row.erase(row.begin() + i);
+    for (int j = i; j < static_cast<int>(row.size()); ++j) {
+        EdgeSlot& s = g.slots[static_cast<std::size_t>(row[static_cast<std::size_t>(j)].id)];
+        if (s.u == x && s.iu == j + 1)
+            s.iu = j;
+        else
+            s.iv = j;
+    }
+}
+
+// GRAPH-REMOVE-UNDIRECTED(G, id): удалить обе стороны ребра id за
+// O(deg(u) + deg(v)); порядок остальных рёбер в Adj[u] сохраняется.
+// Возвращает false, если такого ребра нет.
+inline bool graph_remove_undirected(Graph& g, int id) {
+    if (id < 0 || id >= static_cast<int>(g.slots.size()) || g.slots[static_cast<std::size_t>(id)].u < 0)
+        return false;
+
+    const EdgeSlot s = g.slots[static_cast<std::size_t>(id)];
+    const int mode = g.adj[s.u][static_cast<std::size_t>(s.iu)].mode;
+    if (s.u == s.v && s.iu < s.iv) {
+        graph_erase_side(g, s.v, s.iv); // сначала правая сторона петли
+        graph_erase_side(g, s.u, s.iu);
+    } else {
+        graph_erase_side(g, s.u, s.iu);
+        graph_erase_side(g, s.v, s.iv);
+    }
+    g.slots[static_cast<std::size_t>(id)] = EdgeSlot{};
+
+    // В Adj_mode хранятся только концы: убрать одно вхождение.
+    auto erase_value = [](std::vector<int>& row, int value) {
+        for (auto it = row.begin(); it != row.end(); ++it) {
+            if (*it == value) {
+                row.erase(it);
+                return;
+            }
+        }
+    };
+    erase_value(g.adjacency[static_cast<std::size_t>(mode)][s.u], s.v);
+    erase_value(g.adjacency[static_cast<std::size_t>(mode)][s.v], s.u);
+    --g.m;
+    ++g.version;
+    return true;
+}
+
+// GRAPH-UPDATE-EDGE(G, id, base_time, load): новые время и загрузка ребра id
+// в обеих сторонах за O(1) через slots. Возвращает false, если ребра нет.
+inline bool graph_update_edge(Graph& g, int id, double base_time, double load) {
+    if (!std::isfinite(base_time) || base_time < 0.0)
+        throw std::invalid_argument("graph_update_edge: base_time must be finite and >= 0");
+    if (!(load >= 0.0 && load <= 1.0))
+        throw std::invalid_argument("graph_update_edge: load must be in [0,1]");
+    if (id < 0 || id >= static_cast<int>(g.slots.size()) || g.slots[static_cast<std::size_t>(id)].u < 0)
+        return false;
+
+    const EdgeSlot& s = g.slots[static_cast<std::size_t>(id)];
+    Edge& forward = g.adj[s.u][static_cast<std::size_t>(s.iu)];
+    Edge& backward = g.adj[s.v][static_cast<std::size_t>(s.iv)];
+    forward.base_time = backward.base_time = base_time;
+    forward.load = backward.load = load;
+    ++g.version;
+    return true;
+}
+
 /*
 Вес ребра w(u, v) с учетом загрузки:
 time = base_time * (1 + load * sensitivity[mode]).
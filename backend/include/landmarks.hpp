@@ -0,0 +1,61 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+ОРИЕНТИРЫ ДЛЯ A* (ALT: A*, Landmarks, Triangle inequality;
+Goldberg, Harrelson, 2005)
+
+Предобработка выбирает ориентиры L (самые удаленные друг от друга
+станции) и для каждого хранит расстояния d_L(v) в графе станций с весом
+ребра base_time. Это нижняя граница веса ребра при любой модели:
+  w = base_time * (1 + load * sensitivity) + штраф >= base_time,
+так как load, sensitivity и штрафы неотрицательны (validate_model).
+Поэтому ориентиры не зависят от ModelParams и строятся один раз на сеть.
+
+Граф неориентированный, и по неравенству треугольника
+  dist(v, t) >= |d_L(t) - d_L(v)|
+для каждого ориентира; оценка h(v) — максимум по ориентирам, а при
+нескольких целях — минимум по целям. Если v и t в разных компонентах
+(одно из расстояний бесконечно), h(v) = inf: из v цель недостижима.
+
+Оценка допустима (не превышает истинного остатка пути), поэтому A*
+с ключом (время + h(v), пересадки) находит те же маршруты, что Дейкстра.
+----------------------------------------------------------------------
+*/
+
+struct Landmarks {
+    int n = 0;                  // |V| сети
+    std::vector<int> nodes;     // станции-ориентиры
+    // dist[v * nodes.size() + i] = d_{nodes[i]}(v) по base_time; inf — недостижима.
+    std::vector<double> dist;
+    std::uint64_t version = 0;  // FrozenGraph::version, для которого построены
+};
+
+// SELECT-LANDMARKS(G, count): выбор "самый дальний от уже выбранных" и
+// расстояния от каждого ориентира (Дейкстра по станциям).
+Landmarks build_landmarks(const FrozenGraph& g, int count);
+
+// Нижняя граница времени пути v -> t при любых ModelParams.
+double landmark_bound(const Landmarks& lm, int v, int t);
+
+// Маршруты запроса поиском A* с оценкой по ориентирам; результат совпадает
+// с solve_request (при равных по (время, пересадки) путях шаги могут
+// отличаться). settled != nullptr — прибавить число извлеченных из очереди
+// состояний (для сравнения с Дейкстрой: без ориентиров h = 0 и порядок
+// извлечения тот же, что у ограниченного целями поиска).
+std::vector<Route> solve_request_alt(
+    const Landmarks& lm,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    std::size_t* settled = nullptr
+);
+
+#endif // LANDMARKS_HPP
@@ -0,0 +1,73 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+МАТРИЦА ВРЕМЕН "МНОГИЕ КО МНОГИМ"
+
+Запрос планирования: списки станций sources (S) и targets (T), ответ —
+время и число пересадок лучшего маршрута для каждой пары, матрица S x T
+без самих маршрутов.
+
+С иерархией сжатий (SearchOptions::hierarchy той же версии сети) — схема
+корзин (Knopp и др., 2007): обратный поиск вверх от каждой цели j
+выполняется один раз и оставляет в каждом достигнутом узле x запись
+(j, d_j(x)) — "корзину". Прямой поиск вверх от источника s для каждого
+достигнутого узла x просматривает его корзину: f_s(x) + d_j(x) — кандидат
+в ответ (s, j). Кратчайший путь в иерархии поднимается и затем опускается,
+поэтому встречается в своей вершине, и минимум по узлам равен ответу.
+Вместо S * T двунаправленных поисков — S + T поисков вверх и просмотр
+корзин. Лучший путь ячейки раскрывается, и время пересчитывается вдоль
+шагов, как в solve_request_ch.
+
+Без иерархии — ограниченная целями Дейкстра от каждого источника в
+рабочей области потока; маршруты не восстанавливаются, значения те же,
+что у solve_request.
+
+Источники независимы и при threads > 1 считаются параллельно.
+----------------------------------------------------------------------
+*/
+
+struct TravelMatrix {
+    std::vector<int> sources;
+    std::vector<int> targets;
+    // Ячейка (i, j) — sources[i] -> targets[j], индекс i * T + j.
+    // Недостижимая пара: time = inf, transfers = -1.
+    std::vector<double> time;
+    std::vector<int> transfers;
+
+    std::size_t index(std::size_t i, std::size_t j) const { return i * targets.size() + j; }
+};
+
+// TRAVEL-TIME-MATRIX(G, model, sources, targets). Из options используются
+// hierarchy (если построена для текущей версии сети), а для строк по
+// Дейкстре — arc_weights и transfer_model.
+TravelMatrix travel_time_matrix(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const std::vector<int>& sources,
+    const std::vector<int>& targets,
+    const SearchOptions& options = SearchOptions{},
+    int threads = 1
+);
+
+// -------------------- Бинарный файл матриц --------------------
+// Порядок байтов хоста, проверяется маркером:
+//   char magic[8] = "RNAVMTRX", uint32 version, uint32 endian = 0x01020304,
+//   uint32 count — число матриц; затем для каждой матрицы:
+//   uint32 S, uint32 T, int32 sources[S], int32 targets[T],
+//   float64 time[S * T], int32 transfers[S * T] (по строкам источников).
+
+constexpr std::uint32_t kMatrixFileVersion = 1;
+
+bool write_matrix_file(const std::string& path, const std::vector<TravelMatrix>& matrices, std::string& error);
+bool read_matrix_file(const std::string& path, std::vector<TravelMatrix>& matrices, std::string& error);
+
+#endif // MATRIX_HPP
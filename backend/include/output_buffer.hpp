@@ -0,0 +1,104 @@
+#ifndef OUTPUT_BUFFER_HPP
+#define OUTPUT_BUFFER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/*
+----------------------------------------------------------------------
+БУФЕР ВЫВОДА
+
+Текст копится в заранее выделенной строке и уходит в поток блоками не
+меньше capacity байт: на большой пакет — несколько крупных write вместо
+operator<< на каждое поле. Числа пишутся std::to_chars прямо в буфер, без
+локали, флагов потока и временных строк. Без потока (sink == nullptr)
+буфер просто накапливает текст (тело ответа сервиса).
+----------------------------------------------------------------------
+*/
+
+class OutputBuffer {
+public:
+    static constexpr std::size_t kDefaultCapacity = 1 << 16;
+
+    explicit OutputBuffer(std::ostream* sink = nullptr, std::size_t capacity = kDefaultCapacity)
+        : sink_(sink), capacity_(capacity) {
+        buf_.reserve(capacity_ + kSlack);
+    }
+
+    ~OutputBuffer() {
+        flush();
+    }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void append(std::string_view s) {
+        buf_.append(s.data(), s.size());
+        maybe_flush();
+    }
+
+    void put(char c) {
+        buf_.push_back(c);
+        maybe_flush();
+    }
+
+    void put_int(long long x) {
+        char tmp[24];
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), x);
+        buf_.append(tmp, res.ptr);
+        maybe_flush();
+    }
+
+    // Кратчайшая запись, которая читается обратно тем же double.
+    void put_double(double x) {
+        char tmp[32];
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), x);
+        buf_.append(tmp, res.ptr);
+        maybe_flush();
+    }
+
+    // Фиксированная точка, precision знаков после нее (как std::fixed).
+    void put_fixed(double x, int precision) {
+        char tmp[352]; // 1e308 с запасом на знаки после точки
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), x, std::chars_format::fixed, precision);
+        buf_.append(tmp, res.ptr);
+        maybe_flush();
+    }
+
+    // Отдать накопленное в поток; без потока — ничего.
+    void flush() {
+        if (sink_ != nullptr && !buf_.empty()) {
+            sink_->write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+            buf_.clear();
+        }
+    }
+
+    // Накопленный текст (без потока — весь вывод).
+    const std::string& str() const {
+        return buf_;
+    }
+
+    std::string take() {
+        std::string out;
+        out.swap(buf_);
+        return out;
+    }
+
+private:
+    static constexpr std::size_t kSlack = 64;
+
+    void maybe_flush() {
+        if (sink_ != nullptr && buf_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    std::ostream* sink_;
+    std::size_t capacity_;
+    std::string buf_;
+};
+
+#endif // OUTPUT_BUFFER_HPP
@@ -0,0 +1,91 @@
+#ifndef PARETO_HPP
+#define PARETO_HPP
+
+#include <limits>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+ПАРЕТО-ПОИСК ПО (ВРЕМЯ, ПЕРЕСАДКИ)
+
+Дейкстра упорядочивает пути по (время, пересадки) лексикографически, а k
+применяется уже к найденному пути: маршрут с наименьшей метрикой
+time + k * transfers может остаться ненайденным (чуть медленнее, но без
+пересадки). Для любого k >= 0 лучший по метрике путь лежит на
+Парето-фронте пар (время, пересадки), поэтому один поиск фронта отвечает
+на все k сразу.
+
+Метки (v, m, время, пересадки) извлекаются из очереди в порядке
+(время, пересадки) (label-setting, Martins, 1984). Извлеченная метка
+доминирована, если у состояния (v, m) уже есть метка с не большим числом
+пересадок: ее время не больше, так как она извлечена раньше. Поэтому для
+состояния достаточно хранить наименьшее число пересадок среди его меток,
+а фронт состояния — не больше max_transfers + 1 меток. Префикс
+недоминированного пути недоминирован (стоимость шага зависит только от
+состояния), так что фронт полон.
+
+Останов при заданных целях: цель закрыта, когда у нее есть метка без
+пересадок (лучше нее ничего нет) или, для конечного списка k, когда
+время извлекаемой метки строго больше лучшей метрики цели при каждом k
+(метрика любой следующей метки не меньше ее времени).
+----------------------------------------------------------------------
+*/
+
+struct ParetoLabel {
+    double time = 0.0;
+    int transfers = 0;
+    int v = 0;
+    int mode = 0;       // вид последнего ребра 0..2; 3 — start до первой посадки
+    int parent = -1;    // метка-предок в ParetoResult::labels
+    int next = -1;      // следующая метка той же станции (список фронта)
+};
+
+struct ParetoResult {
+    int start = 0;
+    std::vector<ParetoLabel> labels; // недоминированные метки в порядке извлечения
+    std::vector<int> head;           // head[v] — последняя метка станции v, -1 — нет
+};
+
+struct ParetoOptions {
+    // Пути с большим числом пересадок не рассматриваются.
+    int max_transfers = std::numeric_limits<int>::max();
+    // Непустой: поиск останавливается, как только ответы для этих k
+    // окончательны (см. выше); пустой — фронты целей полностью.
+    std::vector<double> ks;
+};
+
+// PARETO-SEARCH(G, s): фронты (время, пересадки) целей targets; пустой
+// список целей — полный проход (фронты всех станций).
+ParetoResult pareto_search(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    const ParetoOptions& options = ParetoOptions{}
+);
+
+// Парето-фронт станции target по всем видам: время по возрастанию,
+// пересадки по убыванию.
+std::vector<ParetoLabel> pareto_front(const ParetoResult& result, int target);
+
+// Маршрут до target с наименьшей метрикой time + k * transfers (при равной —
+// меньшее время, затем меньше пересадок).
+Route pareto_route(const ParetoResult& result, int target, double k);
+
+// Маршруты запроса для каждого k из ks по готовым фронтам: routes[i] —
+// ответ для ks[i], отсортированный как у solve_request (rq.k не используется).
+std::vector<std::vector<Route>> pareto_answers(const ParetoResult& result, const Request& rq, const std::vector<double>& ks);
+
+// Маршруты запроса для каждого k из ks одним поиском (pareto_answers);
+// предел пересадок — меньший из max_transfers и rq.max_transfers.
+std::vector<std::vector<Route>> solve_request_pareto(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const std::vector<double>& ks,
+    int max_transfers = std::numeric_limits<int>::max()
+);
+
+#endif // PARETO_HPP
@@ -3,9 +3,12 @@
 
 #include <vector>
 #include <array>
+#include <cstddef>
 #include <string>
 #include <istream>
+#include <limits>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 
 struct ModelParams {
@@ -18,16 +21,78 @@ struct Request {
     int start = 0;
     std::vector<int> targets;
     double k = 0.0; // "цена" пересадки для метрики удобства
+    // Предел пересадок запроса: необязательное "max R" после целей,
+    // "start T k t1 .. tT [max R]". Действует вместе с общим пределом
+    // SearchOptions::max_transfers (берется меньший); запрос с пределом
+    // решается поиском по раундам (raptor.hpp).
+    int max_transfers = std::numeric_limits<int>::max();
+};
+
+// Запрос матрицы "многие ко многим" (matrix.hpp): время и пересадки от
+// каждой станции sources до каждой станции targets.
+struct MatrixRequest {
+    std::vector<int> sources;
+    std::vector<int> targets;
 };
 
 struct InputData {
     Graph g;
     ModelParams model;
     std::vector<Request> requests;
+    std::vector<MatrixRequest> matrices; // необязательный блок после запросов
+};
+
+// Позиция во входном тексте (1-based); offset — смещение в байтах.
+struct ParseLocation {
+    std::size_t offset = 0;
+    std::size_t line = 0;
+    std::size_t column = 0;
+};
+
+// Курсор по тексту в памяти. token — начало последнего прочитанного (или
+// не прочитанного из-за ошибки) токена: по нему строится позиция ошибки.
+struct TextCursor {
+    const char* begin = nullptr;
+    const char* cur = nullptr;
+    const char* end = nullptr;
+    const char* token = nullptr;
 };
 
+TextCursor make_cursor(const char* data, std::size_t size);
+ParseLocation locate(const char* text, std::size_t offset);
+
 // PARSE-ALL(in, data)
 // Возвращает true при успехе; false если не удалось прочитать (или формат не совпал).
-bool parse_all(std::istream& in, InputData& data, std::string& error);
+// При ошибке where (если задан) получает строку и столбец токена, на котором
+// разбор остановился; текст error от позиции не зависит.
+// Перегрузки для std::istream читают поток до конца в буфер и разбирают его.
+bool parse_all(std::istream& in, InputData& data, std::string& error, ParseLocation* where = nullptr);
+bool parse_all(TextCursor& in, InputData& data, std::string& error);
+
+// То же по частям: сеть (N M, модель, рёбра) и блок запросов (Q и запросы).
+// parse_all = parse_network + parse_requests + parse_matrix_requests;
+// сообщения об ошибках те же. Версии с курсором продолжают с места, где
+// остановилась предыдущая часть. Перегрузка parse_requests для потока с
+// matrices != nullptr читает и блок матриц.
+bool parse_network(std::istream& in, InputData& data, std::string& error, ParseLocation* where = nullptr);
+bool parse_requests(std::istream& in, int N, std::vector<Request>& requests, std::string& error, ParseLocation* where = nullptr,
+                    std::vector<MatrixRequest>* matrices = nullptr);
+bool parse_network(TextCursor& in, InputData& data, std::string& error);
+bool parse_requests(TextCursor& in, int N, std::vector<Request>& requests, std::string& error);
+
+// Необязательный блок матриц после запросов: "matrix P", затем P строк
+// "S s1 .. sS T t1 .. tT". Без слова matrix блока нет (P = 0), остаток
+// входа не читается.
+// Проверяется формат; номера станций проверяет validate_matrix_requests.
+bool parse_matrix_requests(TextCursor& in, std::vector<MatrixRequest>& matrices, std::string& error);
+
+// Файл изменений весов (поток загрузки): D, затем D строк "id base_time load".
+// Проверяется только формат; id и значения проверяет frozen_apply_deltas.
+bool parse_deltas(std::istream& in, std::vector<EdgeDelta>& deltas, std::string& error, ParseLocation* where = nullptr);
+bool parse_deltas(TextCursor& in, std::vector<EdgeDelta>& deltas, std::string& error);
+
+// Список цен пересадки для перебора k (/api/sweep): K, затем K чисел.
+// Проверяется только формат.
+bool parse_k_values(TextCursor& in, std::vector<double>& ks, std::string& error);
 
 #endif // PARSER_HPP
@@ -0,0 +1,44 @@
+#ifndef PATH_COST_HPP
+#define PATH_COST_HPP
+
+#include <cmath>
+#include <limits>
+
+/*
+----------------------------------------------------------------------
+СТОИМОСТЬ ПУТИ В ГРАФЕ СОСТОЯНИЙ: пара (время, пересадки)
+
+Порядок лексикографический, сложение покомпонентное; пара ведет себя как
+неотрицательный вес, поэтому поиски, которые складывают части пути не
+слева направо (двунаправленный поиск, ярлыки иерархии), остаются верными.
+
+Сравнение точное, как is_better в run_dijkstra_states: допуск по времени
+не транзитивен (очередь с ним — не строгий слабый порядок) и решал бы
+вместо числа пересадок на равных по смыслу суммах (0.1 + 0.2 и 0.3).
+Сумма в double зависит от порядка сложения, поэтому время найденного
+маршрута пересчитывается слева направо (evaluate_route) — так же, как его
+складывает Дейкстра.
+----------------------------------------------------------------------
+*/
+
+// Относительный запас для оценок снизу, посчитанных в double (ориентиры ALT).
+constexpr double kTimeEpsilon = 1e-9;
+
+struct PathCost {
+    double time = std::numeric_limits<double>::infinity();
+    int transfers = std::numeric_limits<int>::max() / 4;
+};
+
+inline bool path_cost_less(const PathCost& a, const PathCost& b) {
+    return (a.time < b.time) || (a.time == b.time && a.transfers < b.transfers);
+}
+
+inline PathCost path_cost_add(const PathCost& a, double time, int transfers) {
+    return PathCost{a.time + time, a.transfers + transfers};
+}
+
+inline bool reachable(const PathCost& c) {
+    return std::isfinite(c.time);
+}
+
+#endif // PATH_COST_HPP
@@ -0,0 +1,95 @@
+#ifndef PATH_TREE_CACHE_HPP
+#define PATH_TREE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "algorithms.hpp"
+
+/*
+----------------------------------------------------------------------
+КЭШ ДЕРЕВЬЕВ КРАТЧАЙШИХ ПУТЕЙ
+
+Запросы сильно скошены к нескольким узловым станциям отправления. Для
+такой станции полное дерево кратчайших путей (build_path_tree) строится
+один раз, а повторные запросы из нее отвечаются восстановлением маршрутов
+по дереву (build_route_to_target) без поиска.
+
+Ключ — (start, отпечаток модели, номер весов графа). Номер весов
+FrozenGraph::version уникален в процессе и меняется при каждом изменении
+рёбер, поэтому дерево для прежних весов не совпадет с новым ключом. Номера
+растут: первое обращение с более новым номером удаляет все деревья старых
+весов (invalidations), а деревья, построенные для старых весов после
+этого, отдаются запросу, но в кэш не кладутся.
+
+Вытеснение — LRU по суммарному объему деревьев (limit_bytes); дерево
+больше предела не кэшируется. Деревья отдаются как shared_ptr: вытесненное
+дерево живет, пока им пользуется запрос. Операции над кэшем — под
+мьютексом, дерево при промахе строится вне его, поэтому два потока могут
+построить одно дерево одновременно (в кэше останется одно).
+----------------------------------------------------------------------
+*/
+
+struct PathTreeCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;     // вытеснены по пределу объема
+    std::uint64_t invalidations = 0; // удалены после изменения весов
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+};
+
+// Отпечаток модели: хэш всех параметров (sensitivity, trans,
+// station_transfer) по битам значений, O(V). Никогда не равен 0.
+std::uint64_t model_fingerprint(const ModelParams& model);
+
+class PathTreeCache {
+public:
+    explicit PathTreeCache(std::size_t limit_bytes) : limit_bytes_(limit_bytes) {}
+
+    // Дерево от start для графа g и модели model с отпечатком fingerprint:
+    // из кэша или построенное заново; nullptr — пересадки дерева не
+    // помещаются в PathTree (запрос тогда решается поиском).
+    std::shared_ptr<const PathTree> get(const FrozenGraph& g, const ModelParams& model,
+                                        std::uint64_t fingerprint, int start);
+
+    void clear();
+    PathTreeCacheStats stats() const;
+    std::size_t limit_bytes() const { return limit_bytes_; }
+
+private:
+    struct Key {
+        int start = 0;
+        std::uint64_t fingerprint = 0;
+        std::uint64_t version = 0;
+
+        bool operator==(const Key& other) const {
+            return start == other.start && fingerprint == other.fingerprint && version == other.version;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return static_cast<std::size_t>(key.fingerprint ^ (key.version * 0x9e3779b97f4a7c15ull)
+                                            ^ static_cast<std::uint64_t>(key.start));
+        }
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<const PathTree>>;
+
+    void invalidate_before(std::uint64_t version);
+    void evict_oldest();
+
+    mutable std::mutex mutex_;
+    std::size_t limit_bytes_ = 0;
+    std::uint64_t newest_version_ = 0;
+    std::list<Entry> lru_; // в начале — недавно использованные
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    PathTreeCacheStats stats_;
+};
+
+#endif // PATH_TREE_CACHE_HPP
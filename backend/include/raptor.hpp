@@ -0,0 +1,63 @@
+#ifndef RAPTOR_HPP
+#define RAPTOR_HPP
+
+#include <limits>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "pareto.hpp"
+
+/*
+----------------------------------------------------------------------
+ПОИСК ПО РАУНДАМ ПЕРЕСАДОК (по схеме RAPTOR, Delling и др., 2012)
+
+Раунд r дает лучшие времена состояний (v, m) среди путей не более чем с r
+пересадками. Роль линий RAPTOR играют подсети одного вида транспорта:
+внутри раунда путь едет только по рёбрам своего вида, поэтому раунд — это
+Дейкстра по вершинам (v, m) без межвидовых переходов, а пересадка —
+только переход между раундами:
+  раунд 0:  дуги из start (первая посадка без штрафа), затем езда тем же видом;
+  раунд r:  из меток, появившихся в раунде r - 1 в (u, a), — пересадка на
+            вид b != a (штраф trans[a][b] + station_transfer[u]) и дуга u -> v
+            вида b, затем езда видом b.
+Метка раунда r в (v, m) принимается, только если она строго быстрее всех
+меток (v, m) прежних раундов: иначе ее доминирует метка с меньшим числом
+пересадок. Поэтому метки состояния образуют его Парето-фронт, и результат
+совпадает с pareto_search (формат тот же — ParetoResult, фронты и маршруты
+читают pareto_front и pareto_route).
+
+Отличие от Дейкстры по состояниям и от метода меток — в работе раунда: при
+длинных участках одного вида раунд проходит их как обычная Дейкстра по
+вершинам вида, не порождая на каждой станции пересадочных состояний, а в
+следующий раунд переходят только новые метки (отметка RAPTOR).
+
+Останов: раунд не дал новых меток или r > max_transfers. При заданных
+целях метка отбрасывается, если ее время не меньше наибольшего из лучших
+времен целей (отсечение по целям RAPTOR): любой путь через нее к любой
+цели не быстрее уже найденного и не меньше по пересадкам.
+----------------------------------------------------------------------
+*/
+
+// ROUND-SEARCH(G, s): фронты (время, пересадки) целей targets (пустой
+// список — всех станций) среди путей не более чем с max_transfers
+// пересадками.
+ParetoResult round_search(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    int max_transfers = std::numeric_limits<int>::max()
+);
+
+// Маршруты запроса для каждого k из ks по одному поиску по раундам; то же,
+// что solve_request_pareto (предел пересадок — меньший из max_transfers и
+// rq.max_transfers).
+std::vector<std::vector<Route>> solve_request_rounds(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const std::vector<double>& ks,
+    int max_transfers = std::numeric_limits<int>::max()
+);
+
+#endif // RAPTOR_HPP
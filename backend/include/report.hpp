@@ -0,0 +1,69 @@
+#ifndef REPORT_HPP
+#define REPORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "matrix.hpp"
+#include "output_buffer.hpp"
+
+// Формат вывода CLI и сервиса (--format, ?format=).
+enum class ReportFormat {
+    Text,
+    Json
+};
+
+// -------------------- Текстовый отчет --------------------
+// Общий для CLI (stdout) и сервиса (тело ответа) формат вывода.
+// Формат чисел (std::fixed, 2 знака) выставляется на поток при первом
+// напечатанном маршруте и сохраняется дальше, как в исходном выводе.
+
+const char* mode_label(int mode);
+
+// "1-[metro]->2 2-[bus]->3", "unreachable" или start для пустого пути.
+std::string format_path(const Route& route, int start);
+
+void print_route_formatted(std::ostream& out, const Route& route, int start);
+
+// Изолированные зоны (все компоненты, кроме крупнейшей) для одного вида.
+// threads — потоки поиска компонент (get_connected_components).
+void print_isolated_zones(std::ostream& out, const FrozenGraph& g, TransportType type, const std::string& label, int threads = 1);
+
+// Блоки ISOLATED ZONES для metro, bus, rail и all.
+void print_zones_report(std::ostream& out, const FrozenGraph& g, int threads = 1);
+
+// То же по готовым меткам компонент (component_labels) в порядке metro, bus, rail, all.
+void print_zones_report(std::ostream& out, const std::array<ArrayView<int>, 4>& labels, int n);
+
+// Блок REQUEST i; total — число запросов в выводе (для разделителя).
+void print_request(std::ostream& out, std::size_t index, const Request& rq, const std::vector<Route>& routes, std::size_t total);
+
+// Блок MATRIX i: заголовок с размерами и, при cells, строка на каждую пару
+// "From: s | To: t | Time: ... | Transfers: ..." по строкам источников.
+// Пустая строка-разделитель перед блоком — забота вызывающего.
+void print_matrix(std::ostream& out, std::size_t index, const TravelMatrix& matrix, bool cells);
+
+// -------------------- JSON-отчет --------------------
+// Документ CLI: {"zones":{...},"requests":[...],"matrices":[...]}.
+// Функции ниже пишут по одному значению; запятые между элементами и
+// скобки документа ставит вызывающий. Числа — кратчайшая запись, которая
+// читается обратно тем же double; недостижимое — null.
+
+// {"metro":[...],"bus":[...],"rail":[...],"all":[...]}: изолированные зоны
+// (все компоненты, кроме крупнейшей) по убыванию размера, зона — массив станций.
+void write_zones_json(OutputBuffer& out, const FrozenGraph& g, int threads = 1);
+void write_zones_json(OutputBuffer& out, const std::array<ArrayView<int>, 4>& labels, int n);
+
+// {"start","k","routes":[{"target","reachable","time","transfers","metric",
+// "steps":[{"from","to","mode"}]}]}; mode — "metro", "bus" или "rail".
+void write_request_json(OutputBuffer& out, const Request& rq, const std::vector<Route>& routes);
+
+// {"sources","targets","time","transfers"}: ячейки по строкам источников,
+// массив на источник. При cells == false — только sources и targets.
+void write_matrix_json(OutputBuffer& out, const TravelMatrix& matrix, bool cells);
+
+#endif // REPORT_HPP
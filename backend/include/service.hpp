@@ -0,0 +1,82 @@
+#ifndef SERVICE_HPP
+#define SERVICE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/*
+----------------------------------------------------------------------
+РЕЗИДЕНТНЫЙ СЕРВИС
+
+Процесс загружает сеть один раз (разбор, проверка, CSR-снимок, отчет по
+изолированным зонам) и отвечает на запросы по HTTP/1.1 с keep-alive.
+Соединения обслуживает пул из max_connections потоков; следующие ждут
+свободного потока в очереди listen.
+Тела ответов — JSON того же вида, что отдает server.py:
+  {"ok", "exit_code", "stdout", "stderr", "duration_ms", "duration_us"}.
+
+  POST /api/run      полный вход, как в stdin CLI. Если начало тела
+                     совпадает с текстом загруженной сети, сеть не
+                     разбирается заново — разбирается только блок запросов.
+  POST /api/network  загрузить сеть (блок запросов, если есть, игнорируется).
+  POST /api/route    блок запросов "Q, затем Q запросов" к загруженной сети
+                     (и необязательный блок матриц, как в /api/run).
+  POST /api/sweep    "K k1 ... kK" и блок запросов: лучшие по метрике маршруты
+                     для каждого k, один Парето-поиск на запрос.
+  POST /api/deltas   новые веса рёбер загруженной сети (файл изменений).
+  GET  /api/zones    отчет ISOLATED ZONES загруженной сети.
+  GET  /api/cache    счетчики кэша деревьев кратчайших путей.
+  GET  /api/health   состояние сервиса.
+
+С ?stats=1 в ответе есть поле "stats" — счетчики и фазы (см. stats.hpp)
+только этого запроса.
+
+CORS разрешен только путям, которые сеть не меняют; /api/network и
+/api/deltas отвечают без него, а запрос к ним с заголовком Origin (из
+браузера) получает 403.
+
+С ?format=json (/api/run, /api/route, /api/zones) отчет не печатается
+текстом: "stdout" пуст, а поле "result" несет документ --format json
+(для /api/route — без "zones", для /api/zones — только "zones").
+----------------------------------------------------------------------
+*/
+
+struct ServiceOptions {
+    std::string host = "127.0.0.1";
+    int port = 8090;
+    std::string network_path; // необязательный файл сети (текст или снимок) для загрузки при старте
+    std::size_t cache_bytes = 0; // предел кэша деревьев кратчайших путей; 0 — без кэша
+    int max_connections = 16;    // потоков пула: столько соединений обслуживается одновременно
+};
+
+// Ядро сервиса без сокетов: текущая сеть, кэш и обработчики путей. Цикл
+// соединений run_service передает ему разобранные HTTP-запросы; тесты
+// вызывают его напрямую.
+class ServiceCore {
+public:
+    explicit ServiceCore(std::size_t cache_bytes = 0);
+    ~ServiceCore();
+
+    ServiceCore(const ServiceCore&) = delete;
+    ServiceCore& operator=(const ServiceCore&) = delete;
+
+    // Загрузить сеть из файла (текст или снимок); false — ошибка в error.
+    bool load_file(const std::string& path, std::string& error);
+
+    // Запрос method path?query: в response — тело ответа 200 (JSON, см.
+    // выше). false — путь не найден (404).
+    bool handle(const std::string& method, const std::string& path, const std::string& query,
+                const std::string& body, std::string& response);
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+// Запускает цикл приема соединений; возвращает код завершения процесса:
+// ошибка запуска или 0 после SIGINT/SIGTERM, когда открытые соединения
+// закрыты и потоки пула присоединены.
+int run_service(const ServiceOptions& options);
+
+#endif // SERVICE_HPP
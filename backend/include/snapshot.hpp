@@ -0,0 +1,92 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "frozen_graph.hpp"
+#include "parser.hpp"   // ModelParams
+
+/*
+----------------------------------------------------------------------
+БИНАРНЫЙ СНИМОК СЕТИ
+
+Подготовленная сеть (CSR-массивы FrozenGraph, ModelParams и метки
+компонент для всех четырех TransportType) записывается один раз командой
+конвертации и затем отображается в память только для чтения (mmap):
+массивы FrozenGraph указывают прямо в страницы файла, поэтому загрузка
+не разбирает текст и не строит граф, а несколько процессов делят одни
+страницы.
+
+Раскладка файла (порядок байтов хоста, проверяется маркером):
+  SnapshotHeader
+  секции, каждая выровнена на kSnapshotAlign байт:
+    offsets, to, edge_id, base_time, load, station_transfer,
+    labels[metro], labels[bus], labels[rail], labels[all]
+
+Заголовок защищен своей контрольной суммой (проверяется всегда, O(1)).
+Всегда проверяется и то, что поиски используют как индексы: смещения
+монотонны, концы дуг — станции 1..n, id рёбер и метки зон в допустимых
+пределах (один проход по offsets, to, edge_id и меткам). Контрольная сумма
+всех данных проверяется только по запросу (verify = true).
+----------------------------------------------------------------------
+*/
+
+constexpr std::uint32_t kSnapshotVersion = 1;
+constexpr std::uint64_t kSnapshotAlign = 64;
+
+enum SnapshotSectionId : int {
+    kSectionOffsets = 0,
+    kSectionTo,
+    kSectionEdgeId,
+    kSectionBaseTime,
+    kSectionLoad,
+    kSectionStationTransfer,
+    kSectionLabelsMetro,
+    kSectionLabelsBus,
+    kSectionLabelsRail,
+    kSectionLabelsAll,
+    kSectionCount
+};
+
+struct SnapshotSection {
+    std::uint64_t offset; // от начала файла
+    std::uint64_t bytes;
+};
+
+struct SnapshotHeader {
+    char magic[8];              // "RNAVSNAP"
+    std::uint32_t version;      // kSnapshotVersion
+    std::uint32_t endian;       // 0x01020304 в порядке байтов писателя
+    std::uint32_t header_bytes; // sizeof(SnapshotHeader)
+    std::uint32_t section_count;
+    std::int32_t n;
+    std::int32_t m;
+    std::uint64_t arc_count;
+    double sensitivity[3];
+    double trans[9];
+    SnapshotSection sections[kSectionCount];
+    std::uint64_t payload_checksum; // по всем байтам после заголовка
+    std::uint64_t header_checksum;  // по байтам заголовка до этого поля
+};
+
+struct Snapshot {
+    FrozenGraph g;       // массивы указывают в отображенный файл
+    ModelParams model;   // station_transfer копируется (N + 1 чисел)
+    std::array<ArrayView<int>, 4> component_labels; // metro, bus, rail, all
+};
+
+// WRITE-SNAPSHOT: сеть должна быть проверена (validate_graph/validate_model).
+// threads — потоки поиска компонент для меток зон.
+bool write_snapshot(const std::string& path, const FrozenGraph& g, const ModelParams& model, std::string& error, int threads = 1);
+
+// LOAD-SNAPSHOT: mmap + проверка заголовка и массивов-индексов; verify — еще и
+// контрольная сумма данных.
+bool load_snapshot(const std::string& path, Snapshot& out, bool verify, std::string& error);
+
+// Файл начинается с магической строки снимка.
+bool is_snapshot_file(const std::string& path);
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,66 @@
+#ifndef STAMPED_TABLE_HPP
+#define STAMPED_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+----------------------------------------------------------------------
+ТАБЛИЦА С ЭПОХАМИ: массив значений, очищаемый за O(1)
+
+Ячейка i действительна, только если ее метка равна эпохе текущего поиска;
+иначе она читается как значение заполнения. Новый поиск лишь увеличивает эпоху, а ячейка получает
+значение заполнения при первой записи. Поэтому поиск платит только за
+исследованную область, и списки затронутых ячеек не нужны.
+
+Таблица не потокобезопасна: поиски держат свои таблицы в thread_local.
+----------------------------------------------------------------------
+*/
+
+template <typename T>
+class StampedTable {
+public:
+    // Новый поиск: все size ячеек равны fill. O(1); O(size) — при первом
+    // вызове, при смене size и раз в 2^32 поисков (переполнение эпохи).
+    void begin(std::size_t size, const T& fill) {
+        if (stamp_.size() != size) {
+            value_.resize(size);
+            stamp_.assign(size, 0);
+            epoch_ = 0;
+        }
+        fill_ = fill;
+        ++epoch_;
+        if (epoch_ == 0) {
+            std::fill(stamp_.begin(), stamp_.end(), 0u);
+            epoch_ = 1;
+        }
+    }
+
+    const T& operator[](std::size_t i) const {
+        return stamp_[i] == epoch_ ? value_[i] : fill_;
+    }
+
+    // Ячейка записана в текущем поиске.
+    bool contains(std::size_t i) const {
+        return stamp_[i] == epoch_;
+    }
+
+    // Ячейка для записи: в текущем поиске ее значение сохраняется.
+    T& touch(std::size_t i) {
+        if (stamp_[i] != epoch_) {
+            stamp_[i] = epoch_;
+            value_[i] = fill_;
+        }
+        return value_[i];
+    }
+
+private:
+    std::vector<T> value_;
+    std::vector<std::uint32_t> stamp_;
+    std::uint32_t epoch_ = 0;
+    T fill_{};
+};
+
+#endif // STAMPED_TABLE_HPP
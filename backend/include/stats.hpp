@@ -0,0 +1,162 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/*
+----------------------------------------------------------------------
+СЧЕТЧИКИ ГОРЯЧИХ ПУТЕЙ И ТАЙМЕРЫ ФАЗ (--stats)
+----------------------------------------------------------------------
+Каждый поток копит счетчики в своем блоке (thread_local), без атомарных
+операций; поиск считает в локальных переменных и прибавляет их к блоку
+один раз в конце (SearchCounters::commit). Потоки пула перед выходом
+сливают блок в общий (stats_flush_thread), stats_collect складывает общий
+блок и блок вызывающего потока. Время фаз рабочих потоков суммируется,
+поэтому при --threads > 1 search — процессорное время, а не настенное.
+
+Сборка с RAILWAY_STATS=0 (CMake: -DENABLE_STATS=OFF) убирает учет
+целиком: методы пусты, вызовы часов и счет выбрасывает компилятор, а
+--stats печатает {"stats":{"enabled":false}}.
+----------------------------------------------------------------------
+*/
+
+#ifndef RAILWAY_STATS
+#define RAILWAY_STATS 1
+#endif
+
+constexpr bool kStatsEnabled = RAILWAY_STATS != 0;
+
+enum class Counter : int {
+    ParsedBytes,       // байты разобранного текста
+    ParsedEdges,
+    ParsedRequests,
+    ValidatedArcs,     // проверенные записи списков смежности
+    ValidatedRequests,
+    DfsVertices,       // вершины, открытые DFS компонент (union-find при --threads > 1 не считается)
+    DfsArcs,           // просмотренные дуги поиска компонент
+    Searches,          // запуски Дейкстры (однонаправленной и двунаправленной)
+    HeapPushes,
+    StalePops,         // устаревшие записи, снятые с очереди без обработки
+    SettledStates,
+    Relaxations,       // просмотренные дуги (u, a) -> (v, b)
+    Count
+};
+
+enum class Phase : int {
+    Parse,
+    Validate,
+    Zones,
+    Prepare,  // снимок, веса дуг, иерархия, ориентиры
+    Search,
+    Output,
+    Count
+};
+
+constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::Count);
+constexpr std::size_t kPhaseCount = static_cast<std::size_t>(Phase::Count);
+
+struct StatsBlock {
+    std::array<std::uint64_t, kCounterCount> counters{};
+    std::array<std::uint64_t, kPhaseCount> phase_ns{};
+
+    StatsBlock& operator+=(const StatsBlock& other);
+    StatsBlock& operator-=(const StatsBlock& other);
+};
+
+// Блок вызывающего потока.
+StatsBlock& thread_stats();
+
+// Прибавить блок потока к общему и обнулить его (в конце работы потока пула).
+void stats_flush_thread();
+
+// Общий блок плюс блок вызывающего потока.
+StatsBlock stats_collect();
+
+// Обнулить общий блок и блок вызывающего потока.
+void stats_reset();
+
+// Одна строка JSON без перевода строки:
+// {"stats":{"enabled":true,"counters":{...},"phases_ms":{...}}}
+void write_stats_json(std::ostream& out, const StatsBlock& stats);
+
+// Только значение поля "stats": {"enabled":true,"counters":{...},...}.
+void write_stats_object(std::ostream& out, const StatsBlock& stats);
+
+inline void stats_add(Counter c, std::uint64_t n = 1) {
+    if constexpr (kStatsEnabled) {
+        thread_stats().counters[static_cast<std::size_t>(c)] += n;
+    }
+}
+
+// Время от создания до разрушения прибавляется к фазе.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase) : phase_(phase) {
+        if constexpr (kStatsEnabled) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        if constexpr (kStatsEnabled) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_);
+            thread_stats().phase_ns[static_cast<std::size_t>(phase_)] += static_cast<std::uint64_t>(ns.count());
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    Phase phase_;
+    std::chrono::steady_clock::time_point start_{};
+};
+
+// Счетчики одного поиска в локальных переменных.
+struct SearchCounters {
+    std::uint64_t pushes = 0;
+    std::uint64_t stale = 0;
+    std::uint64_t settled = 0;
+    std::uint64_t relaxations = 0;
+
+    void push() {
+        if constexpr (kStatsEnabled) ++pushes;
+    }
+    void stale_pop() {
+        if constexpr (kStatsEnabled) ++stale;
+    }
+    void settle() {
+        if constexpr (kStatsEnabled) ++settled;
+    }
+    void relax() {
+        if constexpr (kStatsEnabled) ++relaxations;
+    }
+
+    SearchCounters& operator+=(const SearchCounters& other) {
+        pushes += other.pushes;
+        stale += other.stale;
+        settled += other.settled;
+        relaxations += other.relaxations;
+        return *this;
+    }
+
+    // Прибавить к блоку потока как один поиск и обнулить.
+    void commit() {
+        if constexpr (kStatsEnabled) {
+            StatsBlock& s = thread_stats();
+            s.counters[static_cast<std::size_t>(Counter::Searches)] += 1;
+            s.counters[static_cast<std::size_t>(Counter::HeapPushes)] += pushes;
+            s.counters[static_cast<std::size_t>(Counter::StalePops)] += stale;
+            s.counters[static_cast<std::size_t>(Counter::SettledStates)] += settled;
+            s.counters[static_cast<std::size_t>(Counter::Relaxations)] += relaxations;
+            *this = SearchCounters{};
+        }
+    }
+};
+
+#endif // STATS_HPP
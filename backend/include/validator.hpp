@@ -14,4 +14,10 @@ bool validate_graph(const Graph& g, std::string& error);
 bool validate_model(const Graph& g, const ModelParams& m, std::string& error);
 bool validate_requests(const Graph& g, const std::vector<Request>& reqs, std::string& error);
 
+// Для запросов нужна только |V| — так их можно проверить и без Graph (снимок).
+bool validate_requests(int n, const std::vector<Request>& reqs, std::string& error);
+
+// Станции запросов матриц — в [1, n].
+bool validate_matrix_requests(int n, const std::vector<MatrixRequest>& matrices, std::string& error);
+
 #endif // VALIDATOR_HPP
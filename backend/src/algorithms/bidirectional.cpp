@@ -0,0 +1,248 @@
+#include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "path_cost.hpp"
+#include "stats.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace {
+
+constexpr int kModeCount = 4;
+constexpr int kNoMode = 3;
+
+int state_of(int v, int mode) {
+    return kModeCount * v + mode;
+}
+
+struct QueueItem {
+    PathCost cost;
+    int state;
+};
+
+// Сравнение точное (path_cost.hpp) и внутри сторон, и для встреч.
+struct QueueGreater {
+    bool operator()(const QueueItem& a, const QueueItem& b) const {
+        return path_cost_less(b.cost, a.cost);
+    }
+};
+
+using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, QueueGreater>;
+
+// Одна сторона поиска. parent — соседнее состояние на пути к своему
+// источнику: для прямого поиска предок, для обратного — преемник.
+struct Side {
+    std::vector<PathCost> dist;
+    std::vector<int> parent;
+    std::vector<int> touched;
+    MinQueue q;
+    SearchCounters counters;
+
+    void init(std::size_t states) {
+        if (dist.size() != states) {
+            dist.assign(states, PathCost{});
+            parent.assign(states, -1);
+            touched.clear();
+        }
+    }
+
+    void reset() {
+        for (int x : touched) {
+            dist[x] = PathCost{};
+            parent[x] = -1;
+        }
+        touched.clear();
+        q = MinQueue();
+    }
+
+    // Снять с вершины очереди устаревшие записи.
+    void prune() {
+        while (!q.empty() && path_cost_less(dist[q.top().state], q.top().cost)) {
+            q.pop();
+            counters.stale_pop();
+        }
+    }
+};
+
+struct Meeting {
+    PathCost best;
+    int state = -1;
+};
+
+// Улучшить оценку x на стороне side и проверить встречу с другой стороной.
+void relax(Side& side, const Side& other, int x, const PathCost& c, int parent, Meeting& meet) {
+    side.counters.relax();
+    if (!path_cost_less(c, side.dist[x])) {
+        return;
+    }
+    if (!reachable(side.dist[x])) {
+        side.touched.push_back(x);
+    }
+    side.dist[x] = c;
+    side.parent[x] = parent;
+    side.q.push(QueueItem{c, x});
+    side.counters.push();
+
+    const PathCost& o = other.dist[x];
+    if (reachable(o)) {
+        const PathCost total = path_cost_add(c, o.time, o.transfers);
+        if (path_cost_less(total, meet.best)) {
+            meet.best = total;
+            meet.state = x;
+        }
+    }
+}
+
+double penalty_of(const ModelParams& model, int u, int from_mode, int to_mode) {
+    return model.trans[from_mode][to_mode] + model.station_transfer[u];
+}
+
+// Прямой шаг: те же переходы, что в run_dijkstra_states. Arcs — ComputedArcs
+// или MaterializedArcs (arc_weights.hpp).
+template <typename Arcs>
+void expand_forward(const FrozenGraph& g, const ModelParams& model, Arcs arcs, Side& fw, const Side& bw, const QueueItem& it, Meeting& meet) {
+    const int u = it.state / kModeCount;
+    const int a = it.state % kModeCount;
+    for (int b = 0; b < 3; ++b) {
+        double penalty = 0.0;
+        int add_transfer = 0;
+        if (a != kNoMode && a != b) {
+            penalty = penalty_of(model, u, a, b);
+            add_transfer = 1;
+        }
+        for (int arc = g.mode_begin(u, b); arc < g.mode_end(u, b); ++arc) {
+            const int v = g.to[static_cast<std::size_t>(arc)];
+            const double w = arcs(arc, b) + penalty;
+            relax(fw, bw, state_of(v, b), path_cost_add(it.cost, w, add_transfer), it.state, meet);
+        }
+    }
+}
+
+// Обратный шаг из (v, b): предшественники (u, a) по дугам u -> v вида b.
+// Граф неориентированный, поэтому дуга u -> v — зеркало дуги v -> u
+// того же вида с тем же весом. Состояние (start, kNoMode) — единственное
+// без последнего вида: из него первая посадка без штрафа.
+template <typename Arcs>
+void expand_backward(const FrozenGraph& g, const ModelParams& model, Arcs arcs, int start, Side& bw, const Side& fw, const QueueItem& it, Meeting& meet) {
+    const int v = it.state / kModeCount;
+    const int b = it.state % kModeCount;
+    if (b == kNoMode) {
+        return;
+    }
+    for (int arc = g.mode_begin(v, b); arc < g.mode_end(v, b); ++arc) {
+        const int u = g.to[static_cast<std::size_t>(arc)];
+        const double w = arcs(arc, b);
+        for (int a = 0; a < 3; ++a) {
+            if (a == b) {
+                relax(bw, fw, state_of(u, a), path_cost_add(it.cost, w, 0), it.state, meet);
+            } else {
+                relax(bw, fw, state_of(u, a), path_cost_add(it.cost, w + penalty_of(model, u, a, b), 1), it.state, meet);
+            }
+        }
+        if (u == start) {
+            relax(bw, fw, state_of(u, kNoMode), path_cost_add(it.cost, w, 0), it.state, meet);
+        }
+    }
+}
+
+} // namespace
+
+Route bidirectional_route(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    int target,
+    double k,
+    const ArcWeights* weights
+) {
+    Route route;
+    route.target = target;
+    if (start == target) {
+        route.reachable = true;
+        return route;
+    }
+    route.time = PathCost{}.time;
+    route.transfers = PathCost{}.transfers;
+    route.metric = PathCost{}.time;
+    if (!valid_vertex(g, start) || !valid_vertex(g, target)) {
+        return route;
+    }
+
+    const std::size_t states = kModeCount * (static_cast<std::size_t>(g.n) + 1);
+    thread_local Side fw;
+    thread_local Side bw;
+    fw.init(states);
+    bw.init(states);
+
+    const bool materialized = weights != nullptr && weights->matches(g, model.sensitivity);
+    Meeting meet;
+    relax(fw, bw, state_of(start, kNoMode), PathCost{0.0, 0}, -1, meet);
+    for (int m = 0; m < 3; ++m) {
+        relax(bw, fw, state_of(target, m), PathCost{0.0, 0}, -1, meet);
+    }
+
+    // Останов: одна из очередей пуста (все ее состояния окончательны и
+    // встречи с ними уже учтены) или сумма вершин очередей больше лучшей
+    // встречи: любой еще не найденный путь не короче этой суммы, так как
+    // веса неотрицательны.
+    for (;;) {
+        fw.prune();
+        bw.prune();
+        if (fw.q.empty() || bw.q.empty()) {
+            break;
+        }
+        const QueueItem top_f = fw.q.top();
+        const QueueItem top_b = bw.q.top();
+        const PathCost sum = path_cost_add(top_f.cost, top_b.cost.time, top_b.cost.transfers);
+        if (path_cost_less(meet.best, sum)) {
+            break;
+        }
+        // Продвигается сторона с меньшей очередью (критерий Поля): обратный
+        // шаг порождает до трех предшественников на дугу, и выбор по ключу
+        // перекашивал бы работу в обратную сторону.
+        if (fw.q.size() <= bw.q.size()) {
+            fw.q.pop();
+            fw.counters.settle();
+            if (materialized) {
+                expand_forward(g, model, MaterializedArcs{weights->time.data()}, fw, bw, top_f, meet);
+            } else {
+                expand_forward(g, model, ComputedArcs{g, model.sensitivity}, fw, bw, top_f, meet);
+            }
+        } else {
+            bw.q.pop();
+            bw.counters.settle();
+            if (materialized) {
+                expand_backward(g, model, MaterializedArcs{weights->time.data()}, start, bw, fw, top_b, meet);
+            } else {
+                expand_backward(g, model, ComputedArcs{g, model.sensitivity}, start, bw, fw, top_b, meet);
+            }
+        }
+    }
+
+    if (meet.state >= 0) {
+        // Прямая половина от встречи к start (в обратном порядке), затем
+        // обратная половина от встречи к цели.
+        std::vector<int> path;
+        for (int x = meet.state; x != -1; x = fw.parent[x]) {
+            path.push_back(x);
+        }
+        std::reverse(path.begin(), path.end());
+        for (int x = bw.parent[meet.state]; x != -1; x = bw.parent[x]) {
+            path.push_back(x);
+        }
+        for (std::size_t i = 1; i < path.size(); ++i) {
+            route.steps.push_back(Step{path[i - 1] / kModeCount, path[i] / kModeCount, path[i] % kModeCount});
+        }
+        route.reachable = true;
+        evaluate_route(g, model, route, k);
+    }
+
+    // Обе стороны — один поиск.
+    fw.counters += bw.counters;
+    bw.counters = SearchCounters{};
+    fw.counters.commit();
+    fw.reset();
+    bw.reset();
+    return route;
+}
@@ -0,0 +1,657 @@
+#include "contraction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr int kInfTransfers = std::numeric_limits<int>::max() / 4;
+
+// Предел settled-узлов поиска свидетеля: при оценке приоритета и при сжатии.
+// Незавершенный поиск лишь добавляет ярлык, корректность не страдает.
+constexpr int kSimulateSettleLimit = 60;
+constexpr int kContractSettleLimit = 500;
+
+// Стоимость в иерархии: (время, пересадки) с точным сравнением, как
+// is_better у Дейкстры, и число исходных рёбер последним ключом. Рёбра
+// с base_time = 0 дают циклы нулевой стоимости; без третьего ключа путь
+// вверх по ярлыкам мог пройти такой цикл при той же цене
+// (1-[bus]->2 2-[bus]->1 1-[bus]->2), а с ним путь с циклом всегда дороже.
+struct Cost {
+    double time = kInf;
+    int transfers = kInfTransfers;
+    int hops = 0;
+};
+
+bool cost_less(const Cost& a, const Cost& b) {
+    if (a.time != b.time) {
+        return a.time < b.time;
+    }
+    if (a.transfers != b.transfers) {
+        return a.transfers < b.transfers;
+    }
+    return a.hops < b.hops;
+}
+
+Cost cost_add(const Cost& a, double time, int transfers, int hops) {
+    return Cost{a.time + time, a.transfers + transfers, a.hops + hops};
+}
+
+Cost cost_add(const Cost& a, const ChArc& arc) {
+    return cost_add(a, arc.time, arc.transfers, arc.hops);
+}
+
+bool reached(const Cost& c) {
+    return std::isfinite(c.time);
+}
+
+struct QueueItem {
+    Cost cost;
+    int node;
+};
+
+struct QueueGreater {
+    bool operator()(const QueueItem& a, const QueueItem& b) const {
+        return cost_less(b.cost, a.cost);
+    }
+};
+
+using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, QueueGreater>;
+
+int node_of(int v, int mode) {
+    return 3 * v + mode;
+}
+
+// Изменяемый граф на время сжатия: только несжатые узлы (сжатый узел
+// удаляется из списков соседей).
+struct Overlay {
+    std::vector<std::vector<ChArc>> out;
+    std::vector<std::vector<ChArc>> in;
+};
+
+void remove_arc_to(std::vector<ChArc>& list, int node) {
+    list.erase(std::remove_if(list.begin(), list.end(), [node](const ChArc& a) { return a.node == node; }), list.end());
+}
+
+// Добавить ребро x -> y или улучшить существующее (параллельных рёбер нет).
+void add_or_update(Overlay& ov, int x, int y, const Cost& c, int middle) {
+    for (ChArc& a : ov.out[x]) {
+        if (a.node == y) {
+            if (!cost_less(c, Cost{a.time, a.transfers, a.hops})) {
+                return;
+            }
+            a.time = c.time;
+            a.transfers = c.transfers;
+            a.middle = middle;
+            a.hops = c.hops;
+            for (ChArc& b : ov.in[y]) {
+                if (b.node == x) {
+                    b.time = c.time;
+                    b.transfers = c.transfers;
+                    b.middle = middle;
+                    b.hops = c.hops;
+                    break;
+                }
+            }
+            return;
+        }
+    }
+    ov.out[x].push_back(ChArc{y, c.time, c.transfers, middle, c.hops});
+    ov.in[y].push_back(ChArc{x, c.time, c.transfers, middle, c.hops});
+}
+
+// Локальный поиск Дейкстры в несжатой части графа без узла excluded.
+class WitnessSearch {
+public:
+    explicit WitnessSearch(std::size_t nodes) : dist_(nodes), mark_(nodes, 0) {}
+
+    // targets — число узлов, помеченных mark(): поиск прекращается, когда
+    // все они извлечены из очереди.
+    void run(const Overlay& ov, int source, int excluded, const Cost& limit, int settle_limit, int targets) {
+        for (int x : touched_) {
+            dist_[x] = Cost{};
+        }
+        touched_.clear();
+
+        MinQueue q;
+        dist_[source] = Cost{0.0, 0, 0};
+        touched_.push_back(source);
+        q.push(QueueItem{dist_[source], source});
+
+        int settled = 0;
+        while (!q.empty()) {
+            const QueueItem it = q.top();
+            q.pop();
+            if (cost_less(dist_[it.node], it.cost)) {
+                continue;
+            }
+            if (cost_less(limit, it.cost) || ++settled > settle_limit) {
+                break;
+            }
+            if (mark_[it.node] && --targets == 0) {
+                break;
+            }
+            for (const ChArc& a : ov.out[it.node]) {
+                if (a.node == excluded) {
+                    continue;
+                }
+                const Cost c = cost_add(it.cost, a);
+                if (cost_less(c, dist_[a.node])) {
+                    if (!reached(dist_[a.node])) {
+                        touched_.push_back(a.node);
+                    }
+                    dist_[a.node] = c;
+                    q.push(QueueItem{c, a.node});
+                }
+            }
+        }
+    }
+
+    const Cost& dist(int x) const { return dist_[x]; }
+
+    void mark(int x, bool on) { mark_[x] = on ? 1 : 0; }
+
+private:
+    std::vector<Cost> dist_;
+    std::vector<char> mark_;
+    std::vector<int> touched_;
+};
+
+// Сжать v (apply) или только сосчитать нужные ярлыки.
+int contract_node(Overlay& ov, WitnessSearch& ws, int v, bool apply) {
+    const int settle_limit = apply ? kContractSettleLimit : kSimulateSettleLimit;
+    int added = 0;
+
+    int targets = 0;
+    for (const ChArc& out : ov.out[v]) {
+        ws.mark(out.node, true);
+        ++targets;
+    }
+
+    for (const ChArc& in : ov.in[v]) {
+        const int u = in.node;
+
+        // Свидетель дороже самого дорогого пути u -> v -> w не нужен.
+        bool any = false;
+        Cost limit{0.0, 0, 0};
+        for (const ChArc& out : ov.out[v]) {
+            if (out.node == u) {
+                continue;
+            }
+            const Cost c{in.time + out.time, in.transfers + out.transfers, in.hops + out.hops};
+            if (cost_less(limit, c)) {
+                limit = c;
+            }
+            any = true;
+        }
+        if (!any) {
+            continue;
+        }
+
+        // u сам может быть одной из целей: его расстояние 0 не мешает.
+        ws.run(ov, u, v, limit, settle_limit, targets);
+        for (const ChArc& out : ov.out[v]) {
+            const int w = out.node;
+            if (w == u) {
+                continue;
+            }
+            const Cost c{in.time + out.time, in.transfers + out.transfers, in.hops + out.hops};
+            if (!cost_less(c, ws.dist(w))) {
+                continue; // есть свидетель не дороже
+            }
+            ++added;
+            if (apply) {
+                add_or_update(ov, u, w, c, v);
+            }
+        }
+    }
+
+    for (const ChArc& out : ov.out[v]) {
+        ws.mark(out.node, false);
+    }
+    return added;
+}
+
+
+// Поиск запроса: только вверх по рангу.
+struct SearchSide {
+    std::vector<Cost> dist;
+    std::vector<int> parent;     // узел-предок; -1 — начальное состояние
+    std::vector<int> parent_arc; // индекс ребра в up_out (прямой) / up_in (обратный)
+    std::vector<int> touched;
+
+    void init(std::size_t nodes) {
+        if (dist.size() != nodes) {
+            dist.assign(nodes, Cost{});
+            parent.assign(nodes, -1);
+            parent_arc.assign(nodes, -1);
+            touched.clear();
+        }
+    }
+
+    void reset() {
+        for (int x : touched) {
+            dist[x] = Cost{};
+            parent[x] = -1;
+            parent_arc[x] = -1;
+        }
+        touched.clear();
+    }
+
+    bool relax(int x, const Cost& c, int from, int arc) {
+        if (!cost_less(c, dist[x])) {
+            return false;
+        }
+        if (!reached(dist[x])) {
+            touched.push_back(x);
+        }
+        dist[x] = c;
+        parent[x] = from;
+        parent_arc[x] = arc;
+        return true;
+    }
+};
+
+// Прямой поиск до исчерпания, обратный — пока ключ не превысит лучшую встречу.
+void upward_search(
+    const std::vector<int>& offsets,
+    const std::vector<ChArc>& arcs,
+    SearchSide& side,
+    MinQueue& q,
+    const SearchSide* other,
+    Cost& best,
+    int& meet
+) {
+    while (!q.empty()) {
+        const QueueItem it = q.top();
+        q.pop();
+        if (cost_less(side.dist[it.node], it.cost)) {
+            continue;
+        }
+        if (other != nullptr) {
+            if (cost_less(best, it.cost)) {
+                break;
+            }
+            const Cost& f = other->dist[it.node];
+            if (reached(f)) {
+                const Cost c = cost_add(f, it.cost.time, it.cost.transfers, it.cost.hops);
+                if (cost_less(c, best)) {
+                    best = c;
+                    meet = it.node;
+                }
+            }
+        }
+        for (int i = offsets[it.node]; i < offsets[it.node + 1]; ++i) {
+            const ChArc& a = arcs[static_cast<std::size_t>(i)];
+            const Cost c = cost_add(it.cost, a);
+            if (side.relax(a.node, c, it.node, i)) {
+                q.push(QueueItem{c, a.node});
+            }
+        }
+    }
+}
+
+const ChArc* find_arc(const std::vector<int>& offsets, const std::vector<ChArc>& arcs, int at, int node) {
+    for (int i = offsets[at]; i < offsets[at + 1]; ++i) {
+        if (arcs[static_cast<std::size_t>(i)].node == node) {
+            return &arcs[static_cast<std::size_t>(i)];
+        }
+    }
+    return nullptr;
+}
+
+// Раскрыть ребро from -> to (возможно, ярлык) в исходные шаги.
+void unpack_arc(const ContractionHierarchy& ch, int from, int to, int middle, std::vector<Step>& steps) {
+    std::vector<std::pair<std::pair<int, int>, int>> stack;
+    stack.push_back({{from, to}, middle});
+    while (!stack.empty()) {
+        const auto top = stack.back();
+        stack.pop_back();
+        const int x = top.first.first;
+        const int y = top.first.second;
+        const int z = top.second;
+        if (z < 0) {
+            steps.push_back(Step{x / 3, y / 3, y % 3});
+            continue;
+        }
+        // x -> z лежит в up_in[z], z -> y — в up_out[z] (z сжат раньше x и y).
+        const ChArc* left = find_arc(ch.in_offsets, ch.up_in, z, x);
+        const ChArc* right = find_arc(ch.out_offsets, ch.up_out, z, y);
+        stack.push_back({{z, y}, right->middle});
+        stack.push_back({{x, z}, left->middle});
+    }
+}
+
+Route unreachable_route(int target) {
+    Route route;
+    route.target = target;
+    route.reachable = false;
+    route.time = kInf;
+    route.transfers = kInfTransfers;
+    route.metric = kInf;
+    return route;
+}
+
+// Прямая половина пути: от встречи meet к начальному состоянию прямого
+// поиска, затем разворот и раскрытие ярлыков up_out.
+void unpack_forward(const ContractionHierarchy& ch, const SearchSide& forward, int start, int meet, std::vector<Step>& steps) {
+    std::vector<int> chain;
+    int seed = meet;
+    while (forward.parent[seed] != -1) {
+        chain.push_back(seed);
+        seed = forward.parent[seed];
+    }
+    steps.push_back(Step{start, seed / 3, seed % 3});
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const int x = *it;
+        const ChArc& a = ch.up_out[static_cast<std::size_t>(forward.parent_arc[x])];
+        unpack_arc(ch, forward.parent[x], x, a.middle, steps);
+    }
+}
+
+// Запись корзины узла x для цели target; корзина упорядочена по target.
+const ChBucketEntry& bucket_entry(const ChBuckets& buckets, int x, int target) {
+    const auto first = buckets.entries.begin() + buckets.offsets[x];
+    const auto last = buckets.entries.begin() + buckets.offsets[x + 1];
+    return *std::lower_bound(first, last, target, [](const ChBucketEntry& e, int t) { return e.target < t; });
+}
+
+} // namespace
+
+ContractionHierarchy build_contraction_hierarchy(const FrozenGraph& g, const ModelParams& model) {
+    const std::size_t nodes = 3 * (static_cast<std::size_t>(g.n) + 1);
+
+    Overlay ov;
+    ov.out.resize(nodes);
+    ov.in.resize(nodes);
+
+    // Ребра графа состояний — те же переходы, что в run_dijkstra_states.
+    for (int u = 1; u <= g.n; ++u) {
+        for (int b = 0; b < 3; ++b) {
+            for (int arc = g.mode_begin(u, b); arc < g.mode_end(u, b); ++arc) {
+                const int v = g.to[static_cast<std::size_t>(arc)];
+                const double w = arc_time(g, arc, b, model.sensitivity);
+                for (int a = 0; a < 3; ++a) {
+                    if (u == v && a == b) {
+                        continue;
+                    }
+                    Cost c{w, 0, 1};
+                    if (a != b) {
+                        c = Cost{w + (model.trans[a][b] + model.station_transfer[u]), 1, 1};
+                    }
+                    add_or_update(ov, node_of(u, a), node_of(v, b), c, -1);
+                }
+            }
+        }
+    }
+
+    WitnessSearch ws(nodes);
+    std::vector<int> deleted_neighbors(nodes, 0);
+    auto priority = [&](int v) {
+        const int degree = static_cast<int>(ov.out[v].size() + ov.in[v].size());
+        return contract_node(ov, ws, v, false) - degree + deleted_neighbors[v];
+    };
+
+    using Entry = std::pair<int, int>; // (приоритет, узел)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> order;
+    for (std::size_t x = 0; x < nodes; ++x) {
+        order.push({priority(static_cast<int>(x)), static_cast<int>(x)});
+    }
+
+    ContractionHierarchy ch;
+    ch.n = g.n;
+    ch.version = g.version;
+    ch.rank.assign(nodes, 0);
+    std::vector<std::vector<ChArc>> final_out(nodes);
+    std::vector<std::vector<ChArc>> final_in(nodes);
+
+    int next_rank = 0;
+    while (!order.empty()) {
+        const int v = order.top().second;
+        order.pop();
+
+        // Ленивое обновление: приоритет пересчитывается при извлечении.
+        const int p = priority(v);
+        if (!order.empty() && p > order.top().first) {
+            order.push({p, v});
+            continue;
+        }
+
+        ch.shortcuts += contract_node(ov, ws, v, true);
+        ch.rank[v] = next_rank++;
+
+        for (const ChArc& a : ov.out[v]) {
+            remove_arc_to(ov.in[a.node], v);
+            ++deleted_neighbors[a.node];
+        }
+        for (const ChArc& a : ov.in[v]) {
+            remove_arc_to(ov.out[a.node], v);
+            ++deleted_neighbors[a.node];
+        }
+        final_out[v] = std::move(ov.out[v]);
+        final_in[v] = std::move(ov.in[v]);
+    }
+
+    auto flatten = [nodes](std::vector<std::vector<ChArc>>& lists, std::vector<int>& offsets, std::vector<ChArc>& arcs) {
+        offsets.assign(nodes + 1, 0);
+        for (std::size_t x = 0; x < nodes; ++x) {
+            offsets[x + 1] = offsets[x] + static_cast<int>(lists[x].size());
+        }
+        arcs.reserve(static_cast<std::size_t>(offsets[nodes]));
+        for (std::size_t x = 0; x < nodes; ++x) {
+            arcs.insert(arcs.end(), lists[x].begin(), lists[x].end());
+            std::vector<ChArc>().swap(lists[x]);
+        }
+    };
+    flatten(final_out, ch.out_offsets, ch.up_out);
+    flatten(final_in, ch.in_offsets, ch.up_in);
+    return ch;
+}
+
+std::vector<Route> solve_request_ch(
+    const ContractionHierarchy& ch,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq
+) {
+    const std::size_t nodes = 3 * (static_cast<std::size_t>(ch.n) + 1);
+    thread_local SearchSide forward;
+    thread_local SearchSide backward;
+    forward.init(nodes);
+    backward.init(nodes);
+
+    std::vector<Route> routes;
+    routes.reserve(rq.targets.size());
+
+    // Прямой поиск один на запрос: начальные состояния — дуги из start.
+    MinQueue q;
+    if (valid_vertex(g, rq.start)) {
+        for (int b = 0; b < 3; ++b) {
+            for (int arc = g.mode_begin(rq.start, b); arc < g.mode_end(rq.start, b); ++arc) {
+                const int x = node_of(g.to[static_cast<std::size_t>(arc)], b);
+                const Cost c{arc_time(g, arc, b, model.sensitivity), 0, 1};
+                if (forward.relax(x, c, -1, -1)) {
+                    q.push(QueueItem{c, x});
+                }
+            }
+        }
+    }
+    Cost no_best;
+    int no_meet = -1;
+    upward_search(ch.out_offsets, ch.up_out, forward, q, nullptr, no_best, no_meet);
+
+    for (int target : rq.targets) {
+        if (target == rq.start) {
+            Route route;
+            route.target = target;
+            route.reachable = true;
+            routes.push_back(route);
+            continue;
+        }
+        if (!valid_vertex(g, target)) {
+            routes.push_back(unreachable_route(target));
+            continue;
+        }
+
+        MinQueue bq;
+        for (int m = 0; m < 3; ++m) {
+            const int x = node_of(target, m);
+            backward.relax(x, Cost{0.0, 0, 0}, -1, -1);
+            bq.push(QueueItem{Cost{0.0, 0, 0}, x});
+        }
+        Cost best;
+        int meet = -1;
+        upward_search(ch.in_offsets, ch.up_in, backward, bq, &forward, best, meet);
+
+        if (meet < 0) {
+            routes.push_back(unreachable_route(target));
+            backward.reset();
+            continue;
+        }
+
+        Route route;
+        route.target = target;
+        route.reachable = true;
+        unpack_forward(ch, forward, rq.start, meet, route.steps);
+        // Обратная половина: от встречи к цели.
+        for (int x = meet; backward.parent[x] != -1; x = backward.parent[x]) {
+            const ChArc& a = ch.up_in[static_cast<std::size_t>(backward.parent_arc[x])];
+            unpack_arc(ch, x, backward.parent[x], a.middle, route.steps);
+        }
+
+        evaluate_route(g, model, route, rq.k);
+        routes.push_back(std::move(route));
+        backward.reset();
+    }
+    forward.reset();
+
+    if (!routes.empty()) {
+        quicksort_routes(routes, 0, static_cast<int>(routes.size()) - 1);
+    }
+    return routes;
+}
+
+ChBuckets build_ch_buckets(const ContractionHierarchy& ch, const FrozenGraph& g, const std::vector<int>& targets) {
+    const std::size_t nodes = 3 * (static_cast<std::size_t>(ch.n) + 1);
+    thread_local SearchSide backward;
+    backward.init(nodes);
+
+    // Записи собираются парами (узел, запись), затем раскладываются по
+    // узлам подсчетом.
+    std::vector<std::pair<int, ChBucketEntry>> raw;
+    for (std::size_t j = 0; j < targets.size(); ++j) {
+        const int target = targets[j];
+        if (!valid_vertex(g, target)) {
+            continue;
+        }
+        MinQueue q;
+        for (int m = 0; m < 3; ++m) {
+            const int x = node_of(target, m);
+            backward.relax(x, Cost{0.0, 0, 0}, -1, -1);
+            q.push(QueueItem{Cost{0.0, 0, 0}, x});
+        }
+        Cost no_best;
+        int no_meet = -1;
+        upward_search(ch.in_offsets, ch.up_in, backward, q, nullptr, no_best, no_meet);
+        for (int x : backward.touched) {
+            const Cost& c = backward.dist[x];
+            raw.push_back({x, ChBucketEntry{static_cast<int>(j), c.time, c.transfers,
+                                            backward.parent[x], backward.parent_arc[x], c.hops}});
+        }
+        backward.reset();
+    }
+
+    ChBuckets buckets;
+    buckets.offsets.assign(nodes + 1, 0);
+    for (const auto& r : raw) {
+        ++buckets.offsets[static_cast<std::size_t>(r.first) + 1];
+    }
+    for (std::size_t x = 0; x < nodes; ++x) {
+        buckets.offsets[x + 1] += buckets.offsets[x];
+    }
+    buckets.entries.resize(raw.size());
+    std::vector<int> fill(buckets.offsets.begin(), buckets.offsets.end() - 1);
+    for (const auto& r : raw) {
+        buckets.entries[static_cast<std::size_t>(fill[static_cast<std::size_t>(r.first)]++)] = r.second;
+    }
+    return buckets;
+}
+
+void ch_bucket_row(
+    const ContractionHierarchy& ch,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const ChBuckets& buckets,
+    int source,
+    const std::vector<int>& targets,
+    double* time,
+    int* transfers
+) {
+    const std::size_t nodes = 3 * (static_cast<std::size_t>(ch.n) + 1);
+    thread_local SearchSide forward;
+    thread_local std::vector<Cost> best;
+    thread_local std::vector<int> meet; // узел встречи лучшего пути
+    forward.init(nodes);
+    best.assign(targets.size(), Cost{});
+    meet.assign(targets.size(), -1);
+
+    if (valid_vertex(g, source)) {
+        MinQueue q;
+        for (int b = 0; b < 3; ++b) {
+            for (int arc = g.mode_begin(source, b); arc < g.mode_end(source, b); ++arc) {
+                const int x = node_of(g.to[static_cast<std::size_t>(arc)], b);
+                const Cost c{arc_time(g, arc, b, model.sensitivity), 0, 1};
+                if (forward.relax(x, c, -1, -1)) {
+                    q.push(QueueItem{c, x});
+                }
+            }
+        }
+        Cost no_best;
+        int no_meet = -1;
+        upward_search(ch.out_offsets, ch.up_out, forward, q, nullptr, no_best, no_meet);
+
+        // Поиск исчерпан: dist достигнутых узлов окончательны.
+        for (int x : forward.touched) {
+            const Cost& f = forward.dist[x];
+            for (int i = buckets.offsets[x]; i < buckets.offsets[x + 1]; ++i) {
+                const ChBucketEntry& e = buckets.entries[static_cast<std::size_t>(i)];
+                const Cost c = cost_add(f, e.time, e.transfers, e.hops);
+                if (cost_less(c, best[static_cast<std::size_t>(e.target)])) {
+                    best[static_cast<std::size_t>(e.target)] = c;
+                    meet[static_cast<std::size_t>(e.target)] = x;
+                }
+            }
+        }
+    }
+
+    // Сумма весов ярлыков складывается в порядке иерархии и может разойтись
+    // с маршрутом в последнем знаке. Поэтому лучший путь раскрывается и
+    // пересчитывается, как в solve_request_ch.
+    for (std::size_t j = 0; j < targets.size(); ++j) {
+        if (targets[j] == source && valid_vertex(g, source)) {
+            time[j] = 0.0;
+            transfers[j] = 0;
+        } else if (reached(best[j])) {
+            const int t = static_cast<int>(j);
+            Route route;
+            unpack_forward(ch, forward, source, meet[j], route.steps);
+            for (int x = meet[j]; bucket_entry(buckets, x, t).parent != -1;) {
+                const ChBucketEntry& e = bucket_entry(buckets, x, t);
+                unpack_arc(ch, x, e.parent, ch.up_in[static_cast<std::size_t>(e.parent_arc)].middle, route.steps);
+                x = e.parent;
+            }
+            evaluate_route(g, model, route, 0.0);
+            time[j] = route.time;
+            transfers[j] = route.transfers;
+        } else {
+            time[j] = kInf;
+            transfers[j] = -1;
+        }
+    }
+    forward.reset();
+}
@@ -1,4 +1,5 @@
 #include "algorithms.hpp"
+#include "stats.hpp"
 
 #include <algorithm>
 #include <cstdint>
@@ -7,16 +8,6 @@ namespace {
 
 enum class Color : std::uint8_t { White, Gray, Black };
 
-// Цвета и времена открытия/закрытия соответствуют DFS в CLRS и задают дерево предков,
-// а также позволяют классифицировать рёбра при необходимости.
-struct DfsState {
-    std::vector<Color> color;
-    std::vector<int> parent;
-    std::vector<int> discovery;
-    std::vector<int> finish;
-    int time = 0;
-};
-
 bool is_indexed_type(TransportType type) {
     const int value = static_cast<int>(type);
     return value >= 0 && value <= 2;
@@ -26,95 +17,116 @@ std::size_t type_index(TransportType type) {
     return static_cast<std::size_t>(static_cast<int>(type));
 }
 
+// Кадр стека обхода: вершина и следующая непросмотренная дуга ее среза.
+struct Frame {
+    int u;
+    int arc;
+    int arc_end;
+};
+
 // DFS-VISIT(u): на входе u белая; на выходе u черная и все достижимые из u
 // вершины в соответствующем подграфе также черные (CLRS 22.3).
+// Рекурсия заменена явным стеком: коридор из сотен тысяч станций
+// переполнял бы стек вызовов. Времена открытия/закрытия и дерево предков
+// не хранятся — для компонент нужен только цвет.
+// Соседи берутся из CSR-строки: срез одного вида или вся строка Adj[u].
 void dfs_visit(
-    const Graph& g,
-    int u,
+    const FrozenGraph& g,
+    int root,
     TransportType type,
-    DfsState& state,
-    std::vector<int>& component
+    std::vector<Color>& color,
+    std::vector<Frame>& stack,
+    std::vector<int>& component,
+    std::uint64_t& arcs
 ) {
-    if (!valid_vertex(g, u)) {
-        return;
+    const auto open = [&](int u) {
+        color[u] = Color::Gray;
+        component.push_back(u);
+        int arc_begin = g.row_begin(u);
+        int arc_end = g.row_end(u);
+        if (is_indexed_type(type)) {
+            const int mode = static_cast<int>(type_index(type));
+            arc_begin = g.mode_begin(u, mode);
+            arc_end = g.mode_end(u, mode);
+        }
+        stack.push_back(Frame{u, arc_begin, arc_end});
+    };
+
+    open(root);
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (top.arc == top.arc_end) {
+            color[top.u] = Color::Black;
+            stack.pop_back();
+            continue;
+        }
+        const int v = g.to[static_cast<std::size_t>(top.arc)];
+        ++top.arc;
+        if constexpr (kStatsEnabled) {
+            ++arcs;
+        }
+        if (valid_vertex(g, v) && color[v] == Color::White) {
+            open(v); // top может стать недействительной ссылкой
+        }
     }
+}
 
-    state.time += 1;
-    state.discovery[u] = state.time;
-    state.color[u] = Color::Gray;
-    component.push_back(u);
+bool component_before(const std::vector<int>& a, const std::vector<int>& b) {
+    if (a.size() != b.size()) {
+        return a.size() > b.size();
+    }
+    return a < b;
+}
 
-    if (is_indexed_type(type)) {
-        const std::size_t idx = type_index(type);
-        for (int v : g.adjacency[idx][u]) {
-            if (!valid_vertex(g, v)) {
-                continue;
-            }
-            if (state.color[v] == Color::White) {
-                state.parent[v] = u;
-                dfs_visit(g, v, type, state, component);
-            }
-        }
-    } else {
-        for (const Edge& e : g.adj[u]) {
-            const int v = e.to;
-            if (!valid_vertex(g, v)) {
-                continue;
-            }
-            if (state.color[v] == Color::White) {
-                state.parent[v] = u;
-                dfs_visit(g, v, type, state, component);
-            }
+// Компоненты по корням union-find; вершины перебираются по возрастанию,
+// поэтому каждая компонента уже отсортирована.
+std::vector<std::vector<int>> components_from_roots(const std::vector<int>& roots, int n) {
+    std::vector<int> index(static_cast<std::size_t>(n) + 1, -1);
+    std::vector<std::vector<int>> components;
+    for (int v = 1; v <= n; ++v) {
+        const int r = roots[v];
+        if (index[r] == -1) {
+            index[r] = static_cast<int>(components.size());
+            components.emplace_back();
         }
+        components[static_cast<std::size_t>(index[r])].push_back(v);
     }
-
-    state.color[u] = Color::Black;
-    state.time += 1;
-    state.finish[u] = state.time;
+    return components;
 }
 
 } // namespace
 
-std::vector<std::vector<int>> Graph::getConnectedComponents(TransportType type) const {
-    // DFS формирует лес предков; каждая его вершина соответствует компоненте связности.
-    DfsState state;
-    state.color.assign(static_cast<std::size_t>(n) + 1, Color::White);
-    state.parent.assign(static_cast<std::size_t>(n) + 1, -1);
-    state.discovery.assign(static_cast<std::size_t>(n) + 1, 0);
-    state.finish.assign(static_cast<std::size_t>(n) + 1, 0);
-
+std::vector<std::vector<int>> get_connected_components(const FrozenGraph& g, TransportType type, int threads) {
+    const int n = g.n;
     std::vector<std::vector<int>> components;
-    components.reserve(static_cast<std::size_t>(n));
 
-    for (int u = 1; u <= n; ++u) {
-        if (state.color[u] != Color::White) {
-            continue;
-        }
-        std::vector<int> component;
-        dfs_visit(*this, u, type, state, component);
-        if (!component.empty()) {
+    if (threads > 1) {
+        components = components_from_roots(component_roots(g, type, threads), n);
+    } else {
+        // DFS формирует лес; каждое его дерево — компонента связности.
+        std::vector<Color> color(static_cast<std::size_t>(n) + 1, Color::White);
+        std::vector<Frame> stack;
+        std::uint64_t arcs = 0;
+        for (int u = 1; u <= n; ++u) {
+            if (color[u] != Color::White) {
+                continue;
+            }
+            std::vector<int> component;
+            dfs_visit(g, u, type, color, stack, component, arcs);
             std::sort(component.begin(), component.end());
             components.push_back(std::move(component));
         }
+        stats_add(Counter::DfsVertices, static_cast<std::uint64_t>(n));
+        stats_add(Counter::DfsArcs, arcs);
     }
 
-    std::sort(
-        components.begin(),
-        components.end(),
-        [](const std::vector<int>& a, const std::vector<int>& b) {
-            if (a.size() != b.size()) {
-                return a.size() > b.size();
-            }
-            return a < b;
-        }
-    );
-
+    std::sort(components.begin(), components.end(), component_before);
     return components;
 }
 
-std::vector<int> Graph::getIsolatedZones(TransportType type) const {
+std::vector<int> get_isolated_zones(const FrozenGraph& g, TransportType type, int threads) {
     std::vector<int> isolated;
-    const std::vector<std::vector<int>> components = getConnectedComponents(type);
+    const std::vector<std::vector<int>> components = get_connected_components(g, type, threads);
 
     if (components.size() <= 1) {
         return isolated;
@@ -128,6 +140,40 @@ std::vector<int> Graph::getIsolatedZones(TransportType type) const {
     return isolated;
 }
 
+std::vector<int> component_labels(const FrozenGraph& g, TransportType type, int threads) {
+    std::vector<int> labels(static_cast<std::size_t>(g.n) + 1, -1);
+    const std::vector<std::vector<int>> components = get_connected_components(g, type, threads);
+    for (std::size_t c = 0; c < components.size(); ++c) {
+        for (int v : components[c]) {
+            labels[v] = static_cast<int>(c);
+        }
+    }
+    return labels;
+}
+
+std::vector<std::vector<int>> components_from_labels(ArrayView<int> labels, int n) {
+    int count = 0;
+    for (int v = 1; v <= n; ++v) {
+        count = std::max(count, labels[v] + 1);
+    }
+    std::vector<std::vector<int>> components(static_cast<std::size_t>(count));
+    // Вершины перебираются по возрастанию, поэтому каждая компонента уже отсортирована.
+    for (int v = 1; v <= n; ++v) {
+        if (labels[v] >= 0) {
+            components[static_cast<std::size_t>(labels[v])].push_back(v);
+        }
+    }
+    return components;
+}
+
+std::vector<std::vector<int>> Graph::getConnectedComponents(TransportType type) const {
+    return get_connected_components(freeze_graph(*this), type);
+}
+
+std::vector<int> Graph::getIsolatedZones(TransportType type) const {
+    return get_isolated_zones(freeze_graph(*this), type);
+}
+
 std::vector<std::vector<int>> get_connected_components(const Graph& g, TransportType type) {
     return g.getConnectedComponents(type);
 }
@@ -0,0 +1,577 @@
+#include "dynamic_connectivity.hpp"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+constexpr int kTypeCount = 4; // metro, bus, rail, all
+
+std::size_t type_slot(TransportType type) {
+    const int value = static_cast<int>(type);
+    return (value >= 0 && value <= 2) ? static_cast<std::size_t>(value) : 3;
+}
+
+} // namespace
+
+// -------------------- Декартово дерево эйлерова обхода --------------------
+
+int DynamicConnectivity::new_node(int vertex) {
+    int x = 0;
+    if (!free_.empty()) {
+        x = free_.back();
+        free_.pop_back();
+        nodes_[static_cast<std::size_t>(x)] = Node{};
+    } else {
+        x = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    // xorshift32: приоритеты декартова дерева.
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    Node& node = nodes_[static_cast<std::size_t>(x)];
+    node.priority = seed_;
+    node.vertex = vertex;
+    pull(x);
+    return x;
+}
+
+void DynamicConnectivity::free_node(int x) {
+    free_.push_back(x);
+}
+
+void DynamicConnectivity::pull(int x) {
+    Node& node = nodes_[static_cast<std::size_t>(x)];
+    node.count = 1;
+    node.vertices = (node.vertex >= 0) ? 1 : 0;
+    node.min_vertex = (node.vertex >= 0) ? node.vertex : INT_MAX;
+    node.agg = node.own;
+    for (int child : {node.left, node.right}) {
+        if (child >= 0) {
+            const Node& c = nodes_[static_cast<std::size_t>(child)];
+            node.count += c.count;
+            node.vertices += c.vertices;
+            node.min_vertex = std::min(node.min_vertex, c.min_vertex);
+            node.agg |= c.agg;
+        }
+    }
+}
+
+void DynamicConnectivity::update_up(int x) {
+    for (; x >= 0; x = nodes_[static_cast<std::size_t>(x)].parent) {
+        pull(x);
+    }
+}
+
+int DynamicConnectivity::merge(int a, int b) {
+    if (a < 0) {
+        return b;
+    }
+    if (b < 0) {
+        return a;
+    }
+    if (nodes_[static_cast<std::size_t>(a)].priority > nodes_[static_cast<std::size_t>(b)].priority) {
+        const int r = merge(nodes_[static_cast<std::size_t>(a)].right, b);
+        nodes_[static_cast<std::size_t>(a)].right = r;
+        nodes_[static_cast<std::size_t>(r)].parent = a;
+        pull(a);
+        return a;
+    }
+    const int l = merge(a, nodes_[static_cast<std::size_t>(b)].left);
+    nodes_[static_cast<std::size_t>(b)].left = l;
+    nodes_[static_cast<std::size_t>(l)].parent = b;
+    pull(b);
+    return b;
+}
+
+// Первые k узлов обхода — в a, остальные — в b; у корней parent = -1.
+void DynamicConnectivity::split(int t, int k, int& a, int& b) {
+    if (t < 0) {
+        a = b = -1;
+        return;
+    }
+    Node& node = nodes_[static_cast<std::size_t>(t)];
+    const int left_count = (node.left >= 0) ? nodes_[static_cast<std::size_t>(node.left)].count : 0;
+    if (left_count < k) {
+        int rest = -1;
+        split(node.right, k - left_count - 1, rest, b);
+        nodes_[static_cast<std::size_t>(t)].right = rest;
+        if (rest >= 0) {
+            nodes_[static_cast<std::size_t>(rest)].parent = t;
+        }
+        a = t;
+    } else {
+        int rest = -1;
+        split(node.left, k, a, rest);
+        nodes_[static_cast<std::size_t>(t)].left = rest;
+        if (rest >= 0) {
+            nodes_[static_cast<std::size_t>(rest)].parent = t;
+        }
+        b = t;
+    }
+    pull(t);
+    if (a >= 0) {
+        nodes_[static_cast<std::size_t>(a)].parent = -1;
+    }
+    if (b >= 0) {
+        nodes_[static_cast<std::size_t>(b)].parent = -1;
+    }
+}
+
+int DynamicConnectivity::root_of(int x) const {
+    while (nodes_[static_cast<std::size_t>(x)].parent >= 0) {
+        x = nodes_[static_cast<std::size_t>(x)].parent;
+    }
+    return x;
+}
+
+// Позиция узла в обходе (число узлов перед ним).
+int DynamicConnectivity::index_of(int x) const {
+    const Node* node = &nodes_[static_cast<std::size_t>(x)];
+    int index = (node->left >= 0) ? nodes_[static_cast<std::size_t>(node->left)].count : 0;
+    while (node->parent >= 0) {
+        const int p = node->parent;
+        const Node& parent = nodes_[static_cast<std::size_t>(p)];
+        if (parent.right == x) {
+            index += 1 + ((parent.left >= 0) ? nodes_[static_cast<std::size_t>(parent.left)].count : 0);
+        }
+        x = p;
+        node = &parent;
+    }
+    return index;
+}
+
+// Циклический сдвиг обхода так, чтобы он начинался с узла x; возвращает корень.
+int DynamicConnectivity::reroot(int x) {
+    int a = -1;
+    int b = -1;
+    split(root_of(x), index_of(x), a, b);
+    return merge(b, a);
+}
+
+// Узел поддерева root с флагом в own (агрегат root должен его содержать).
+int DynamicConnectivity::find_flagged(int root, unsigned char flag) const {
+    int x = root;
+    for (;;) {
+        const Node& node = nodes_[static_cast<std::size_t>(x)];
+        if (node.own & flag) {
+            return x;
+        }
+        if (node.left >= 0 && (nodes_[static_cast<std::size_t>(node.left)].agg & flag)) {
+            x = node.left;
+        } else {
+            x = node.right;
+        }
+    }
+}
+
+// -------------------- Уровни и списки рёбер --------------------
+
+void DynamicConnectivity::reset(int n) {
+    nodes_.clear();
+    free_.clear();
+    vertex0_.assign(static_cast<std::size_t>(n) + 1, -1);
+    vertex_upper_.clear();
+    tree_lists_.clear();
+    nontree_lists_.clear();
+    edges_.clear();
+    zones_.clear();
+    singletons_.assign(static_cast<std::size_t>(n) / 64 + 1, 0);
+    singleton_count_ = 0;
+
+    ensure_level(0);
+    nodes_.reserve(static_cast<std::size_t>(n));
+    for (int v = 1; v <= n; ++v) {
+        vertex0_[v] = new_node(v);
+        singletons_[static_cast<std::size_t>(v) / 64] |= std::uint64_t{1} << (v % 64);
+    }
+    singleton_count_ = n;
+}
+
+void DynamicConnectivity::ensure_level(int level) {
+    while (static_cast<int>(tree_lists_.size()) <= level) {
+        tree_lists_.emplace_back();
+        nontree_lists_.emplace_back();
+        if (tree_lists_.size() > 1) {
+            vertex_upper_.emplace_back();
+        }
+    }
+}
+
+int DynamicConnectivity::vertex_node(int level, int x) const {
+    if (level == 0) {
+        return vertex0_[static_cast<std::size_t>(x)];
+    }
+    const std::unordered_map<int, int>& upper = vertex_upper_[static_cast<std::size_t>(level) - 1];
+    const auto it = upper.find(x);
+    return (it == upper.end()) ? -1 : it->second;
+}
+
+int DynamicConnectivity::ensure_vertex_node(int level, int x) {
+    ensure_level(level);
+    if (level == 0) {
+        return vertex0_[static_cast<std::size_t>(x)];
+    }
+    std::unordered_map<int, int>& upper = vertex_upper_[static_cast<std::size_t>(level) - 1];
+    const auto it = upper.find(x);
+    if (it != upper.end()) {
+        return it->second;
+    }
+    const int node = new_node(x);
+    upper.emplace(x, node);
+    return node;
+}
+
+DynamicConnectivity::IncidentLists& DynamicConnectivity::lists(bool tree, int level) {
+    return tree ? tree_lists_[static_cast<std::size_t>(level)] : nontree_lists_[static_cast<std::size_t>(level)];
+}
+
+// Флаги вершины x на уровне level — по непустоте ее списков.
+void DynamicConnectivity::refresh_own(int level, int x) {
+    const int node = ensure_vertex_node(level, x);
+    unsigned char own = 0;
+    const auto has = [x](const IncidentLists& l) {
+        const auto it = l.find(x);
+        return it != l.end() && !it->second.empty();
+    };
+    if (has(tree_lists_[static_cast<std::size_t>(level)])) {
+        own |= kTreeFlag;
+    }
+    if (has(nontree_lists_[static_cast<std::size_t>(level)])) {
+        own |= kNonTreeFlag;
+    }
+    if (nodes_[static_cast<std::size_t>(node)].own != own) {
+        nodes_[static_cast<std::size_t>(node)].own = own;
+        update_up(node);
+    }
+}
+
+// Добавить ребро id в списки его концов (уровень и вид — из записи).
+void DynamicConnectivity::list_add(int id) {
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    ensure_level(e.level);
+    IncidentLists& l = lists(e.tree, e.level);
+    std::vector<int>& lu = l[e.u];
+    e.pos_u = static_cast<int>(lu.size());
+    lu.push_back(id);
+    std::vector<int>& lv = l[e.v];
+    e.pos_v = static_cast<int>(lv.size());
+    lv.push_back(id);
+    refresh_own(e.level, e.u);
+    refresh_own(e.level, e.v);
+}
+
+void DynamicConnectivity::list_remove(int id) {
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    IncidentLists& l = lists(e.tree, e.level);
+    for (int side = 0; side < 2; ++side) {
+        const int x = (side == 0) ? e.u : e.v;
+        const int pos = (side == 0) ? e.pos_u : e.pos_v;
+        std::vector<int>& row = l[x];
+        const int moved = row.back();
+        row[static_cast<std::size_t>(pos)] = moved;
+        row.pop_back();
+        if (moved != id) {
+            EdgeRecord& m = edges_[static_cast<std::size_t>(moved)];
+            (m.u == x ? m.pos_u : m.pos_v) = pos;
+        }
+        if (row.empty()) {
+            l.erase(x);
+        }
+    }
+    e.pos_u = e.pos_v = -1;
+    refresh_own(e.level, e.u);
+    refresh_own(e.level, e.v);
+}
+
+// -------------------- Связывание и разрез F_i --------------------
+
+void DynamicConnectivity::link(int level, int id) {
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    const int nu = ensure_vertex_node(level, e.u);
+    const int nv = ensure_vertex_node(level, e.v);
+    if (level == 0) {
+        zone_remove(root_of(nu));
+        zone_remove(root_of(nv));
+    }
+    const int tu = reroot(nu);
+    const int tv = reroot(nv);
+    const int a1 = new_node(-1);
+    const int a2 = new_node(-1);
+    if (static_cast<int>(e.arcs.size()) <= level) {
+        e.arcs.resize(static_cast<std::size_t>(level) + 1, {-1, -1});
+    }
+    e.arcs[static_cast<std::size_t>(level)] = {a1, a2};
+    const int root = merge(merge(merge(tu, a1), tv), a2);
+    if (level == 0) {
+        zone_add(root);
+    }
+}
+
+void DynamicConnectivity::cut(int level, int id) {
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    int a1 = e.arcs[static_cast<std::size_t>(level)].first;
+    int a2 = e.arcs[static_cast<std::size_t>(level)].second;
+    const int root = root_of(a1);
+    if (level == 0) {
+        zone_remove(root);
+    }
+    int i1 = index_of(a1);
+    int i2 = index_of(a2);
+    if (i1 > i2) {
+        std::swap(a1, a2);
+        std::swap(i1, i2);
+    }
+    // A a1 B a2 C  ->  A C и B.
+    int before = -1;
+    int rest = -1;
+    split(root, i1, before, rest);
+    int arc = -1;
+    int middle = -1;
+    split(rest, 1, arc, rest);
+    split(rest, i2 - i1 - 1, middle, rest);
+    split(rest, 1, arc, rest);
+    const int outer = merge(before, rest);
+    free_node(a1);
+    free_node(a2);
+    e.arcs[static_cast<std::size_t>(level)] = {-1, -1};
+    if (level == 0) {
+        zone_add(outer);
+        zone_add(middle);
+    }
+}
+
+// Шаг DELETE на уровне level после разреза древесного ребра id.
+bool DynamicConnectivity::find_replacement(int level, int id) {
+    const EdgeRecord& removed = edges_[static_cast<std::size_t>(id)];
+    const int ru = root_of(vertex_node(level, removed.u));
+    const int rv = root_of(vertex_node(level, removed.v));
+    const int small = (nodes_[static_cast<std::size_t>(ru)].vertices <= nodes_[static_cast<std::size_t>(rv)].vertices)
+        ? ru : rv;
+
+    // Древесные рёбра уровня level меньшего дерева поднимаются на level + 1:
+    // дерево содержит не больше половины вершин, инвариант сохраняется.
+    int root = small;
+    while (nodes_[static_cast<std::size_t>(root)].agg & kTreeFlag) {
+        const int x = nodes_[static_cast<std::size_t>(find_flagged(root, kTreeFlag))].vertex;
+        const int t = tree_lists_[static_cast<std::size_t>(level)][x].back();
+        list_remove(t);
+        edges_[static_cast<std::size_t>(t)].level = level + 1;
+        list_add(t);
+        link(level + 1, t);
+        root = root_of(vertex_node(level, x));
+    }
+
+    // Недревесные рёбра уровня level из меньшего дерева: замена или подъем.
+    while (nodes_[static_cast<std::size_t>(root)].agg & kNonTreeFlag) {
+        const int x = nodes_[static_cast<std::size_t>(find_flagged(root, kNonTreeFlag))].vertex;
+        const int f = nontree_lists_[static_cast<std::size_t>(level)][x].back();
+        EdgeRecord& e = edges_[static_cast<std::size_t>(f)];
+        const int y = (e.u == x) ? e.v : e.u;
+        list_remove(f);
+        if (root_of(vertex_node(level, y)) != root) {
+            e.tree = true;
+            list_add(f);
+            for (int i = 0; i <= level; ++i) {
+                link(i, f);
+            }
+            return true;
+        }
+        e.level = level + 1;
+        list_add(f);
+        root = root_of(vertex_node(level, x));
+    }
+    return false;
+}
+
+// -------------------- Операции --------------------
+
+void DynamicConnectivity::insert(int id, int u, int v) {
+    if (static_cast<int>(edges_.size()) <= id) {
+        edges_.resize(static_cast<std::size_t>(id) + 1);
+    }
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    e = EdgeRecord{};
+    e.u = u;
+    e.v = v;
+    e.live = true;
+    if (u == v) {
+        return;
+    }
+    e.tree = !connected(u, v);
+    list_add(id);
+    if (e.tree) {
+        link(0, id);
+    }
+}
+
+bool DynamicConnectivity::erase(int id) {
+    if (id < 0 || id >= static_cast<int>(edges_.size()) || !edges_[static_cast<std::size_t>(id)].live) {
+        return false;
+    }
+    EdgeRecord& e = edges_[static_cast<std::size_t>(id)];
+    e.live = false;
+    if (e.u == e.v) {
+        return true;
+    }
+    list_remove(id);
+    if (!e.tree) {
+        return true;
+    }
+    const int level = e.level;
+    for (int i = 0; i <= level; ++i) {
+        cut(i, id);
+    }
+    for (int i = level; i >= 0; --i) {
+        if (find_replacement(i, id)) {
+            break;
+        }
+    }
+    e.arcs.clear();
+    return true;
+}
+
+bool DynamicConnectivity::connected(int u, int v) const {
+    return root_of(vertex0_[static_cast<std::size_t>(u)]) == root_of(vertex0_[static_cast<std::size_t>(v)]);
+}
+
+int DynamicConnectivity::component_count() const {
+    return static_cast<int>(zones_.size()) + singleton_count_;
+}
+
+int DynamicConnectivity::component_size(int v) const {
+    return nodes_[static_cast<std::size_t>(root_of(vertex0_[static_cast<std::size_t>(v)]))].vertices;
+}
+
+// -------------------- Зоны --------------------
+
+void DynamicConnectivity::zone_remove(int root) {
+    const Node& node = nodes_[static_cast<std::size_t>(root)];
+    if (node.vertices >= 2) {
+        zones_.erase({-node.vertices, node.min_vertex});
+    } else if (node.vertices == 1) {
+        singletons_[static_cast<std::size_t>(node.min_vertex) / 64] &= ~(std::uint64_t{1} << (node.min_vertex % 64));
+        --singleton_count_;
+    }
+}
+
+void DynamicConnectivity::zone_add(int root) {
+    const Node& node = nodes_[static_cast<std::size_t>(root)];
+    if (node.vertices >= 2) {
+        zones_.insert({-node.vertices, node.min_vertex});
+    } else if (node.vertices == 1) {
+        singletons_[static_cast<std::size_t>(node.min_vertex) / 64] |= std::uint64_t{1} << (node.min_vertex % 64);
+        ++singleton_count_;
+    }
+}
+
+// Вершины дерева root по возрастанию.
+void DynamicConnectivity::collect(int root, std::vector<int>& out) const {
+    const std::size_t first = out.size();
+    std::vector<int> stack{root};
+    while (!stack.empty()) {
+        const Node& node = nodes_[static_cast<std::size_t>(stack.back())];
+        stack.pop_back();
+        if (node.vertex >= 0) {
+            out.push_back(node.vertex);
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+        }
+        if (node.right >= 0) {
+            stack.push_back(node.right);
+        }
+    }
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+}
+
+std::vector<std::vector<int>> DynamicConnectivity::components() const {
+    std::vector<std::vector<int>> out;
+    out.reserve(static_cast<std::size_t>(component_count()));
+    for (const std::pair<int, int>& zone : zones_) {
+        out.emplace_back();
+        collect(root_of(vertex0_[static_cast<std::size_t>(zone.second)]), out.back());
+    }
+    for (std::size_t w = 0; w < singletons_.size(); ++w) {
+        for (std::uint64_t bits = singletons_[w]; bits != 0; bits &= bits - 1) {
+            out.push_back({static_cast<int>(w * 64) + __builtin_ctzll(bits)});
+        }
+    }
+    return out;
+}
+
+std::vector<int> DynamicConnectivity::isolated() const {
+    std::vector<int> out;
+    bool skip = true; // первая по порядку зона — крупнейшая
+    for (const std::pair<int, int>& zone : zones_) {
+        if (skip) {
+            skip = false;
+            continue;
+        }
+        collect(root_of(vertex0_[static_cast<std::size_t>(zone.second)]), out);
+    }
+    for (std::size_t w = 0; w < singletons_.size(); ++w) {
+        for (std::uint64_t bits = singletons_[w]; bits != 0; bits &= bits - 1) {
+            if (skip) {
+                skip = false;
+                continue;
+            }
+            out.push_back(static_cast<int>(w * 64) + __builtin_ctzll(bits));
+        }
+    }
+    return out;
+}
+
+// -------------------- DynamicGraph --------------------
+
+void dynamic_graph_init(DynamicGraph& dg, const Graph& g) {
+    dg.g = g;
+    for (DynamicConnectivity& zones : dg.zones) {
+        zones.reset(g.n);
+    }
+
+    // id из входа остаются ключами закрытия перегонов.
+    dg.ends.assign(static_cast<std::size_t>(g.next_id), DynamicGraph::EdgeEnds{});
+    for (int u = 1; u <= g.n; ++u) {
+        for (const Edge& e : g.adj[u]) {
+            DynamicGraph::EdgeEnds& ends = dg.ends[static_cast<std::size_t>(e.id)];
+            if (ends.mode >= 0) {
+                continue; // вторая сторона ребра
+            }
+            ends = DynamicGraph::EdgeEnds{u, e.to, e.mode};
+            dg.zones[static_cast<std::size_t>(e.mode)].insert(e.id, u, e.to);
+            dg.zones[kTypeCount - 1].insert(e.id, u, e.to);
+        }
+    }
+}
+
+int dynamic_graph_add(DynamicGraph& dg, int u, int v, int mode, double base_time, double load) {
+    graph_add_undirected(dg.g, u, v, mode, base_time, load);
+    const int id = dg.g.next_id - 1;
+    dg.ends.resize(static_cast<std::size_t>(dg.g.next_id));
+    dg.ends[static_cast<std::size_t>(id)] = DynamicGraph::EdgeEnds{u, v, mode};
+    dg.zones[static_cast<std::size_t>(mode)].insert(id, u, v);
+    dg.zones[kTypeCount - 1].insert(id, u, v);
+    return id;
+}
+
+bool dynamic_graph_remove(DynamicGraph& dg, int id) {
+    if (id < 0 || id >= static_cast<int>(dg.ends.size()) || dg.ends[static_cast<std::size_t>(id)].mode < 0) {
+        return false;
+    }
+    DynamicGraph::EdgeEnds& e = dg.ends[static_cast<std::size_t>(id)];
+    graph_remove_undirected(dg.g, id);
+    dg.zones[static_cast<std::size_t>(e.mode)].erase(id);
+    dg.zones[kTypeCount - 1].erase(id);
+    e.mode = -1;
+    return true;
+}
+
+std::vector<std::vector<int>> dynamic_connected_components(const DynamicGraph& dg, TransportType type) {
+    return dg.zones[type_slot(type)].components();
+}
+
+std::vector<int> dynamic_isolated_zones(const DynamicGraph& dg, TransportType type) {
+    return dg.zones[type_slot(type)].isolated();
+}
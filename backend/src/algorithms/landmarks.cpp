@@ -0,0 +1,301 @@
+#include "landmarks.hpp"
+#include "path_cost.hpp"
+#include "stamped_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kModeCount = 4;
+constexpr int kNoMode = 3;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+int state_of(int v, int mode) {
+    return kModeCount * v + mode;
+}
+
+// Дейкстра по станциям с весом base_time (все виды транспорта, без штрафов).
+void base_distances(const FrozenGraph& g, int source, std::vector<double>& dist) {
+    using Item = std::pair<double, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+
+    dist.assign(static_cast<std::size_t>(g.n) + 1, kInf);
+    dist[source] = 0.0;
+    q.push({0.0, source});
+    while (!q.empty()) {
+        const Item it = q.top();
+        q.pop();
+        const int u = it.second;
+        if (it.first > dist[u]) {
+            continue;
+        }
+        for (int a = g.row_begin(u); a < g.row_end(u); ++a) {
+            const int v = g.to[static_cast<std::size_t>(a)];
+            const double d = dist[u] + g.base_time[static_cast<std::size_t>(a)];
+            if (d < dist[v]) {
+                dist[v] = d;
+                q.push({d, v});
+            }
+        }
+    }
+}
+
+struct QueueItem {
+    double key;     // время + h(v)
+    PathCost cost;  // (время, пересадки) состояния
+    int state;
+};
+
+// Ключ A* — (время + h, пересадки), как (время, пересадки) у Дейкстры.
+struct QueueGreater {
+    bool operator()(const QueueItem& a, const QueueItem& b) const {
+        if (a.key != b.key) {
+            return a.key > b.key;
+        }
+        return a.cost.transfers > b.cost.transfers;
+    }
+};
+
+// Состояние A*: оценки и предки по состояниям, h — по вершинам.
+struct AltWorkspace {
+    StampedTable<PathCost> dist;    // по состояниям 4 * v + mode
+    StampedTable<int> parent;       // предыдущее состояние пути
+    StampedTable<double> h;         // оценка по вершинам; NaN — не вычислена
+    StampedTable<char> target_flag; // 0 — не цель, 1 — цель, 2 — цель достигнута
+
+    void begin(int n) {
+        const std::size_t size = static_cast<std::size_t>(n) + 1;
+        dist.begin(kModeCount * size, PathCost{});
+        parent.begin(kModeCount * size, -1);
+        h.begin(size, std::numeric_limits<double>::quiet_NaN());
+        target_flag.begin(size, 0);
+    }
+};
+
+// h(v) = min по целям landmark_bound(v, t); считается при первом обращении.
+double heuristic(const Landmarks& lm, AltWorkspace& ws, const std::vector<int>& targets, int v) {
+    if (!std::isnan(ws.h[v])) {
+        return ws.h[v];
+    }
+    double best = kInf;
+    for (int t : targets) {
+        best = std::min(best, landmark_bound(lm, v, t));
+    }
+    ws.h.touch(v) = best;
+    return best;
+}
+
+Route unreachable_route(int target) {
+    Route route;
+    route.target = target;
+    route.time = PathCost{}.time;
+    route.transfers = PathCost{}.transfers;
+    route.metric = PathCost{}.time;
+    return route;
+}
+
+} // namespace
+
+Landmarks build_landmarks(const FrozenGraph& g, int count) {
+    Landmarks lm;
+    lm.n = g.n;
+    lm.version = g.version;
+    count = std::max(0, std::min(count, g.n));
+    if (count == 0) {
+        return lm;
+    }
+
+    // near[v] — расстояние до ближайшего выбранного ориентира; первый
+    // ориентир — самая дальняя станция от станции 1. Бесконечность (другая
+    // компонента) считается дальше любого конечного расстояния, поэтому
+    // каждая компонента получает ориентир, пока их хватает. Станции без
+    // рёбер ориентирами не выбираются: от них расстояний нет.
+    std::vector<double> near;
+    base_distances(g, 1, near);
+    near[0] = -kInf;
+
+    std::vector<std::vector<double>> rows;
+    for (int i = 0; i < count; ++i) {
+        int pick = -1;
+        for (int v = 1; v <= g.n; ++v) {
+            if (g.row_begin(v) == g.row_end(v)) {
+                continue;
+            }
+            if (pick == -1 || near[v] > near[pick]) {
+                pick = v;
+            }
+        }
+        if (pick == -1 || near[pick] == 0.0) {
+            break; // все станции с рёбрами уже ориентиры
+        }
+        lm.nodes.push_back(pick);
+        rows.emplace_back();
+        base_distances(g, pick, rows.back());
+        for (int v = 1; v <= g.n; ++v) {
+            near[v] = std::min(near[v], rows.back()[v]);
+        }
+        near[pick] = 0.0;
+    }
+
+    // Строка вершины непрерывна: оценка h(v) читает подряд идущие числа.
+    const std::size_t k = lm.nodes.size();
+    lm.dist.assign((static_cast<std::size_t>(g.n) + 1) * k, kInf);
+    for (std::size_t i = 0; i < k; ++i) {
+        for (int v = 0; v <= g.n; ++v) {
+            lm.dist[static_cast<std::size_t>(v) * k + i] = rows[i][v];
+        }
+    }
+    return lm;
+}
+
+double landmark_bound(const Landmarks& lm, int v, int t) {
+    const std::size_t k = lm.nodes.size();
+    const double* dv = lm.dist.data() + static_cast<std::size_t>(v) * k;
+    const double* dt = lm.dist.data() + static_cast<std::size_t>(t) * k;
+    double best = 0.0;
+    for (std::size_t i = 0; i < k; ++i) {
+        if (dv[i] == dt[i]) {
+            continue; // в том числе обе бесконечны: ориентир в другой компоненте
+        }
+        if (!std::isfinite(dv[i]) || !std::isfinite(dt[i])) {
+            return kInf;
+        }
+        // Расстояния d_L посчитаны в double; разность уменьшается на
+        // относительный допуск, чтобы ошибка округления не сделала оценку
+        // больше истинного расстояния.
+        const double gap = std::fabs(dv[i] - dt[i]) - kTimeEpsilon * std::max(dv[i], dt[i]);
+        best = std::max(best, gap);
+    }
+    return best;
+}
+
+std::vector<Route> solve_request_alt(
+    const Landmarks& lm,
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    std::size_t* settled
+) {
+    thread_local AltWorkspace ws;
+    ws.begin(g.n);
+
+    // Цели, до которых нужен поиск: корректные и отличные от start.
+    std::vector<int> targets;
+    for (int t : rq.targets) {
+        if (valid_vertex(g, t) && t != rq.start && ws.target_flag[t] == 0) {
+            ws.target_flag.touch(t) = 1;
+            targets.push_back(t);
+        }
+    }
+
+    std::priority_queue<QueueItem, std::vector<QueueItem>, QueueGreater> q;
+    const auto relax = [&](int v, int mode, const PathCost& c, int parent) {
+        const int x = state_of(v, mode);
+        if (!path_cost_less(c, ws.dist[x])) {
+            return;
+        }
+        const double h = heuristic(lm, ws, targets, v);
+        if (h == kInf) {
+            return; // ни одна цель из v недостижима
+        }
+        ws.dist.touch(x) = c;
+        ws.parent.touch(x) = parent;
+        q.push(QueueItem{c.time + h, c, x});
+    };
+
+    int pending = static_cast<int>(targets.size());
+    if (pending > 0 && valid_vertex(g, rq.start)) {
+        relax(rq.start, kNoMode, PathCost{0.0, 0}, -1);
+    }
+
+    // Останов как у ограниченного целями Дейкстры: все цели извлечены и
+    // ключ вершины кучи строго больше ключа последней из них (у цели h = 0,
+    // ее ключ — время). Оценка допустима, поэтому любой путь через
+    // оставшиеся в очереди состояния не лучше.
+    double bound_time = -kInf;
+    int bound_transfers = 0;
+    std::size_t pops = 0;
+    while (!q.empty()) {
+        const QueueItem it = q.top();
+        q.pop();
+        if (path_cost_less(ws.dist[it.state], it.cost)) {
+            continue; // устаревшая запись
+        }
+        if (pending == 0 && (bound_time < it.key || (bound_time == it.key && bound_transfers < it.cost.transfers))) {
+            break;
+        }
+        ++pops;
+
+        const int u = it.state / kModeCount;
+        const int a = it.state % kModeCount;
+        if (a != kNoMode && ws.target_flag[u] == 1) {
+            ws.target_flag.touch(u) = 2;
+            --pending;
+            bound_time = it.key;
+            bound_transfers = it.cost.transfers;
+        }
+
+        for (int b = 0; b < 3; ++b) {
+            double penalty = 0.0;
+            int add_transfer = 0;
+            if (a != kNoMode && a != b) {
+                penalty = model.trans[a][b] + model.station_transfer[u];
+                add_transfer = 1;
+            }
+            for (int arc = g.mode_begin(u, b); arc < g.mode_end(u, b); ++arc) {
+                const int v = g.to[static_cast<std::size_t>(arc)];
+                const double w = arc_time(g, arc, b, model.sensitivity) + penalty;
+                relax(v, b, path_cost_add(it.cost, w, add_transfer), it.state);
+            }
+        }
+    }
+    if (settled != nullptr) {
+        *settled += pops;
+    }
+
+    std::vector<Route> routes;
+    routes.reserve(rq.targets.size());
+    for (int target : rq.targets) {
+        if (target == rq.start) {
+            Route route;
+            route.target = target;
+            route.reachable = true;
+            routes.push_back(route);
+            continue;
+        }
+        int best = -1;
+        if (valid_vertex(g, target)) {
+            for (int m = 0; m < 3; ++m) {
+                const int x = state_of(target, m);
+                if (reachable(ws.dist[x]) && (best == -1 || path_cost_less(ws.dist[x], ws.dist[best]))) {
+                    best = x;
+                }
+            }
+        }
+        if (best == -1) {
+            routes.push_back(unreachable_route(target));
+            continue;
+        }
+
+        Route route;
+        route.target = target;
+        route.reachable = true;
+        for (int x = best; ws.parent[x] != -1; x = ws.parent[x]) {
+            route.steps.push_back(Step{ws.parent[x] / kModeCount, x / kModeCount, x % kModeCount});
+        }
+        std::reverse(route.steps.begin(), route.steps.end());
+        evaluate_route(g, model, route, rq.k);
+        routes.push_back(route);
+    }
+
+    if (!routes.empty()) {
+        quicksort_routes(routes, 0, static_cast<int>(routes.size()) - 1);
+    }
+    return routes;
+}
@@ -0,0 +1,82 @@
+#include "matrix.hpp"
+
+#include "batch.hpp"
+#include "contraction.hpp"
+
+#include <limits>
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Строка матрицы по ограниченной Дейкстре: лучшее по (время, пересадки)
+// состояние каждой цели, как в build_route_to_target.
+void dijkstra_row(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int source,
+    const std::vector<int>& targets,
+    const SearchOptions& options,
+    double* time,
+    int* transfers
+) {
+    thread_local SearchWorkspace ws;
+    dijkstra_states(g, model, source, targets, ws, options);
+    for (std::size_t j = 0; j < targets.size(); ++j) {
+        const int t = targets[j];
+        time[j] = kInf;
+        transfers[j] = -1;
+        if (!valid_vertex(g, source) || !valid_vertex(g, t)) {
+            continue;
+        }
+        if (t == source) {
+            time[j] = 0.0;
+            transfers[j] = 0;
+            continue;
+        }
+        for (int m = 0; m < 3; ++m) {
+            const double tm = ws.time(t, m);
+            const int tr = ws.transfers(t, m);
+            if (tm < time[j] || (tm == time[j] && tr < transfers[j])) {
+                time[j] = tm;
+                transfers[j] = tr;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TravelMatrix travel_time_matrix(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const std::vector<int>& sources,
+    const std::vector<int>& targets,
+    const SearchOptions& options,
+    int threads
+) {
+    TravelMatrix matrix;
+    matrix.sources = sources;
+    matrix.targets = targets;
+    matrix.time.assign(sources.size() * targets.size(), kInf);
+    matrix.transfers.assign(sources.size() * targets.size(), -1);
+    if (sources.empty() || targets.empty()) {
+        return matrix;
+    }
+
+    const std::size_t width = targets.size();
+    if (options.hierarchy != nullptr && options.hierarchy->version == g.version) {
+        const ContractionHierarchy& ch = *options.hierarchy;
+        const ChBuckets buckets = build_ch_buckets(ch, g, targets);
+        parallel_for(sources.size(), threads, [&](std::size_t i) {
+            ch_bucket_row(ch, g, model, buckets, sources[i], targets, &matrix.time[i * width],
+                          &matrix.transfers[i * width]);
+        });
+        return matrix;
+    }
+
+    parallel_for(sources.size(), threads, [&](std::size_t i) {
+        dijkstra_row(g, model, sources[i], targets, options, &matrix.time[i * width], &matrix.transfers[i * width]);
+    });
+    return matrix;
+}
@@ -0,0 +1,259 @@
+#include "pareto.hpp"
+#include "stamped_table.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace {
+
+constexpr int kModeCount = 4;
+constexpr int kNoMode = 3;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr int kNoTransfers = std::numeric_limits<int>::max();
+
+// Метка в очереди: еще не извлечена и может оказаться доминированной.
+struct Candidate {
+    double time;
+    int transfers;
+    int v;
+    int mode;
+    int parent; // извлеченная метка-предок
+};
+
+struct CandidateGreater {
+    bool operator()(const Candidate& a, const Candidate& b) const {
+        if (a.time != b.time) {
+            return a.time > b.time;
+        }
+        return a.transfers > b.transfers;
+    }
+};
+
+Route unreachable_route(int target) {
+    Route route;
+    route.target = target;
+    route.time = kInf;
+    route.transfers = std::numeric_limits<int>::max() / 4;
+    route.metric = kInf;
+    return route;
+}
+
+// (metric, time, transfers) лексикографически.
+bool better_for_k(const ParetoLabel& a, const ParetoLabel& b, double k) {
+    const double ma = a.time + k * static_cast<double>(a.transfers);
+    const double mb = b.time + k * static_cast<double>(b.transfers);
+    if (ma != mb) {
+        return ma < mb;
+    }
+    if (a.time != b.time) {
+        return a.time < b.time;
+    }
+    return a.transfers < b.transfers;
+}
+
+} // namespace
+
+ParetoResult pareto_search(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    const ParetoOptions& options
+) {
+    ParetoResult result;
+    result.start = start;
+    result.head.assign(static_cast<std::size_t>(g.n) + 1, -1);
+    if (!valid_vertex(g, start)) {
+        return result;
+    }
+
+    // Метки извлекаются по времени, поэтому новая метка состояния не
+    // доминирована, только если у нее меньше пересадок, чем у прежних.
+    const std::size_t size = static_cast<std::size_t>(g.n) + 1;
+    thread_local StampedTable<int> min_transfers; // по состояниям 4 * v + mode
+    thread_local StampedTable<int> target_slot;   // номер цели в списке или -1
+    min_transfers.begin(kModeCount * size, kNoTransfers);
+    target_slot.begin(size, -1);
+
+    // Цели, до которых нужен поиск: корректные и отличные от start.
+    std::vector<int> open_targets;
+    for (int t : targets) {
+        if (valid_vertex(g, t) && t != start && target_slot[t] == -1) {
+            target_slot.touch(t) = static_cast<int>(open_targets.size());
+            open_targets.push_back(t);
+        }
+    }
+    const bool bounded = !targets.empty();
+    const std::size_t ks = options.ks.size();
+    std::vector<double> best(open_targets.size() * ks, kInf); // лучшая метрика цели при ks[j]
+    std::vector<double> limit(open_targets.size(), kInf);     // max_j best цели
+    std::vector<char> closed(open_targets.size(), 0);
+    int open = static_cast<int>(open_targets.size());
+    double stop_time = kInf; // max limit по открытым целям
+
+    std::priority_queue<Candidate, std::vector<Candidate>, CandidateGreater> q;
+    q.push(Candidate{0.0, 0, start, kNoMode, -1});
+
+    Candidate c{};
+    while (!q.empty()) {
+        if (bounded && !result.labels.empty() && (open == 0 || (ks > 0 && q.top().time > stop_time))) {
+            break;
+        }
+        c = q.top();
+        q.pop();
+
+        const int s = kModeCount * c.v + c.mode;
+        if (c.transfers >= min_transfers[static_cast<std::size_t>(s)]) {
+            continue; // доминирована меткой, извлеченной раньше
+        }
+        min_transfers.touch(static_cast<std::size_t>(s)) = c.transfers;
+
+        const int x = static_cast<int>(result.labels.size());
+        result.labels.push_back(ParetoLabel{c.time, c.transfers, c.v, c.mode, c.parent, result.head[c.v]});
+        result.head[c.v] = x;
+
+        const int slot = c.mode == kNoMode ? -1 : target_slot[c.v];
+        if (slot >= 0 && closed[slot] == 0) {
+            const std::size_t i = static_cast<std::size_t>(slot);
+            double worst = -kInf;
+            for (std::size_t j = 0; j < ks; ++j) {
+                double& b = best[i * ks + j];
+                b = std::min(b, c.time + options.ks[j] * static_cast<double>(c.transfers));
+                worst = std::max(worst, b);
+            }
+            limit[i] = worst;
+            if (c.transfers == 0) {
+                closed[i] = 1;
+                --open;
+            }
+            stop_time = -kInf;
+            for (std::size_t t = 0; t < open_targets.size(); ++t) {
+                if (closed[t] == 0) {
+                    stop_time = std::max(stop_time, limit[t]);
+                }
+            }
+        }
+
+        for (int mode_v = 0; mode_v < 3; ++mode_v) {
+            double penalty = 0.0;
+            int add_transfer = 0;
+            if (c.mode != kNoMode && c.mode != mode_v) {
+                penalty = model.trans[c.mode][mode_v] + model.station_transfer[c.v];
+                add_transfer = 1;
+            }
+            const int new_transfers = c.transfers + add_transfer;
+            if (new_transfers > options.max_transfers) {
+                continue;
+            }
+            const int arc_end = g.mode_end(c.v, mode_v);
+            for (int a = g.mode_begin(c.v, mode_v); a < arc_end; ++a) {
+                const int v = g.to[static_cast<std::size_t>(a)];
+                if (new_transfers >= min_transfers[static_cast<std::size_t>(kModeCount * v + mode_v)]) {
+                    continue;
+                }
+                const double w = arc_time(g, a, mode_v, model.sensitivity) + penalty;
+                q.push(Candidate{c.time + w, new_transfers, v, mode_v, x});
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<ParetoLabel> pareto_front(const ParetoResult& result, int target) {
+    std::vector<ParetoLabel> front;
+    if (target < 0 || target >= static_cast<int>(result.head.size())) {
+        return front;
+    }
+    if (target == result.start) {
+        if (!result.labels.empty()) {
+            front.push_back(result.labels[0]);
+        }
+        return front;
+    }
+    for (int x = result.head[target]; x != -1; x = result.labels[static_cast<std::size_t>(x)].next) {
+        front.push_back(result.labels[static_cast<std::size_t>(x)]);
+    }
+    std::sort(front.begin(), front.end(), [](const ParetoLabel& a, const ParetoLabel& b) {
+        return a.time != b.time ? a.time < b.time : a.transfers < b.transfers;
+    });
+    // Фронты видов сливаются: остаются метки, не доминированные ни одной.
+    std::size_t kept = 0;
+    for (const ParetoLabel& label : front) {
+        if (kept == 0 || label.transfers < front[kept - 1].transfers) {
+            front[kept++] = label;
+        }
+    }
+    front.resize(kept);
+    return front;
+}
+
+Route pareto_route(const ParetoResult& result, int target, double k) {
+    if (target == result.start && !result.labels.empty()) {
+        Route route;
+        route.target = target;
+        route.reachable = true;
+        return route;
+    }
+    if (target < 0 || target >= static_cast<int>(result.head.size())) {
+        return unreachable_route(target);
+    }
+    int best = -1;
+    for (int x = result.head[target]; x != -1; x = result.labels[static_cast<std::size_t>(x)].next) {
+        if (best == -1 || better_for_k(result.labels[static_cast<std::size_t>(x)],
+                                       result.labels[static_cast<std::size_t>(best)], k)) {
+            best = x;
+        }
+    }
+    if (best == -1) {
+        return unreachable_route(target);
+    }
+
+    const ParetoLabel& last = result.labels[static_cast<std::size_t>(best)];
+    Route route;
+    route.target = target;
+    route.reachable = true;
+    route.time = last.time;
+    route.transfers = last.transfers;
+    route.metric = last.time + k * static_cast<double>(last.transfers);
+    for (int x = best; result.labels[static_cast<std::size_t>(x)].parent != -1;
+         x = result.labels[static_cast<std::size_t>(x)].parent) {
+        const ParetoLabel& label = result.labels[static_cast<std::size_t>(x)];
+        route.steps.push_back(Step{result.labels[static_cast<std::size_t>(label.parent)].v, label.v, label.mode});
+    }
+    std::reverse(route.steps.begin(), route.steps.end());
+    return route;
+}
+
+std::vector<std::vector<Route>> pareto_answers(const ParetoResult& result, const Request& rq, const std::vector<double>& ks) {
+    std::vector<std::vector<Route>> answers(ks.size());
+    for (std::size_t j = 0; j < ks.size(); ++j) {
+        std::vector<Route>& routes = answers[j];
+        routes.reserve(rq.targets.size());
+        for (int target : rq.targets) {
+            routes.push_back(pareto_route(result, target, ks[j]));
+        }
+        if (!routes.empty()) {
+            quicksort_routes(routes, 0, static_cast<int>(routes.size()) - 1);
+        }
+    }
+    return answers;
+}
+
+std::vector<std::vector<Route>> solve_request_pareto(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const std::vector<double>& ks,
+    int max_transfers
+) {
+    if (ks.empty() || rq.targets.empty()) {
+        return std::vector<std::vector<Route>>(ks.size());
+    }
+    ParetoOptions options;
+    options.max_transfers = std::min(max_transfers, rq.max_transfers);
+    options.ks = ks;
+    return pareto_answers(pareto_search(g, model, rq.start, rq.targets, options), rq, ks);
+}
@@ -0,0 +1,171 @@
+#include "raptor.hpp"
+#include "stamped_table.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace {
+
+constexpr int kModeCount = 4;
+constexpr int kNoMode = 3;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Кандидат раунда: метка (v, mode) со временем time от метки parent.
+struct Candidate {
+    double time;
+    int v;
+    int mode;
+    int parent;
+};
+
+struct CandidateGreater {
+    bool operator()(const Candidate& a, const Candidate& b) const {
+        return a.time > b.time;
+    }
+};
+
+using RoundQueue = std::priority_queue<Candidate, std::vector<Candidate>, CandidateGreater>;
+
+// Отсечение по целям: наибольшее из лучших времен целей (inf, пока есть
+// недостигнутая цель).
+struct TargetBound {
+    std::vector<double> best;
+    int unreached = 0;
+    double limit = kInf;
+
+    void improve(int slot, double time) {
+        double& b = best[static_cast<std::size_t>(slot)];
+        if (b == kInf) {
+            --unreached;
+        }
+        b = std::min(b, time);
+        if (unreached == 0) {
+            limit = *std::max_element(best.begin(), best.end());
+        }
+    }
+};
+
+} // namespace
+
+ParetoResult round_search(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    int max_transfers
+) {
+    ParetoResult result;
+    result.start = start;
+    result.head.assign(static_cast<std::size_t>(g.n) + 1, -1);
+    if (!valid_vertex(g, start)) {
+        return result;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(g.n) + 1;
+    thread_local StampedTable<double> best_time; // по состояниям 4 * v + mode за все раунды
+    thread_local StampedTable<int> target_slot;  // номер цели в списке или -1
+    best_time.begin(kModeCount * size, kInf);
+    target_slot.begin(size, -1);
+
+    std::vector<int> open_targets;
+    for (int t : targets) {
+        if (valid_vertex(g, t) && t != start && target_slot[t] == -1) {
+            target_slot.touch(t) = static_cast<int>(open_targets.size());
+            open_targets.push_back(t);
+        }
+    }
+    TargetBound bound;
+    bound.best.assign(open_targets.size(), kInf);
+    bound.unreached = static_cast<int>(open_targets.size());
+    const bool bounded = !targets.empty();
+
+    result.labels.push_back(ParetoLabel{0.0, 0, start, kNoMode, -1, -1});
+    result.head[start] = 0;
+
+    RoundQueue q;
+    // Раунд 0: дуги из start без штрафа.
+    for (int b = 0; b < 3; ++b) {
+        for (int a = g.mode_begin(start, b); a < g.mode_end(start, b); ++a) {
+            q.push(Candidate{arc_time(g, a, b, model.sensitivity), g.to[static_cast<std::size_t>(a)], b, 0});
+        }
+    }
+
+    for (int round = 0; round <= max_transfers && !q.empty(); ++round) {
+        // Дейкстра раунда: езда без смены вида.
+        const int first = static_cast<int>(result.labels.size());
+        while (!q.empty()) {
+            const Candidate c = q.top();
+            q.pop();
+            if (bounded && c.time >= bound.limit) {
+                break; // остальные кандидаты не быстрее
+            }
+            const int s = kModeCount * c.v + c.mode;
+            if (!(c.time < best_time[static_cast<std::size_t>(s)])) {
+                continue; // есть метка не медленнее и не больше по пересадкам
+            }
+            best_time.touch(static_cast<std::size_t>(s)) = c.time;
+
+            const int x = static_cast<int>(result.labels.size());
+            result.labels.push_back(ParetoLabel{c.time, round, c.v, c.mode, c.parent, result.head[c.v]});
+            result.head[c.v] = x;
+            if (target_slot[c.v] >= 0) {
+                bound.improve(target_slot[c.v], c.time);
+            }
+
+            const int arc_end = g.mode_end(c.v, c.mode);
+            for (int a = g.mode_begin(c.v, c.mode); a < arc_end; ++a) {
+                const int v = g.to[static_cast<std::size_t>(a)];
+                const double t = c.time + (arc_time(g, a, c.mode, model.sensitivity) + 0.0);
+                if (t < best_time[static_cast<std::size_t>(kModeCount * v + c.mode)]) {
+                    q.push(Candidate{t, v, c.mode, x});
+                }
+            }
+        }
+        RoundQueue().swap(q);
+        if (round == max_transfers) {
+            break;
+        }
+
+        // Пересадки из меток этого раунда (отмеченные состояния) — кандидаты
+        // следующего.
+        const int last = static_cast<int>(result.labels.size());
+        for (int x = first; x < last; ++x) {
+            const ParetoLabel label = result.labels[static_cast<std::size_t>(x)];
+            if (bounded && label.time >= bound.limit) {
+                continue;
+            }
+            for (int b = 0; b < 3; ++b) {
+                if (b == label.mode) {
+                    continue;
+                }
+                const double penalty = model.trans[label.mode][b] + model.station_transfer[label.v];
+                const int arc_end = g.mode_end(label.v, b);
+                for (int a = g.mode_begin(label.v, b); a < arc_end; ++a) {
+                    const int v = g.to[static_cast<std::size_t>(a)];
+                    const double t = label.time + (arc_time(g, a, b, model.sensitivity) + penalty);
+                    if (t < best_time[static_cast<std::size_t>(kModeCount * v + b)]) {
+                        q.push(Candidate{t, v, b, x});
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::vector<Route>> solve_request_rounds(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const std::vector<double>& ks,
+    int max_transfers
+) {
+    if (ks.empty() || rq.targets.empty()) {
+        return std::vector<std::vector<Route>>(ks.size());
+    }
+    const ParetoResult result = round_search(g, model, rq.start, rq.targets, std::min(max_transfers, rq.max_transfers));
+    return pareto_answers(result, rq, ks);
+}
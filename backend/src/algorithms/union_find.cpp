@@ -0,0 +1,176 @@
+#include "algorithms.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Лес непересекающихся множеств без блокировок (CLRS, гл. 21; связывание
+// CAS-ом). Корень всегда подвешивается к корню с меньшим номером, поэтому
+// циклов нет и корень множества — его наименьшая вершина.
+class ConcurrentDisjointSets {
+public:
+    explicit ConcurrentDisjointSets(int n) : parent_(new std::atomic<int>[static_cast<std::size_t>(n) + 1]) {
+        for (int v = 0; v <= n; ++v) {
+            parent_[v].store(v, std::memory_order_relaxed);
+        }
+    }
+
+    // FIND-SET с делением пути пополам: x переставляется на деда. Гонка
+    // безопасна — указатель только поднимается к предку в том же дереве.
+    int find(int x) {
+        for (;;) {
+            int p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) {
+                return x;
+            }
+            const int gp = parent_[p].load(std::memory_order_relaxed);
+            if (gp != p) {
+                parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            }
+            x = gp;
+        }
+    }
+
+    // UNION: повторять, пока CAS не подвесит корень hi к lo; неудача значит,
+    // что hi перестал быть корнем (его подвесил другой поток).
+    void unite(int a, int b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            int hi = std::max(a, b);
+            const int lo = std::min(a, b);
+            if (parent_[hi].compare_exchange_strong(hi, lo, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // Окончательная метка — корень; после фазы связывания дерево не меняется.
+    void compress(int v) {
+        parent_[v].store(find(v), std::memory_order_relaxed);
+    }
+
+    int get(int v) const { return parent_[v].load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<std::atomic<int>[]> parent_;
+};
+
+// Вершины 1..n порциями через общий атомарный счетчик (как в solve_batch).
+template <typename Body>
+void parallel_for(int n, int threads, const Body& body) {
+    constexpr int kChunk = 4096;
+    std::atomic<int> next{1};
+    const auto work = [&]() {
+        for (;;) {
+            const int begin = next.fetch_add(kChunk, std::memory_order_relaxed);
+            if (begin > n) {
+                return;
+            }
+            const int end = std::min(n, begin + kChunk - 1);
+            for (int v = begin; v <= end; ++v) {
+                body(v);
+            }
+        }
+    };
+
+    const int chunks = (n + kChunk - 1) / kChunk;
+    const int workers = std::max(1, std::min(threads, chunks));
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<std::size_t>(workers) - 1);
+    for (int t = 1; t < workers; ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+}
+
+} // namespace
+
+// AFFOREST (Sutton, Ben-Nun, Barak, 2018) поверх ConcurrentDisjointSets:
+//   1. связать каждую вершину с первыми kSampleArcs соседями;
+//   2. по выборке вершин найти самую крупную промежуточную компоненту c;
+//   3. для вершин вне c связать остальные рёбра.
+// Рёбра вершин из c пропускаются: граф неориентированный, и дуга (u, v)
+// с v вне c встретится из v. В дорожной сети c — почти весь граф, поэтому
+// фаза 3 касается малой доли рёбер.
+std::vector<int> component_roots(const FrozenGraph& g, TransportType type, int threads) {
+    const int n = g.n;
+    const int type_value = static_cast<int>(type);
+    const bool sliced = (type_value >= 0 && type_value <= 2);
+
+    const auto arcs_of = [&g, sliced, type_value](int u) {
+        if (sliced) {
+            return std::make_pair(g.mode_begin(u, type_value), g.mode_end(u, type_value));
+        }
+        return std::make_pair(g.row_begin(u), g.row_end(u));
+    };
+
+    ConcurrentDisjointSets sets(n);
+    constexpr int kSampleArcs = 2;
+
+    parallel_for(n, threads, [&](int u) {
+        const auto range = arcs_of(u);
+        const int end = std::min(range.second, range.first + kSampleArcs);
+        for (int a = range.first; a < end; ++a) {
+            const int v = g.to[static_cast<std::size_t>(a)];
+            if (valid_vertex(g, v)) {
+                sets.unite(u, v);
+            }
+        }
+    });
+
+    // Выборка с фиксированным шагом: результат не зависит от запуска.
+    int giant = -1;
+    if (n > 0) {
+        constexpr int kSamples = 1024;
+        std::vector<int> sample;
+        sample.reserve(kSamples);
+        for (int i = 0; i < kSamples; ++i) {
+            sample.push_back(sets.find(1 + static_cast<int>((static_cast<long long>(i) * 7919) % n)));
+        }
+        std::sort(sample.begin(), sample.end());
+        int best_count = 0;
+        for (std::size_t i = 0; i < sample.size();) {
+            std::size_t j = i;
+            while (j < sample.size() && sample[j] == sample[i]) {
+                ++j;
+            }
+            if (static_cast<int>(j - i) > best_count) {
+                best_count = static_cast<int>(j - i);
+                giant = sample[i];
+            }
+            i = j;
+        }
+    }
+
+    parallel_for(n, threads, [&](int u) {
+        if (sets.find(u) == giant) {
+            return;
+        }
+        const auto range = arcs_of(u);
+        for (int a = range.first + kSampleArcs; a < range.second; ++a) {
+            const int v = g.to[static_cast<std::size_t>(a)];
+            if (valid_vertex(g, v)) {
+                sets.unite(u, v);
+            }
+        }
+    });
+
+    parallel_for(n, threads, [&](int v) { sets.compress(v); });
+
+    std::vector<int> roots(static_cast<std::size_t>(n) + 1, 0);
+    for (int v = 1; v <= n; ++v) {
+        roots[v] = sets.get(v);
+    }
+    return roots;
+}
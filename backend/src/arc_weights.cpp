@@ -0,0 +1,88 @@
+#include "arc_weights.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Ядро: time[i] = base[i] * (1 + load[i] * s[mode[i]]) для i в [0, count).
+void weights_kernel(
+    const double* base,
+    const double* load,
+    const std::uint8_t* mode,
+    const std::array<double, 3>& s,
+    double* time,
+    std::size_t count
+) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128d one = _mm_set1_pd(1.0);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d sens = _mm_set_pd(s[mode[i + 1]], s[mode[i]]);
+        const __m128d b = _mm_loadu_pd(base + i);
+        const __m128d l = _mm_loadu_pd(load + i);
+        _mm_storeu_pd(time + i, _mm_mul_pd(b, _mm_add_pd(one, _mm_mul_pd(l, sens))));
+    }
+#endif
+    for (; i < count; ++i) {
+        time[i] = base[i] * (1.0 + load[i] * s[mode[i]]);
+    }
+}
+
+double one_arc(const FrozenGraph& g, const ArcWeights& w, std::size_t arc) {
+    return g.base_time[arc] * (1.0 + g.load[arc] * w.sensitivity[w.mode[arc]]);
+}
+
+} // namespace
+
+ArcWeights materialize_arc_weights(const FrozenGraph& g, const std::array<double, 3>& sensitivity) {
+    ArcWeights w;
+    w.version = g.version;
+    w.sensitivity = sensitivity;
+    w.mode.resize(g.arc_count());
+    for (int u = 1; u <= g.n; ++u) {
+        for (int m = 0; m < 3; ++m) {
+            for (int a = g.mode_begin(u, m); a < g.mode_end(u, m); ++a) {
+                w.mode[static_cast<std::size_t>(a)] = static_cast<std::uint8_t>(m);
+            }
+        }
+    }
+    w.time.resize(g.arc_count());
+    weights_kernel(g.base_time.data(), g.load.data(), w.mode.data(), sensitivity, w.time.data(), g.arc_count());
+    return w;
+}
+
+void update_arc_weights(
+    ArcWeights& w,
+    const FrozenGraph& g,
+    const std::array<double, 3>& sensitivity,
+    const std::vector<EdgeDelta>& deltas
+) {
+    if (w.time.size() != g.arc_count() || w.mode.size() != g.arc_count()
+        || (!deltas.empty() && g.weights == nullptr)) {
+        w = materialize_arc_weights(g, sensitivity);
+        return;
+    }
+
+    // Новая чувствительность: один проход ядра по всем дугам (обход срезов
+    // одного вида читал бы те же строки CSR и не векторизуется).
+    if (w.sensitivity != sensitivity) {
+        w.sensitivity = sensitivity;
+        weights_kernel(g.base_time.data(), g.load.data(), w.mode.data(), sensitivity, w.time.data(), g.arc_count());
+    }
+
+    // Дуги измененных ребер: по индексу id -> дуги снимка.
+    for (const EdgeDelta& d : deltas) {
+        const std::vector<int>& arc_of_edge = g.weights->arc_of_edge;
+        for (int side = 0; side < 2; ++side) {
+            const std::size_t slot = 2 * static_cast<std::size_t>(d.id) + static_cast<std::size_t>(side);
+            if (d.id < 0 || slot >= arc_of_edge.size() || arc_of_edge[slot] < 0) {
+                continue;
+            }
+            const std::size_t arc = static_cast<std::size_t>(arc_of_edge[slot]);
+            w.time[arc] = one_arc(g, w, arc);
+        }
+    }
+    w.version = g.version;
+}
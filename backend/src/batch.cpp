@@ -0,0 +1,181 @@
+#include "batch.hpp"
+#include "stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Запросов в окне на один поток: достаточно, чтобы потоки не простаивали
+// из-за медленного вывода, и мало, чтобы не держать в памяти весь пакет.
+constexpr std::size_t kWindowPerThread = 64;
+
+struct Window {
+    explicit Window(std::size_t size) : slots(size), ready(size, 0) {}
+
+    std::mutex mutex;
+    std::condition_variable slot_ready;
+    std::condition_variable slot_free;
+    std::vector<std::vector<Route>> slots;
+    std::vector<char> ready;
+    std::size_t emitted = 0; // сколько результатов уже отдано в sink
+    std::exception_ptr error; // первое исключение потока или sink; пакет прерывается
+
+    // Запомнить текущее исключение и разбудить всех ждущих.
+    void fail() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        slot_ready.notify_all();
+        slot_free.notify_all();
+    }
+};
+
+} // namespace
+
+int default_thread_count() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<int>(hw);
+}
+
+void parallel_for(std::size_t count, int threads, const std::function<void(std::size_t)>& body) {
+    if (threads <= 1 || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+    const std::size_t workers = std::min(static_cast<std::size_t>(threads), count);
+    std::atomic<std::size_t> next{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+        try {
+            for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+                 i = next.fetch_add(1, std::memory_order_relaxed)) {
+                body(i);
+            }
+        } catch (...) {
+            // Остальные потоки не берут новых индексов; исключение уйдет
+            // вызывающему после join.
+            next.store(count, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        stats_flush_thread();
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (std::size_t t = 0; t < workers; ++t) {
+        pool.emplace_back(work);
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void solve_batch(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const SearchOptions& options,
+    const std::vector<Request>& requests,
+    int threads,
+    const BatchSink& sink
+) {
+    const std::size_t total = requests.size();
+    if (threads <= 1 || total <= 1) {
+        for (std::size_t i = 0; i < total; ++i) {
+            sink(i, solve_request(g, model, requests[i], options));
+        }
+        return;
+    }
+
+    const std::size_t workers = std::min(static_cast<std::size_t>(threads), total);
+    const std::size_t window_size = workers * kWindowPerThread;
+    Window window(window_size);
+    std::atomic<std::size_t> next{0};
+
+    auto work = [&]() {
+        for (;;) {
+            const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= total) {
+                stats_flush_thread();
+                return;
+            }
+            {
+                // Слот i % W свободен, когда результат i - W уже выведен.
+                std::unique_lock<std::mutex> lock(window.mutex);
+                window.slot_free.wait(lock, [&]() { return window.error || i < window.emitted + window_size; });
+                if (window.error) {
+                    stats_flush_thread();
+                    return;
+                }
+            }
+
+            std::vector<Route> routes;
+            try {
+                routes = solve_request(g, model, requests[i], options);
+            } catch (...) {
+                // Например, bad_alloc: без перехвата std::thread вызвал бы terminate.
+                window.fail();
+                stats_flush_thread();
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(window.mutex);
+                window.slots[i % window_size] = std::move(routes);
+                window.ready[i % window_size] = 1;
+            }
+            window.slot_ready.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (std::size_t t = 0; t < workers; ++t) {
+        pool.emplace_back(work);
+    }
+
+    for (std::size_t i = 0; i < total; ++i) {
+        const std::size_t slot = i % window_size;
+        std::vector<Route> routes;
+        {
+            std::unique_lock<std::mutex> lock(window.mutex);
+            window.slot_ready.wait(lock, [&]() { return window.error || window.ready[slot] != 0; });
+            if (window.error) {
+                break;
+            }
+            routes = std::move(window.slots[slot]);
+            window.slots[slot].clear();
+            window.ready[slot] = 0;
+            window.emitted = i + 1;
+        }
+        window.slot_free.notify_all();
+        try {
+            sink(i, routes);
+        } catch (...) {
+            window.fail();
+            break;
+        }
+    }
+
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    if (window.error) {
+        std::rethrow_exception(window.error);
+    }
+}
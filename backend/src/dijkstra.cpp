@@ -1,10 +1,21 @@
 #include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "contraction.hpp"
+#include "landmarks.hpp"
+#include "pareto.hpp"
+#include "path_tree_cache.hpp"
+#include "raptor.hpp"
+#include "stats.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <queue>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -33,83 +44,528 @@ struct MinKey {
     }
 };
 
-using TimeTable = std::vector<std::array<double, kModeCount>>;
-using TransferTable = std::vector<std::array<int, kModeCount>>;
-using ParentTable = std::vector<std::array<int, kModeCount>>;
+// Двоичная куча с ленивым удалением — эталонная очередь.
+struct HeapQueue {
+    std::priority_queue<State, std::vector<State>, MinKey> q;
+
+    void push(const State& s) { q.push(s); }
+
+    // Извлечь минимум, пропуская устаревшие записи (stale(s) == true).
+    template <typename Stale>
+    bool pop(State& out, const Stale& stale) {
+        while (!q.empty()) {
+            out = q.top();
+            q.pop();
+            if (!stale(out)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Монотонная radix-куча (Ahuja, Mehlhorn, Orlin, Tarjan, 1990).
+// Дейкстра извлекает ключи в неубывающем порядке, поэтому запись с ключом
+// key лежит в корзине номер (старший различающийся бит key и last) + 1,
+// где last — последний извлеченный ключ; корзина 0 — ключи, равные last.
+// При опустошении корзины 0 ближайшая непустая корзина i перераспределяется
+// вокруг своего минимума в корзины с меньшими номерами: каждая запись
+// перемещается не более 96 раз, сравнений double нет вовсе.
+//
+// Ключ — 96 бит: (время, пересадки) лексикографически, как пара целых без
+// расширения компилятора. Время берется как целое число тиков (фиксированная
+// точка) или как битовый образ double: для неотрицательных double он
+// монотонен по значению.
+class RadixQueue {
+public:
+    struct Key {
+        std::uint64_t time = 0;
+        std::uint32_t transfers = 0;
+    };
+
+    // Очистить очередь, сохранив выделенную память корзин.
+    void reset(bool integral_time) {
+        integral_ = integral_time;
+        last_ = Key{};
+        for (std::vector<Entry>& b : buckets_) {
+            b.clear();
+        }
+    }
+
+    void push(const State& s) {
+        const Key key = make_key(s);
+        buckets_[bucket_of(key)].push_back(Entry{key, s.v, s.mode});
+    }
+
+    template <typename Stale>
+    bool pop(State& out, const Stale& stale) {
+        for (;;) {
+            while (!buckets_[0].empty()) {
+                out = state_of(buckets_[0].back());
+                buckets_[0].pop_back();
+                if (!stale(out)) {
+                    return true;
+                }
+            }
+            if (!refill(stale)) {
+                return false;
+            }
+        }
+    }
+
+private:
+    // Время и пересадки восстанавливаются из ключа: запись — 24 байта.
+    struct Entry {
+        Key key;
+        int v;
+        int mode;
+    };
+
+    static constexpr int kBuckets = 97;
+
+    static bool key_less(const Key& a, const Key& b) {
+        return a.time < b.time || (a.time == b.time && a.transfers < b.transfers);
+    }
+
+    Key make_key(const State& s) const {
+        std::uint64_t t = 0;
+        if (integral_) {
+            t = static_cast<std::uint64_t>(s.time);
+        } else {
+            std::memcpy(&t, &s.time, sizeof(t));
+        }
+        return Key{t, static_cast<std::uint32_t>(s.transfers)};
+    }
+
+    State state_of(const Entry& e) const {
+        const std::uint64_t t = e.key.time;
+        double time = 0.0;
+        if (integral_) {
+            time = static_cast<double>(t);
+        } else {
+            std::memcpy(&time, &t, sizeof(time));
+        }
+        return State{e.v, e.mode, time, static_cast<int>(e.key.transfers)};
+    }
+
+    // Время — старшие 64 бита ключа, пересадки — младшие 32.
+    int bucket_of(const Key& key) const {
+        const std::uint64_t hi = key.time ^ last_.time;
+        const std::uint64_t lo = key.transfers ^ last_.transfers;
+        if (hi != 0) {
+            return 96 - __builtin_clzll(hi);
+        }
+        return lo == 0 ? 0 : 64 - __builtin_clzll(lo);
+    }
+
+    // Перенести ближайшую непустую корзину в младшие; устаревшие записи
+    // при этом выбрасываются и больше не перемещаются.
+    template <typename Stale>
+    bool refill(const Stale& stale) {
+        int i = 1;
+        while (i < kBuckets && buckets_[i].empty()) {
+            ++i;
+        }
+        if (i == kBuckets) {
+            return false;
+        }
+        std::vector<Entry>& from = buckets_[i];
+        Key lo = from.front().key;
+        for (const Entry& e : from) {
+            if (key_less(e.key, lo)) {
+                lo = e.key;
+            }
+        }
+        last_ = lo;
+        for (const Entry& e : from) {
+            if (!stale(state_of(e))) {
+                buckets_[bucket_of(e.key)].push_back(e);
+            }
+        }
+        from.clear();
+        return true;
+    }
+
+    bool integral_ = false;
+    Key last_;
+    std::array<std::vector<Entry>, kBuckets> buckets_;
+};
 
-struct InternalResult {
-    TimeTable time;
-    TransferTable transfers;
-    ParentTable parent_v;
-    ParentTable parent_mode;
-    ParentTable parent_edge_mode;
+// Вес дуги в единицах поиска: точное время или целое число тиков.
+// Тики — округление (время дуги + штраф) / resolution; сумма целых double
+// точна до 2^53, поэтому сравнения в фиксированной точке не накапливают ошибок.
+struct ExactWeight {
+    double operator()(double w) const { return w; }
+};
+
+struct FixedWeight {
+    double inv_resolution;
+    // w >= 0: округление к ближайшему без вызова библиотечной nearbyint.
+    double operator()(double w) const {
+        return static_cast<double>(static_cast<std::int64_t>(w * inv_resolution + 0.5));
+    }
 };
 
 bool is_better(double t_new, int tr_new, double t_old, int tr_old) {
     return (t_new < t_old) || (t_new == t_old && tr_new < tr_old);
 }
 
-InternalResult run_dijkstra_states(
-    const Graph& g,
+// Ограничение поиска множеством целей (nullptr — полный проход).
+struct TargetBound {
+    const std::vector<int>* targets = nullptr;
+};
+
+// Модели пересадок (TransferModel): штраф перехода u: a -> b (a != b, a —
+// не kNoMode). kCollapse — штрафов нет, и доминируемые состояния станции
+// не записываются (см. dominated).
+struct MatrixTransfers {
+    static constexpr bool kCollapse = false;
+    const std::array<std::array<double, 3>, 3>& trans;
+    const std::vector<double>& station;
+
+    double operator()(int u, int a, int b) const { return trans[a][b] + station[static_cast<std::size_t>(u)]; }
+};
+
+struct UniformTransfers {
+    static constexpr bool kCollapse = false;
+    double penalty; // trans[a][b] + station_transfer[u], одинаковый для всех
+
+    double operator()(int, int, int) const { return penalty; }
+};
+
+struct PlainTransfers {
+    static constexpr bool kCollapse = true;
+
+    double operator()(int, int, int) const { return 0.0; }
+};
+
+// Штраф модели Uniform: та же сумма, что в MatrixTransfers.
+double uniform_transfer_penalty(const ModelParams& model) {
+    const double station = model.station_transfer.size() > 1 ? model.station_transfer[1] : 0.0;
+    return model.trans[0][1] + station;
+}
+
+// Без штрафов состояние (v, m) с оценкой (t, tr) хуже другого состояния
+// (v, m') с t' <= t и tr' + 2 <= tr при любом продолжении: время через (v, m')
+// не больше (сложение в double монотонно), а пересадок даже после лишней
+// пересадки с m' на m меньше. Такое (v, m') извлекается раньше, и ни одна
+// оценка через (v, m) не прошла бы is_better.
+bool dominated(const SearchWorkspace& ws, int v, int m, double t, int tr) {
+    if (!ws.reached(v)) {
+        return false;
+    }
+    for (int other = 0; other < 3; ++other) {
+        if (other != m && ws.time(v, other) <= t && ws.transfers(v, other) + 2 <= tr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// DIJKSTRA-STATE в рабочей области ws (новый поиск: ws.begin).
+// При заданных целях поиск останавливается, когда лучшее состояние каждой
+// цели извлечено из очереди и ключ вершины кучи строго больше ключа
+// последней найденной цели: тогда все состояния с равным ключом тоже
+// окончательны и выбор best_mode совпадает с полным проходом.
+// Queue — HeapQueue или RadixQueue, Weight — ExactWeight или FixedWeight,
+// Arcs — ComputedArcs или MaterializedArcs (arc_weights.hpp), Transfers —
+// MatrixTransfers, UniformTransfers или PlainTransfers.
+//
+// Без штрафов (PlainTransfers) доминируемые состояния (dominated) не
+// записываются и не раскрываются. Сравнение точное, и ответ шаг в шаг тот
+// же, что у общего ядра.
+template <typename Arcs, typename Transfers, typename Queue, typename Weight>
+void run_dijkstra_states(
+    const FrozenGraph& g,
     int start,
-    const std::array<double, 3>& sensitivity,
-    const std::array<std::array<double, 3>, 3>& transfer_penalty,
-    const std::vector<double>& station_penalty
+    Arcs arcs,
+    Transfers transfers,
+    SearchWorkspace& ws,
+    TargetBound bound,
+    Queue& q,
+    Weight weight
 ) {
-    InternalResult res;
-    res.time.assign(g.n + 1, std::array<double, kModeCount>{kInf, kInf, kInf, kInf});
-    res.transfers.assign(g.n + 1, std::array<int, kModeCount>{kInfTransfers, kInfTransfers, kInfTransfers, kInfTransfers});
-    res.parent_v.assign(g.n + 1, std::array<int, kModeCount>{-1, -1, -1, -1});
-    res.parent_mode.assign(g.n + 1, std::array<int, kModeCount>{-1, -1, -1, -1});
-    res.parent_edge_mode.assign(g.n + 1, std::array<int, kModeCount>{-1, -1, -1, -1});
-
+    ws.begin(g.n, start);
     if (!valid_vertex(g, start)) {
-        return res;
+        return;
     }
 
-    res.time[start][kNoMode] = 0.0;
-    res.transfers[start][kNoMode] = 0;
+    int pending = 0;
+    if (bound.targets != nullptr) {
+        for (int t : *bound.targets) {
+            if (valid_vertex(g, t) && t != start && ws.target_flag[t] == 0) {
+                ws.target_flag[t] = 1;
+                ++pending;
+            }
+        }
+        if (pending == 0) {
+            return;
+        }
+    }
+    double bound_time = -kInf;
+    int bound_transfers = 0;
 
-    std::priority_queue<State, std::vector<State>, MinKey> q;
-    q.push({start, kNoMode, 0.0, 0});
+    ws.touch(start);
+    ws.set(start, kNoMode, 0.0, 0, -1, -1);
 
-    while (!q.empty()) {
-        const State u = q.top();
-        q.pop();
+    SearchCounters counters;
+    q.push({start, kNoMode, 0.0, 0});
+    counters.push();
 
-        if (u.time > res.time[u.v][u.mode]) {
-            continue;
+    const auto is_stale = [&ws](const State& s) {
+        const double t = ws.time(s.v, s.mode);
+        if constexpr (Transfers::kCollapse) {
+            if (dominated(ws, s.v, s.mode, s.time, s.transfers)) {
+                return true;
+            }
         }
-        if (u.time == res.time[u.v][u.mode] && u.transfers > res.transfers[u.v][u.mode]) {
-            continue;
+        return s.time > t || (s.time == t && s.transfers > ws.transfers(s.v, s.mode));
+    };
+    const auto stale = [&is_stale, &counters](const State& s) {
+        if (is_stale(s)) {
+            counters.stale_pop();
+            return true;
         }
+        return false;
+    };
 
-        for (const Edge& e : g.adj[u.v]) {
-            const int v = e.to;
-            const int mode_v = e.mode;
+    State u{};
+    while (q.pop(u, stale)) {
+        counters.settle();
 
-            double w = edge_time(e, sensitivity);
+        if (bound.targets != nullptr) {
+            if (pending == 0 && is_better(bound_time, bound_transfers, u.time, u.transfers)) {
+                break;
+            }
+            if (u.mode != kNoMode && ws.target_flag[u.v] == 1) {
+                ws.target_flag[u.v] = 2;
+                --pending;
+                bound_time = u.time;
+                bound_transfers = u.transfers;
+            }
+        }
+
+        // Срезы Adj_mode[u] непрерывны, поэтому штраф пересадки считается
+        // один раз на вид транспорта, а не на каждое ребро. Оценка u
+        // окончательна и при релаксации своих дуг не меняется.
+        const double time_u = ws.time(u.v, u.mode);
+        const int transfers_u = ws.transfers(u.v, u.mode);
+        for (int mode_v = 0; mode_v < 3; ++mode_v) {
+            double penalty = 0.0;
             int add_transfer = 0;
             if (u.mode != kNoMode && u.mode != mode_v) {
-                w += transfer_penalty[u.mode][mode_v] + station_penalty[u.v];
+                penalty = transfers(u.v, u.mode, mode_v);
                 add_transfer = 1;
             }
+            const int new_transfers = transfers_u + add_transfer;
+
+            const int arc_end = g.mode_end(u.v, mode_v);
+            for (int a = g.mode_begin(u.v, mode_v); a < arc_end; ++a) {
+                const int v = g.to[static_cast<std::size_t>(a)];
+                const double w = weight(arcs(a, mode_v) + penalty);
+                const double new_time = time_u + w;
+                counters.relax();
+                if constexpr (Transfers::kCollapse) {
+                    if (dominated(ws, v, mode_v, new_time, new_transfers)) {
+                        continue;
+                    }
+                }
+
+                if (is_better(new_time, new_transfers, ws.time(v, mode_v), ws.transfers(v, mode_v))) {
+                    ws.touch(v);
+                    ws.set(v, mode_v, new_time, new_transfers, u.v, u.mode);
+                    q.push({v, mode_v, new_time, new_transfers});
+                    counters.push();
+                }
+            }
+        }
+    }
+    counters.commit();
+
+    if (bound.targets != nullptr) {
+        for (int t : *bound.targets) {
+            if (valid_vertex(g, t)) {
+                ws.target_flag[t] = 0;
+            }
+        }
+    }
+}
+
+// Полный проход (двоичная куча, точное время).
+void run_dijkstra_states(
+    const FrozenGraph& g,
+    int start,
+    const std::array<double, 3>& sensitivity,
+    const std::array<std::array<double, 3>, 3>& transfer_penalty,
+    const std::vector<double>& station_penalty,
+    SearchWorkspace& ws
+) {
+    HeapQueue q;
+    run_dijkstra_states(g, start, ComputedArcs{g, sensitivity}, MatrixTransfers{transfer_penalty, station_penalty}, ws,
+                        TargetBound{}, q, ExactWeight{});
+}
+
+// Область потока для вызовов без явной рабочей области.
+SearchWorkspace& thread_workspace() {
+    thread_local SearchWorkspace ws;
+    return ws;
+}
+
+// Корзины radix-кучи переиспользуются между запросами потока (одни на все
+// варианты поиска).
+RadixQueue& thread_radix_queue() {
+    thread_local RadixQueue q;
+    return q;
+}
+
+// Выбор очереди и представления времени по SearchOptions.
+template <typename Arcs, typename Transfers>
+void run_dijkstra_queue(
+    const FrozenGraph& g,
+    int start,
+    const SearchOptions& options,
+    SearchWorkspace& ws,
+    TargetBound bound,
+    Arcs arcs,
+    Transfers transfers
+) {
+    const bool fixed = options.time_resolution > 0.0;
+    if (options.queue == QueueKind::Radix) {
+        RadixQueue& q = thread_radix_queue();
+        q.reset(fixed);
+        if (fixed) {
+            run_dijkstra_states(g, start, arcs, transfers, ws, bound, q, FixedWeight{1.0 / options.time_resolution});
+        } else {
+            run_dijkstra_states(g, start, arcs, transfers, ws, bound, q, ExactWeight{});
+        }
+    } else {
+        HeapQueue q;
+        if (fixed) {
+            run_dijkstra_states(g, start, arcs, transfers, ws, bound, q, FixedWeight{1.0 / options.time_resolution});
+        } else {
+            run_dijkstra_states(g, start, arcs, transfers, ws, bound, q, ExactWeight{});
+        }
+    }
+}
+
+// Модель пересадок по options.transfer_model.
+template <typename Arcs>
+void run_dijkstra_model(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const SearchOptions& options,
+    SearchWorkspace& ws,
+    TargetBound bound,
+    Arcs arcs
+) {
+    switch (options.transfer_model) {
+    case TransferModel::Plain:
+        run_dijkstra_queue(g, start, options, ws, bound, arcs, PlainTransfers{});
+        break;
+    case TransferModel::Uniform:
+        run_dijkstra_queue(g, start, options, ws, bound, arcs,
+                           UniformTransfers{uniform_transfer_penalty(model)});
+        break;
+    case TransferModel::Matrix:
+        run_dijkstra_queue(g, start, options, ws, bound, arcs, MatrixTransfers{model.trans, model.station_transfer});
+        break;
+    }
+}
+
+// Веса дуг: материализованный массив, если он посчитан для этих весов и
+// модели, иначе по формуле.
+void run_dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const SearchOptions& options,
+    SearchWorkspace& ws,
+    TargetBound bound
+) {
+    if (options.arc_weights != nullptr && options.arc_weights->matches(g, model.sensitivity)) {
+        run_dijkstra_model(g, model, start, options, ws, bound, MaterializedArcs{options.arc_weights->time.data()});
+    } else {
+        run_dijkstra_model(g, model, start, options, ws, bound, ComputedArcs{g, model.sensitivity});
+    }
+}
+
+// Доступ к таблицам Дейкстры для восстановления маршрута: рабочая область
+// и упакованные результаты (PackedStateResult) читаются одинаково.
+struct WorkspaceTables {
+    const SearchWorkspace& ws;
+
+    bool has(int v) const { return v >= 0 && v < ws.size(); }
+    double time(int v, int m) const { return ws.time(v, m); }
+    int transfers(int v, int m) const { return ws.transfers(v, m); }
+    int parent_v(int v, int m) const { return ws.parent_v(v, m); }
+    int parent_mode(int v, int m) const { return ws.parent_mode(v, m); }
+    int parent_edge_mode(int v, int m) const { return ws.parent_edge_mode(v, m); }
+};
+
+template <typename Tables>
+Route build_route(const Tables& dj, int start, int target, double k) {
+    Route route;
+    route.target = target;
+
+    if (start == target) {
+        route.reachable = true;
+        route.time = 0.0;
+        route.transfers = 0;
+        route.metric = 0.0;
+        return route;
+    }
 
-            const double new_time = res.time[u.v][u.mode] + w;
-            const int new_transfers = res.transfers[u.v][u.mode] + add_transfer;
+    int best_mode = -1;
+    double best_time = kInf;
+    int best_transfers = kInfTransfers;
 
-            if (is_better(new_time, new_transfers, res.time[v][mode_v], res.transfers[v][mode_v])) {
-                res.time[v][mode_v] = new_time;
-                res.transfers[v][mode_v] = new_transfers;
-                res.parent_v[v][mode_v] = u.v;
-                res.parent_mode[v][mode_v] = u.mode;
-                res.parent_edge_mode[v][mode_v] = mode_v;
-                q.push({v, mode_v, new_time, new_transfers});
+    if (dj.has(target)) {
+        for (int m = 0; m < 3; ++m) {
+            const double t = dj.time(target, m);
+            const int tr = dj.transfers(target, m);
+            if (is_better(t, tr, best_time, best_transfers)) {
+                best_time = t;
+                best_transfers = tr;
+                best_mode = m;
             }
         }
     }
 
-    return res;
+    if (best_mode == -1 || !std::isfinite(best_time)) {
+        route.reachable = false;
+        route.time = kInf;
+        route.transfers = kInfTransfers;
+        route.metric = kInf;
+        return route;
+    }
+
+    route.reachable = true;
+    route.time = best_time;
+    route.transfers = best_transfers;
+    route.metric = best_time + k * static_cast<double>(best_transfers);
+
+    std::vector<Step> reverse_steps;
+    int v = target;
+    int m = best_mode;
+
+    while (v != -1) {
+        const int u = dj.parent_v(v, m);
+        if (u == -1) {
+            break;
+        }
+        reverse_steps.push_back(Step{u, v, dj.parent_edge_mode(v, m)});
+        const int next_mode = dj.parent_mode(v, m);
+        v = u;
+        if (next_mode == kNoMode || next_mode < 0) {
+            break;
+        }
+        m = next_mode;
+    }
+
+    std::reverse(reverse_steps.begin(), reverse_steps.end());
+    route.steps = std::move(reverse_steps);
+    return route;
 }
 
 bool route_less(const Route& a, const Route& b) {
@@ -127,6 +583,22 @@ bool route_less(const Route& a, const Route& b) {
 
 } // namespace
 
+void SearchWorkspace::begin(int n, int start) {
+    const std::size_t size = static_cast<std::size_t>(n) + 1;
+    Row unreached;
+    unreached.time.fill(kInf);
+    unreached.transfers.fill(kInfTransfers);
+    unreached.parent_v.fill(-1);
+    unreached.parent_mode.fill(-1);
+    rows_.begin(size, unreached);
+    if (target_flag.size() != size) {
+        target_flag.assign(size, 0);
+    }
+    size_ = n + 1;
+    explored_ = 0;
+    start_ = start;
+}
+
 // DIJKSTRA-STATE(G, s): алгоритм Дейкстры на графе состояний (v, last_mode).
 // Инвариант: после извлечения (u, mode) из очереди приоритетов d[u][mode]
 // является длиной кратчайшего пути в графе состояний (все веса неотрицательны).
@@ -139,15 +611,19 @@ void dijkstra(
     std::vector<std::vector<double>>& dist,
     std::vector<std::vector<std::pair<int, int>>>& parent
 ) {
-    const InternalResult res = run_dijkstra_states(g, start, sensitivity, transfer_penalty, station_penalty);
+    SearchWorkspace& ws = thread_workspace();
+    run_dijkstra_states(freeze_graph(g), start, sensitivity, transfer_penalty, station_penalty, ws);
 
     dist.assign(g.n + 1, std::vector<double>(kModeCount, kInf));
     parent.assign(g.n + 1, std::vector<std::pair<int, int>>(kModeCount, {-1, -1}));
 
     for (int v = 0; v <= g.n; ++v) {
+        if (!ws.reached(v)) {
+            continue;
+        }
         for (int m = 0; m < kModeCount; ++m) {
-            dist[v][m] = res.time[v][m];
-            parent[v][m] = {res.parent_v[v][m], res.parent_mode[v][m]};
+            dist[v][m] = ws.time(v, m);
+            parent[v][m] = {ws.parent_v(v, m), ws.parent_mode(v, m)};
         }
     }
 }
@@ -178,32 +654,40 @@ DijkstraStateResult dijkstra_states(
     const ModelParams& model,
     int start
 ) {
-    const InternalResult res = run_dijkstra_states(
-        g,
-        start,
-        model.sensitivity,
-        model.trans,
-        model.station_transfer
-    );
+    return dijkstra_states(freeze_graph(g), model, start);
+}
 
+DijkstraStateResult dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start
+) {
     DijkstraStateResult out;
-    out.dist_time.assign(g.n + 1, std::array<double, 3>{kInf, kInf, kInf});
-    out.dist_transfers.assign(g.n + 1, std::array<int, 3>{kInfTransfers, kInfTransfers, kInfTransfers});
-    out.parent_v.assign(g.n + 1, std::array<int, 3>{-1, -1, -1});
-    out.parent_mode.assign(g.n + 1, std::array<int, 3>{-1, -1, -1});
-    out.parent_edge_mode.assign(g.n + 1, std::array<int, 3>{-1, -1, -1});
+    build_path_tree(g, model, start, out); // int вмещает любые пересадки
+    return out;
+}
 
-    for (int v = 0; v <= g.n; ++v) {
-        for (int m = 0; m < 3; ++m) {
-            out.dist_time[v][m] = res.time[v][m];
-            out.dist_transfers[v][m] = res.transfers[v][m];
-            out.parent_v[v][m] = res.parent_v[v][m];
-            out.parent_mode[v][m] = res.parent_mode[v][m];
-            out.parent_edge_mode[v][m] = res.parent_edge_mode[v][m];
-        }
-    }
+void dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    SearchWorkspace& ws
+) {
+    run_dijkstra_states(g, start, model.sensitivity, model.trans, model.station_transfer, ws);
+}
 
-    return out;
+void dijkstra_states(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    int start,
+    const std::vector<int>& targets,
+    SearchWorkspace& ws,
+    const SearchOptions& options
+) {
+    SearchOptions exact; // двоичная куча, точное время
+    exact.arc_weights = options.arc_weights;
+    exact.transfer_model = options.transfer_model;
+    run_dijkstra_states(g, model, start, exact, ws, TargetBound{&targets});
 }
 
 Route build_route_to_target(
@@ -214,89 +698,160 @@ Route build_route_to_target(
     double k
 ) {
     static_cast<void>(model);
+    static_cast<void>(start);
+    return build_route_to_target(dj, target, k);
+}
 
-    Route route;
-    route.target = target;
-
-    if (start == target) {
-        route.reachable = true;
-        route.time = 0.0;
-        route.transfers = 0;
-        route.metric = 0.0;
-        return route;
-    }
-
-    int best_mode = -1;
-    double best_time = kInf;
-    int best_transfers = kInfTransfers;
+Route build_route_to_target(const SearchWorkspace& ws, int target, double k) {
+    return build_route(WorkspaceTables{ws}, ws.start(), target, k);
+}
 
-    if (target >= 0 && target < static_cast<int>(dj.dist_time.size())) {
-        for (int m = 0; m < 3; ++m) {
-            const double t = dj.dist_time[target][m];
-            const int tr = dj.dist_transfers[target][m];
-            if (is_better(t, tr, best_time, best_transfers)) {
-                best_time = t;
-                best_transfers = tr;
-                best_mode = m;
-            }
-        }
-    }
+template <typename Time, typename Transfers>
+bool build_path_tree(const FrozenGraph& g, const ModelParams& model, int start,
+                     PackedStateResult<Time, Transfers>& out) {
+    SearchWorkspace& ws = thread_workspace();
+    dijkstra_states(g, model, start, ws);
+    return out.assign(ws);
+}
 
-    if (best_mode == -1 || !std::isfinite(best_time)) {
-        route.reachable = false;
-        route.time = kInf;
-        route.transfers = kInfTransfers;
-        route.metric = kInf;
-        return route;
+PathTree build_path_tree(const FrozenGraph& g, const ModelParams& model, int start) {
+    PathTree tree;
+    if (!build_path_tree(g, model, start, tree)) {
+        throw std::overflow_error("build_path_tree: too many transfers for PathTree");
     }
+    return tree;
+}
 
-    route.reachable = true;
-    route.time = best_time;
-    route.transfers = best_transfers;
-    route.metric = best_time + k * static_cast<double>(best_transfers);
+template <typename Time, typename Transfers>
+Route build_route_to_target(const PackedStateResult<Time, Transfers>& result, int target, double k) {
+    return build_route(result, result.start(), target, k);
+}
 
-    std::vector<Step> reverse_steps;
-    int v = target;
-    int m = best_mode;
+// Упаковки, которые объявлены в algorithms.hpp.
+template bool build_path_tree(const FrozenGraph&, const ModelParams&, int, DijkstraStateResult&);
+template bool build_path_tree(const FrozenGraph&, const ModelParams&, int, PathTree&);
+template bool build_path_tree(const FrozenGraph&, const ModelParams&, int, CompactPathTree&);
+template Route build_route_to_target(const DijkstraStateResult&, int, double);
+template Route build_route_to_target(const PathTree&, int, double);
+template Route build_route_to_target(const CompactPathTree&, int, double);
 
-    while (v != -1) {
-        const int u = dj.parent_v[v][m];
-        if (u == -1) {
-            break;
-        }
-        reverse_steps.push_back(Step{u, v, dj.parent_edge_mode[v][m]});
-        const int next_mode = dj.parent_mode[v][m];
-        v = u;
-        if (next_mode == kNoMode || next_mode < 0) {
-            break;
-        }
-        m = next_mode;
-    }
+std::vector<Route> solve_request(
+    const Graph& g,
+    const ModelParams& model,
+    const Request& rq
+) {
+    return solve_request(freeze_graph(g), model, rq);
+}
 
-    std::reverse(reverse_steps.begin(), reverse_steps.end());
-    route.steps = std::move(reverse_steps);
-    return route;
+std::vector<Route> solve_request(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    const Request& rq,
+    const SearchOptions& options
+) {
+    return solve_request(g, model, rq, options, thread_workspace());
 }
 
 std::vector<Route> solve_request(
-    const Graph& g,
+    const FrozenGraph& g,
     const ModelParams& model,
-    const Request& rq
+    const Request& rq,
+    const SearchOptions& options,
+    SearchWorkspace& ws
 ) {
-    const DijkstraStateResult dj = dijkstra_states(g, model, rq.start);
+    const PhaseTimer timer(Phase::Search);
+    // Предел пересадок запроса держат только поиски по фронту; без --pareto
+    // такой запрос решает поиск по раундам.
+    const bool capped = rq.max_transfers != std::numeric_limits<int>::max();
+    if ((options.pareto && options.rounds) || (capped && !options.pareto)) {
+        return solve_request_rounds(g, model, rq, {rq.k}, options.max_transfers)[0];
+    }
+    if (options.pareto) {
+        return solve_request_pareto(g, model, rq, {rq.k}, options.max_transfers)[0];
+    }
+    // Предобработка для других весов (после frozen_apply_deltas) не годится:
+    // такой запрос решает обычный поиск.
+    if (options.hierarchy != nullptr && options.hierarchy->version == g.version) {
+        return solve_request_ch(*options.hierarchy, g, model, rq);
+    }
+    if (options.landmarks != nullptr && options.landmarks->version == g.version) {
+        return solve_request_alt(*options.landmarks, g, model, rq);
+    }
+    if (options.tree_cache != nullptr && options.time_resolution <= 0.0) {
+        const std::uint64_t fingerprint =
+            options.model_fingerprint != 0 ? options.model_fingerprint : model_fingerprint(model);
+        const std::shared_ptr<const PathTree> tree = options.tree_cache->get(g, model, fingerprint, rq.start);
+        if (tree != nullptr) {
+            std::vector<Route> routes;
+            routes.reserve(rq.targets.size());
+            for (int target : rq.targets) {
+                routes.push_back(build_route_to_target(*tree, target, rq.k));
+            }
+            if (!routes.empty()) {
+                quicksort_routes(routes, 0, static_cast<int>(routes.size()) - 1);
+            }
+            return routes;
+        }
+        // Дерево не упаковалось (слишком много пересадок): обычный поиск.
+    }
+    if (options.bidirectional && rq.targets.size() == 1
+        && options.queue == QueueKind::BinaryHeap && options.time_resolution <= 0.0) {
+        return {bidirectional_route(g, model, rq.start, rq.targets[0], rq.k, options.arc_weights)};
+    }
+
+    // Поиск ограничен целями запроса; область переиспользуется между
+    // запросами, новый поиск начинается новой эпохой.
+    run_dijkstra_states(g, model, rq.start, options, ws, TargetBound{&rq.targets});
 
+    const bool fixed = options.time_resolution > 0.0;
     std::vector<Route> routes;
     routes.reserve(rq.targets.size());
     for (int target : rq.targets) {
-        routes.push_back(build_route_to_target(dj, model, rq.start, target, rq.k));
+        routes.push_back(build_route(WorkspaceTables{ws}, rq.start, target, rq.k));
+        if (fixed && routes.back().reachable) {
+            // В таблицах — тики; время найденного пути пересчитывается точно.
+            evaluate_route(g, model, routes.back(), rq.k);
+        }
     }
-
     if (!routes.empty()) {
         quicksort_routes(routes, 0, static_cast<int>(routes.size()) - 1);
     }
     return routes;
 }
 
+void evaluate_route(
+    const FrozenGraph& g,
+    const ModelParams& model,
+    Route& route,
+    double k
+) {
+    double time = 0.0;
+    int transfers = 0;
+    int prev_mode = kNoMode;
+
+    for (const Step& st : route.steps) {
+        double penalty = 0.0;
+        if (prev_mode != kNoMode && prev_mode != st.mode) {
+            penalty = model.trans[prev_mode][st.mode] + model.station_transfer[st.from];
+            ++transfers;
+        }
+        // Среди параллельных рёбер вида st.mode поиск выбирает самое быстрое.
+        double best = kInf;
+        const int arc_end = g.mode_end(st.from, st.mode);
+        for (int a = g.mode_begin(st.from, st.mode); a < arc_end; ++a) {
+            if (g.to[static_cast<std::size_t>(a)] == st.to) {
+                best = std::min(best, arc_time(g, a, st.mode, model.sensitivity));
+            }
+        }
+        time = time + (best + penalty);
+        prev_mode = st.mode;
+    }
+
+    route.time = time;
+    route.transfers = transfers;
+    route.metric = time + k * static_cast<double>(transfers);
+}
+
 void quicksort_routes(std::vector<Route>& a, int l, int r) {
     int i = l;
     int j = r;
@@ -323,3 +878,21 @@ void quicksort_routes(std::vector<Route>& a, int l, int r) {
         quicksort_routes(a, i, r);
     }
 }
+
+TransferModel classify_transfer_model(const ModelParams& model) {
+    const double trans = model.trans[0][1];
+    for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+            if (a != b && model.trans[a][b] != trans) {
+                return TransferModel::Matrix;
+            }
+        }
+    }
+    // station_transfer[0] не используется (станции с 1).
+    for (std::size_t v = 2; v < model.station_transfer.size(); ++v) {
+        if (model.station_transfer[v] != model.station_transfer[1]) {
+            return TransferModel::Matrix;
+        }
+    }
+    return uniform_transfer_penalty(model) == 0.0 ? TransferModel::Plain : TransferModel::Uniform;
+}
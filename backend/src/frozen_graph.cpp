@@ -0,0 +1,184 @@
+#include "frozen_graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+std::size_t FrozenGraph::memory_bytes() const {
+    return offsets.size() * sizeof(int)
+         + to.size() * sizeof(int)
+         + edge_id.size() * sizeof(int)
+         + base_time.size() * sizeof(double)
+         + load.size() * sizeof(double)
+         + (weights ? weights->arc_of_edge.size() * sizeof(int) : 0);
+}
+
+namespace {
+
+// Хранилище снимка, построенного в памяти.
+struct FrozenStorage {
+    std::vector<int> offsets;
+    std::vector<int> to;
+    std::vector<int> edge_id;
+    std::vector<double> base_time;
+    std::vector<double> load;
+};
+
+} // namespace
+
+std::uint64_t next_weights_version() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+FrozenGraph freeze_graph(const Graph& g) {
+    auto st = std::make_shared<FrozenStorage>();
+
+    const std::size_t rows = static_cast<std::size_t>(g.n) + 1;
+    st->offsets.assign(3 * rows + 1, 0);
+
+    // Подсчет: сколько рёбер каждого вида выходит из u.
+    for (int u = 1; u <= g.n; ++u) {
+        for (const Edge& e : g.adj[u]) {
+            ++st->offsets[3 * static_cast<std::size_t>(u) + static_cast<std::size_t>(e.mode) + 1];
+        }
+    }
+    for (std::size_t i = 1; i < st->offsets.size(); ++i) {
+        st->offsets[i] += st->offsets[i - 1];
+    }
+
+    const std::size_t arcs = static_cast<std::size_t>(st->offsets.back());
+    st->to.resize(arcs);
+    st->edge_id.resize(arcs);
+    st->base_time.resize(arcs);
+    st->load.resize(arcs);
+
+    // Раскладка: внутри среза (u, mode) сохраняется исходный порядок Adj[u].
+    std::vector<int> cursor(st->offsets.begin(), st->offsets.end() - 1);
+    for (int u = 1; u <= g.n; ++u) {
+        for (const Edge& e : g.adj[u]) {
+            const std::size_t slot = static_cast<std::size_t>(
+                cursor[3 * static_cast<std::size_t>(u) + static_cast<std::size_t>(e.mode)]++);
+            st->to[slot] = e.to;
+            st->edge_id[slot] = e.id;
+            st->base_time[slot] = e.base_time;
+            st->load[slot] = e.load;
+        }
+    }
+
+    FrozenGraph fg;
+    fg.n = g.n;
+    fg.m = g.m;
+    fg.offsets = st->offsets;
+    fg.to = st->to;
+    fg.edge_id = st->edge_id;
+    fg.base_time = st->base_time;
+    fg.load = st->load;
+    fg.storage = std::move(st);
+    fg.version = next_weights_version();
+    return fg;
+}
+
+namespace {
+
+bool valid_weights(double base_time, double load) {
+    return std::isfinite(base_time) && base_time >= 0.0 && load >= 0.0 && load <= 1.0;
+}
+
+// Подготовить снимок к изменению весов: собственная (не разделенная с
+// копиями) память весов и индекс дуг по id.
+FrozenWeights& writable_weights(FrozenGraph& g) {
+    if (g.weights && g.weights.use_count() == 1) {
+        return *g.weights;
+    }
+    std::shared_ptr<FrozenWeights> w;
+    if (g.weights) {
+        w = std::make_shared<FrozenWeights>(*g.weights);
+    } else {
+        w = std::make_shared<FrozenWeights>();
+        w->base_time.assign(g.base_time.begin(), g.base_time.end());
+        w->load.assign(g.load.begin(), g.load.end());
+        int max_id = -1;
+        for (int id : g.edge_id) {
+            max_id = std::max(max_id, id);
+        }
+        w->arc_of_edge.assign(2 * static_cast<std::size_t>(max_id + 1), -1);
+        for (std::size_t arc = 0; arc < g.edge_id.size(); ++arc) {
+            const std::size_t i = 2 * static_cast<std::size_t>(g.edge_id[arc]);
+            w->arc_of_edge[w->arc_of_edge[i] < 0 ? i : i + 1] = static_cast<int>(arc);
+        }
+    }
+    g.weights = std::move(w);
+    g.base_time = g.weights->base_time;
+    g.load = g.weights->load;
+    return *g.weights;
+}
+
+bool known_edge(const FrozenWeights& w, int id) {
+    return id >= 0 && static_cast<std::size_t>(id) < w.arc_of_edge.size() / 2
+        && w.arc_of_edge[2 * static_cast<std::size_t>(id)] >= 0;
+}
+
+void set_weights(FrozenWeights& w, int id, double base_time, double load) {
+    for (std::size_t k = 0; k < 2; ++k) {
+        const std::size_t arc = static_cast<std::size_t>(w.arc_of_edge[2 * static_cast<std::size_t>(id) + k]);
+        w.base_time[arc] = base_time;
+        w.load[arc] = load;
+    }
+}
+
+} // namespace
+
+bool frozen_update_edge(FrozenGraph& g, int id, double base_time, double load) {
+    if (!std::isfinite(base_time) || base_time < 0.0)
+        throw std::invalid_argument("frozen_update_edge: base_time must be finite and >= 0");
+    if (!(load >= 0.0 && load <= 1.0))
+        throw std::invalid_argument("frozen_update_edge: load must be in [0,1]");
+
+    FrozenWeights& w = writable_weights(g);
+    if (!known_edge(w, id)) {
+        return false;
+    }
+    set_weights(w, id, base_time, load);
+    g.version = next_weights_version();
+    return true;
+}
+
+bool frozen_apply_deltas(FrozenGraph& g, const std::vector<EdgeDelta>& deltas, std::string& error) {
+    error.clear();
+    if (deltas.empty()) {
+        return true;
+    }
+    FrozenWeights& w = writable_weights(g);
+    for (std::size_t i = 0; i < deltas.size(); ++i) {
+        const EdgeDelta& d = deltas[i];
+        if (!known_edge(w, d.id)) {
+            error = "deltas: unknown edge id " + std::to_string(d.id) + " in delta " + std::to_string(i + 1);
+            return false;
+        }
+        if (!valid_weights(d.base_time, d.load)) {
+            error = "deltas: invalid base_time or load for edge " + std::to_string(d.id);
+            return false;
+        }
+    }
+    for (const EdgeDelta& d : deltas) {
+        set_weights(w, d.id, d.base_time, d.load);
+    }
+    g.version = next_weights_version();
+    return true;
+}
+
+std::size_t graph_memory_bytes(const Graph& g) {
+    std::size_t bytes = g.adj.capacity() * sizeof(std::vector<Edge>);
+    for (const auto& row : g.adj) {
+        bytes += row.capacity() * sizeof(Edge);
+    }
+    for (const auto& by_mode : g.adjacency) {
+        bytes += by_mode.capacity() * sizeof(std::vector<int>);
+        for (const auto& row : by_mode) {
+            bytes += row.capacity() * sizeof(int);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,493 @@
+#include "generator.hpp"
+#include "output_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// splitmix64: последовательность зависит только от seed (в отличие от
+// std::uniform_*_distribution, которые различаются между библиотеками).
+struct Rng {
+    std::uint64_t state;
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    double uniform() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    // [0, n), n > 0
+    int below(int n) {
+        return static_cast<int>(next() % static_cast<std::uint64_t>(n));
+    }
+};
+
+// Сотые: такое число печатается двумя знаками и читается обратно тем же double.
+double round2(double x) {
+    return std::round(x * 100.0) / 100.0;
+}
+
+struct Cell {
+    int r = 0;
+    int c = 0;
+};
+
+class CityBuilder {
+public:
+    CityBuilder(const GeneratorParams& p, GeneratedNetwork& net)
+        : p_(p), net_(net), rng_{p.seed} {
+        grid_ = p.stations - p.pockets * p.pocket_size;
+        side_ = static_cast<int>(std::sqrt(static_cast<double>(grid_)));
+        while (static_cast<long long>(side_ + 1) * (side_ + 1) <= grid_) ++side_;
+        while (static_cast<long long>(side_) * side_ > grid_) --side_;
+        rows_ = (grid_ + side_ - 1) / side_;
+        full_rows_ = grid_ / side_;
+        center_ = Cell{(full_rows_ - 1) / 2, side_ / 2};
+        max_dist_ = std::max(1.0, std::hypot(0.5 * rows_, 0.5 * side_));
+        net_.n = p.stations;
+        net_.side = side_;
+    }
+
+    void build() {
+        net_.edges.reserve(2 * static_cast<std::size_t>(grid_) + static_cast<std::size_t>(p_.pockets * p_.pocket_size));
+        build_bus();
+        build_metro();
+        build_rail();
+        build_pockets();
+        build_model();
+        build_requests();
+        build_matrices();
+    }
+
+private:
+    bool valid(Cell x) const {
+        return x.r >= 0 && x.c >= 0 && x.c < side_ && x.r < rows_
+            && static_cast<long long>(x.r) * side_ + x.c < grid_;
+    }
+
+    int id(Cell x) const {
+        return x.r * side_ + x.c + 1;
+    }
+
+    Cell cell_of(int v) const {
+        return Cell{(v - 1) / side_, (v - 1) % side_};
+    }
+
+    double dist(Cell a, Cell b) const {
+        return std::hypot(static_cast<double>(a.r - b.r), static_cast<double>(a.c - b.c));
+    }
+
+    double draw_load(Cell a, Cell b) {
+        const double mid_r = 0.5 * (a.r + b.r);
+        const double mid_c = 0.5 * (a.c + b.c);
+        const double r_norm = std::min(1.0, std::hypot(mid_r - center_.r, mid_c - center_.c) / max_dist_);
+        const double u = rng_.uniform();
+        double x = 0.0;
+        switch (p_.load) {
+        case LoadProfile::Uniform:
+            x = u;
+            break;
+        case LoadProfile::Center:
+            x = std::clamp(0.15 + 0.75 * (1.0 - r_norm) + 0.2 * (u - 0.5), 0.0, 1.0);
+            break;
+        case LoadProfile::Bimodal:
+            x = rng_.uniform() < 0.25 ? 0.7 + 0.3 * u : 0.3 * u;
+            break;
+        }
+        return std::clamp(round2(x * p_.load_max), 0.0, 1.0);
+    }
+
+    void add(Cell a, Cell b, int mode, double base_time) {
+        net_.edges.push_back(GeneratedEdge{id(a), id(b), mode, round2(base_time), draw_load(a, b)});
+    }
+
+    // Плотная сетка автобусов: вправо и вниз от каждой клетки.
+    void build_bus() {
+        for (int r = 0; r < rows_; ++r) {
+            for (int c = 0; c < side_; ++c) {
+                const Cell a{r, c};
+                if (!valid(a)) {
+                    break;
+                }
+                for (const Cell b : {Cell{r, c + 1}, Cell{r + 1, c}}) {
+                    if (valid(b) && rng_.uniform() < p_.bus_density) {
+                        add(a, b, 1, 1.5 + 1.5 * rng_.uniform());
+                    }
+                }
+            }
+        }
+    }
+
+    // Линия по точкам: соседние различные допустимые точки соединяются;
+    // недопустимая точка (за краем города) разрывает линию.
+    void add_line(const std::vector<Cell>& points, int mode, bool closed) {
+        std::vector<Cell> stops;
+        bool broken = false;
+        for (const Cell x : points) {
+            if (!valid(x)) {
+                broken = true;
+                if (stops.size() > 1) {
+                    connect(stops, mode, false);
+                }
+                stops.clear();
+                continue;
+            }
+            if (stops.empty() || stops.back().r != x.r || stops.back().c != x.c) {
+                stops.push_back(x);
+            }
+        }
+        if (stops.size() > 1) {
+            connect(stops, mode, closed && !broken && stops.size() > 2);
+        }
+    }
+
+    void connect(const std::vector<Cell>& stops, int mode, bool closed) {
+        const std::size_t count = closed ? stops.size() : stops.size() - 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            const Cell a = stops[i];
+            const Cell b = stops[(i + 1) % stops.size()];
+            if (a.r == b.r && a.c == b.c) {
+                continue;
+            }
+            const double d = dist(a, b);
+            add(a, b, mode, mode == 0 ? 0.5 + 0.6 * d : 1.0 + 0.35 * d);
+        }
+        if (mode == 0) {
+            for (const Cell x : stops) {
+                hubs_.push_back(id(x));
+            }
+        }
+    }
+
+    Cell polar(double radius, double angle) const {
+        return Cell{center_.r + static_cast<int>(std::lround(radius * std::sin(angle))),
+                    center_.c + static_cast<int>(std::lround(radius * std::cos(angle)))};
+    }
+
+    // Метро: радиусы из центра и кольца. Радиус кольца кратен шагу станций,
+    // а число станций кольца кратно числу радиусов, поэтому кольцо проходит
+    // через станции радиусов — там пересадочные узлы.
+    void build_metro() {
+        const int s = p_.metro_spacing;
+        const double turn = 2.0 * kPi * rng_.uniform();
+        const int reach = std::max(rows_, side_);
+        for (int i = 0; i < p_.metro_radials; ++i) {
+            const double angle = turn + 2.0 * kPi * i / p_.metro_radials;
+            std::vector<Cell> points;
+            for (int k = 0; k * s <= reach; ++k) {
+                const Cell x = polar(static_cast<double>(k) * s, angle);
+                if (!valid(x)) {
+                    break;
+                }
+                points.push_back(x);
+            }
+            add_line(points, 0, false);
+        }
+
+        int ring_step = p_.ring_spacing;
+        if (ring_step <= 0) {
+            ring_step = std::min(full_rows_, side_) / (2 * (p_.metro_rings + 1));
+        }
+        ring_step = std::max(s, ring_step / s * s);
+        const int per_radial = std::max(1, p_.metro_radials);
+        for (int j = 1; j <= p_.metro_rings; ++j) {
+            const double radius = static_cast<double>(j) * ring_step;
+            const int segments = std::max(1, static_cast<int>(std::lround(2.0 * kPi * radius / (s * per_radial))));
+            const int count = std::max(6, segments * per_radial);
+            std::vector<Cell> points;
+            for (int t = 0; t < count; ++t) {
+                points.push_back(polar(radius, turn + 2.0 * kPi * t / count));
+            }
+            add_line(points, 0, true);
+        }
+
+        std::sort(hubs_.begin(), hubs_.end());
+        hubs_.erase(std::unique(hubs_.begin(), hubs_.end()), hubs_.end());
+    }
+
+    // Коридоры через весь город: четные — с запада на восток, нечетные — с
+    // севера на юг; концы на противоположных краях выбираются случайно.
+    void build_rail() {
+        const int last_row = full_rows_ - 1;
+        for (int i = 0; i < p_.rail_corridors; ++i) {
+            Cell from;
+            Cell to;
+            if (i % 2 == 0) {
+                from = Cell{rng_.below(full_rows_), 0};
+                to = Cell{rng_.below(full_rows_), side_ - 1};
+            } else {
+                from = Cell{0, rng_.below(side_)};
+                to = Cell{last_row, rng_.below(side_)};
+            }
+            const double length = dist(from, to);
+            const int stops = std::max(1, static_cast<int>(std::lround(length / p_.rail_spacing)));
+            std::vector<Cell> points;
+            for (int k = 0; k <= stops; ++k) {
+                const double t = static_cast<double>(k) / stops;
+                points.push_back(Cell{from.r + static_cast<int>(std::lround(t * (to.r - from.r))),
+                                      from.c + static_cast<int>(std::lround(t * (to.c - from.c)))});
+            }
+            add_line(points, 2, false);
+        }
+    }
+
+    // Карманы: цепочка автобусов, замкнутая ребром метро (если станций >= 3).
+    void build_pockets() {
+        for (int k = 0; k < p_.pockets; ++k) {
+            const int first = grid_ + k * p_.pocket_size + 1;
+            const int last = first + p_.pocket_size - 1;
+            for (int v = first; v < last; ++v) {
+                net_.edges.push_back(GeneratedEdge{v, v + 1, 1, round2(1.5 + 1.5 * rng_.uniform()),
+                                                   round2(rng_.uniform() * p_.load_max)});
+            }
+            if (p_.pocket_size >= 3) {
+                net_.edges.push_back(GeneratedEdge{last, first, 0, round2(1.0 + rng_.uniform()),
+                                                   round2(rng_.uniform() * p_.load_max)});
+            }
+        }
+    }
+
+    void build_model() {
+        ModelParams& m = net_.model;
+        m.sensitivity = {0.4, 1.0, 0.2};
+        m.trans = {{{0.0, 1.5, 3.0}, {1.5, 0.0, 2.0}, {3.0, 2.0, 0.0}}};
+        m.station_transfer.assign(static_cast<std::size_t>(net_.n) + 1, 0.0);
+        for (int v = 1; v <= net_.n; ++v) {
+            m.station_transfer[static_cast<std::size_t>(v)] = round2(0.2 + 0.6 * rng_.uniform());
+        }
+    }
+
+    int grid_station() {
+        return 1 + rng_.below(grid_);
+    }
+
+    int near_station(int v) {
+        const Cell x = cell_of(v);
+        const int span = 2 * p_.local_radius + 1;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            const Cell y{x.r + rng_.below(span) - p_.local_radius, x.c + rng_.below(span) - p_.local_radius};
+            if (valid(y)) {
+                return id(y);
+            }
+        }
+        return v;
+    }
+
+    int hub_or_grid() {
+        return hubs_.empty() ? grid_station() : hubs_[static_cast<std::size_t>(rng_.below(static_cast<int>(hubs_.size())))];
+    }
+
+    void build_requests() {
+        static const double kCoefficients[] = {0.0, 0.5, 1.0, 2.0, 5.0};
+        const double local = p_.mix_local;
+        const double cross = local + p_.mix_cross;
+        const double hub = cross + p_.mix_hub;
+        const double total = hub + (p_.pockets > 0 ? p_.mix_pocket : 0.0);
+
+        net_.requests.resize(static_cast<std::size_t>(p_.queries));
+        for (Request& rq : net_.requests) {
+            const double kind = rng_.uniform() * total;
+            const int count = 1 + rng_.below(p_.max_targets);
+            rq.k = kCoefficients[rng_.below(5)];
+            rq.targets.reserve(static_cast<std::size_t>(count));
+            if (kind < local) {
+                rq.start = grid_station();
+                for (int t = 0; t < count; ++t) {
+                    rq.targets.push_back(near_station(rq.start));
+                }
+            } else if (kind < cross) {
+                rq.start = grid_station();
+                for (int t = 0; t < count; ++t) {
+                    rq.targets.push_back(grid_station());
+                }
+            } else if (kind < hub) {
+                rq.start = hub_or_grid();
+                for (int t = 0; t < count; ++t) {
+                    rq.targets.push_back(hub_or_grid());
+                }
+            } else {
+                rq.start = grid_station();
+                rq.targets.push_back(grid_ + 1 + rng_.below(p_.pockets * p_.pocket_size));
+                for (int t = 1; t < count; ++t) {
+                    rq.targets.push_back(grid_station());
+                }
+            }
+        }
+    }
+
+    void build_matrices() {
+        net_.matrices.resize(static_cast<std::size_t>(p_.matrices));
+        for (MatrixRequest& mr : net_.matrices) {
+            for (int i = 0; i < p_.matrix_size; ++i) {
+                mr.sources.push_back(grid_station());
+            }
+            for (int i = 0; i < p_.matrix_size; ++i) {
+                mr.targets.push_back(grid_station());
+            }
+        }
+    }
+
+    const GeneratorParams& p_;
+    GeneratedNetwork& net_;
+    Rng rng_;
+    int grid_ = 0;
+    int side_ = 0;
+    int rows_ = 0;
+    int full_rows_ = 0;
+    Cell center_;
+    double max_dist_ = 1.0;
+    std::vector<int> hubs_;
+};
+
+void check_params(const GeneratorParams& p) {
+    auto require = [](bool ok, const char* what) {
+        if (!ok) throw std::invalid_argument(std::string("generate_network: ") + what);
+    };
+    require(p.pockets >= 0 && p.pocket_size >= 1, "pockets must be >= 0 and pocket_size >= 1");
+    require(static_cast<long long>(p.pockets) * p.pocket_size <= p.stations - 4LL,
+            "stations must leave at least 4 for the city after the pockets");
+    require(p.bus_density >= 0.0 && p.bus_density <= 1.0, "bus_density must be in [0,1]");
+    require(p.metro_radials >= 0 && p.metro_rings >= 0 && p.rail_corridors >= 0, "line counts must be >= 0");
+    require(p.metro_spacing >= 1 && p.rail_spacing >= 1 && p.ring_spacing >= 0, "spacings must be >= 1");
+    require(p.load_max >= 0.0 && p.load_max <= 1.0, "load_max must be in [0,1]");
+    require(p.queries >= 0 && p.max_targets >= 1 && p.local_radius >= 1, "invalid query parameters");
+    require(p.mix_local >= 0.0 && p.mix_cross >= 0.0 && p.mix_hub >= 0.0 && p.mix_pocket >= 0.0
+                && p.mix_local + p.mix_cross + p.mix_hub > 0.0,
+            "query mix must be >= 0 with a non-zero local, cross or hub share");
+    require(p.matrices >= 0 && p.matrix_size >= 1, "invalid matrix parameters");
+}
+
+// Строки чисел через пробел поверх OutputBuffer.
+class TextWriter {
+public:
+    explicit TextWriter(std::ostream& out) : buf_(&out) {}
+
+    void put(int x) {
+        sep();
+        buf_.put_int(x);
+    }
+
+    void put(double x) {
+        sep();
+        buf_.put_fixed(x, 2);
+    }
+
+    void put_word(std::string_view word) {
+        sep();
+        buf_.append(word);
+    }
+
+    void end_line() {
+        buf_.put('\n');
+        line_start_ = true;
+    }
+
+private:
+    void sep() {
+        if (!line_start_) {
+            buf_.put(' ');
+        }
+        line_start_ = false;
+    }
+
+    OutputBuffer buf_;
+    bool line_start_ = true;
+};
+
+void write_requests(TextWriter& w, const GeneratedNetwork& net) {
+    w.put(static_cast<int>(net.requests.size()));
+    w.end_line();
+    for (const Request& rq : net.requests) {
+        w.put(rq.start);
+        w.put(static_cast<int>(rq.targets.size()));
+        w.put(rq.k);
+        for (const int t : rq.targets) {
+            w.put(t);
+        }
+        w.end_line();
+    }
+    if (net.matrices.empty()) {
+        return;
+    }
+    w.put_word("matrix");
+    w.put(static_cast<int>(net.matrices.size()));
+    w.end_line();
+    for (const MatrixRequest& mr : net.matrices) {
+        w.put(static_cast<int>(mr.sources.size()));
+        for (const int s : mr.sources) {
+            w.put(s);
+        }
+        w.put(static_cast<int>(mr.targets.size()));
+        for (const int t : mr.targets) {
+            w.put(t);
+        }
+        w.end_line();
+    }
+}
+
+} // namespace
+
+GeneratedNetwork generate_network(const GeneratorParams& params) {
+    check_params(params);
+    GeneratedNetwork net;
+    CityBuilder(params, net).build();
+    return net;
+}
+
+Graph generated_graph(const GeneratedNetwork& net) {
+    Graph g;
+    graph_init(g, net.n);
+    for (const GeneratedEdge& e : net.edges) {
+        graph_add_undirected(g, e.u, e.v, e.mode, e.base_time, e.load);
+    }
+    return g;
+}
+
+void write_network_text(std::ostream& out, const GeneratedNetwork& net) {
+    TextWriter w(out);
+    w.put(net.n);
+    w.put(static_cast<int>(net.edges.size()));
+    w.end_line();
+    for (const double s : net.model.sensitivity) {
+        w.put(s);
+    }
+    w.end_line();
+    for (const auto& row : net.model.trans) {
+        for (const double x : row) {
+            w.put(x);
+        }
+        w.end_line();
+    }
+    for (int v = 1; v <= net.n; ++v) {
+        w.put(net.model.station_transfer[static_cast<std::size_t>(v)]);
+        if (v % 16 == 0 || v == net.n) {
+            w.end_line();
+        }
+    }
+    for (const GeneratedEdge& e : net.edges) {
+        w.put(e.u);
+        w.put(e.v);
+        w.put(e.mode);
+        w.put(e.base_time);
+        w.put(e.load);
+        w.end_line();
+    }
+    write_requests(w, net);
+}
+
+void write_requests_text(std::ostream& out, const GeneratedNetwork& net) {
+    TextWriter w(out);
+    write_requests(w, net);
+}
@@ -1,133 +1,648 @@
 #include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "batch.hpp"
+#include "contraction.hpp"
+#include "landmarks.hpp"
+#include "matrix.hpp"
 #include "parser.hpp"
+#include "path_tree_cache.hpp"
+#include "report.hpp"
+#include "service.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
 #include "validator.hpp"
 
-#include <iomanip>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace {
 
-const char* mode_label(int mode) {
-    switch (mode) {
-        case MODE_METRO:
-            return "metro";
-        case MODE_BUS:
-            return "bus";
-        case MODE_RAIL:
-            return "rail";
-        default:
-            return "unknown";
+struct Options {
+    int threads = 1; // 0 — по числу ядер
+    bool serve = false;
+    ServiceOptions service;
+    std::string convert_path;  // --convert: записать снимок сети и выйти
+    std::string snapshot_path; // --snapshot: сеть из снимка, в stdin только запросы
+    bool verify = false;       // --verify: проверять контрольную сумму данных снимка
+    std::string deltas_path;   // --deltas: файл изменений весов рёбер
+    SearchOptions search;      // --queue, --resolution, --pareto, --rounds, --max-transfers
+    bool hierarchy = false;    // --ch: предобработка иерархии сжатий
+    int landmarks = 0;         // --alt N: число ориентиров для A*, 0 — без A*
+    int cache_mb = 0;          // --cache MB: кэш деревьев кратчайших путей, 0 — без кэша
+    std::string matrix_path;   // --matrix-out: матрицы в бинарный файл, в stdout — только заголовки
+    bool stats = false;        // --stats: счетчики и время фаз одной строкой JSON в stderr
+    ReportFormat format = ReportFormat::Text; // --format text|json: вид отчета в stdout
+};
+
+bool parse_thread_count(const std::string& text, int& threads) {
+    char* end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > 1024) {
+        return false;
     }
+    threads = static_cast<int>(value);
+    return true;
 }
 
-std::string format_path(const Route& route, int start) {
-    if (!route.reachable) {
-        return "unreachable";
+bool parse_queue_kind(const std::string& text, QueueKind& queue) {
+    if (text == "heap") {
+        queue = QueueKind::BinaryHeap;
+        return true;
+    }
+    if (text == "radix") {
+        queue = QueueKind::Radix;
+        return true;
     }
+    return false;
+}
 
-    if (route.steps.empty()) {
-        return std::to_string(start);
+bool parse_landmark_count(const std::string& text, int& count) {
+    char* end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > 64) {
+        return false;
     }
+    count = static_cast<int>(value);
+    return true;
+}
 
-    std::ostringstream out;
-    for (std::size_t i = 0; i < route.steps.size(); ++i) {
-        const Step& step = route.steps[i];
-        out << step.from << "-[" << mode_label(step.mode) << "]->" << step.to;
-        if (i + 1 < route.steps.size()) {
-            out << ' ';
-        }
+bool parse_resolution(const std::string& text, double& resolution) {
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || !(value >= 0.0) || value > 1e6) {
+        return false;
     }
-    return out.str();
+    resolution = value;
+    return true;
 }
 
-void print_route_formatted(const Route& route, int start) {
-    std::cout << "Destination: " << route.target << " | ";
+bool parse_cache_size(const std::string& text, int& megabytes) {
+    char* end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > (1L << 20)) {
+        return false;
+    }
+    megabytes = static_cast<int>(value);
+    return true;
+}
 
-    if (!route.reachable) {
-        std::cout << "Time: INF | Transfers: INF | Metric: INF | Path: unreachable\n";
-        return;
+bool parse_report_format(const std::string& text, ReportFormat& format) {
+    if (text == "text") {
+        format = ReportFormat::Text;
+        return true;
+    }
+    if (text == "json") {
+        format = ReportFormat::Json;
+        return true;
     }
+    return false;
+}
 
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Time: " << route.time
-              << " | Transfers: " << route.transfers
-              << " | Metric: " << route.metric
-              << " | Path: " << format_path(route, start) << '\n';
+bool parse_max_transfers(const std::string& text, int& count) {
+    char* end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > 1000000) {
+        return false;
+    }
+    count = static_cast<int>(value);
+    return true;
 }
 
-std::vector<std::vector<int>> get_isolated_components(const Graph& g, TransportType type) {
-    std::vector<std::vector<int>> components = get_connected_components(g, type);
-    if (!components.empty()) {
-        components.erase(components.begin());
+// "[HOST:]PORT"
+bool parse_endpoint(const std::string& text, ServiceOptions& service) {
+    std::string port = text;
+    const std::size_t colon = text.rfind(':');
+    if (colon != std::string::npos) {
+        service.host = text.substr(0, colon);
+        port = text.substr(colon + 1);
     }
-    return components;
+    char* end = nullptr;
+    const long value = std::strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || value <= 0 || value > 65535 || service.host.empty()) {
+        return false;
+    }
+    service.port = static_cast<int>(value);
+    return true;
 }
 
-void print_isolated_zones(const Graph& g, TransportType type, const std::string& label) {
-    std::cout << "ISOLATED ZONES (" << label << ")\n";
-    const std::vector<std::vector<int>> zones = get_isolated_components(g, type);
-    if (zones.empty()) {
-        std::cout << "None\n";
-        return;
+// Значение опции: "--name value" или "--name=value".
+bool option_value(int argc, char** argv, int& i, const std::string& name, std::string& value, bool& matched) {
+    const std::string arg = argv[i];
+    matched = false;
+    if (arg == name) {
+        matched = true;
+        if (i + 1 >= argc) {
+            return false;
+        }
+        value = argv[++i];
+        return true;
+    }
+    if (arg.rfind(name + "=", 0) == 0) {
+        matched = true;
+        value = arg.substr(name.size() + 1);
+        return true;
     }
-    for (std::size_t i = 0; i < zones.size(); ++i) {
-        const auto& zone = zones[i];
-        std::cout << (i + 1) << ". " << zone.size() << " stations: ";
-        for (std::size_t j = 0; j < zone.size(); ++j) {
-            std::cout << zone[j];
-            if (j + 1 < zone.size()) {
-                std::cout << ' ';
+    return true;
+}
+
+bool parse_options(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        bool matched = false;
+
+        if (!option_value(argc, argv, i, "--threads", value, matched)) {
+            error = "options: --threads requires a value";
+            return false;
+        }
+        if (matched) {
+            if (!parse_thread_count(value, options.threads)) {
+                error = "options: --threads must be an integer in [0, 1024]";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--serve", value, matched)) {
+            error = "options: --serve requires [HOST:]PORT";
+            return false;
+        }
+        if (matched) {
+            options.serve = true;
+            if (!parse_endpoint(value, options.service)) {
+                error = "options: --serve expects [HOST:]PORT";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--connections", value, matched)) {
+            error = "options: --connections requires a value";
+            return false;
+        }
+        if (matched) {
+            int count = 0;
+            if (!parse_thread_count(value, count) || count < 1) {
+                error = "options: --connections must be an integer in [1, 1024]";
+                return false;
+            }
+            options.service.max_connections = count;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--convert", value, matched)) {
+            error = "options: --convert requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.convert_path = value;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--snapshot", value, matched)) {
+            error = "options: --snapshot requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.snapshot_path = value;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--deltas", value, matched)) {
+            error = "options: --deltas requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.deltas_path = value;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--queue", value, matched)) {
+            error = "options: --queue requires heap or radix";
+            return false;
+        }
+        if (matched) {
+            if (!parse_queue_kind(value, options.search.queue)) {
+                error = "options: --queue must be heap or radix";
+                return false;
             }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--resolution", value, matched)) {
+            error = "options: --resolution requires a value";
+            return false;
         }
-        std::cout << '\n';
+        if (matched) {
+            if (!parse_resolution(value, options.search.time_resolution)) {
+                error = "options: --resolution must be a number in [0, 1e6]";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--alt", value, matched)) {
+            error = "options: --alt requires a landmark count";
+            return false;
+        }
+        if (matched) {
+            if (!parse_landmark_count(value, options.landmarks)) {
+                error = "options: --alt must be an integer in [0, 64]";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--cache", value, matched)) {
+            error = "options: --cache requires a size in MB";
+            return false;
+        }
+        if (matched) {
+            if (!parse_cache_size(value, options.cache_mb)) {
+                error = "options: --cache must be an integer in [0, 1048576]";
+                return false;
+            }
+            options.service.cache_bytes = static_cast<std::size_t>(options.cache_mb) << 20;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--matrix-out", value, matched)) {
+            error = "options: --matrix-out requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.matrix_path = value;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--max-transfers", value, matched)) {
+            error = "options: --max-transfers requires a value";
+            return false;
+        }
+        if (matched) {
+            if (!parse_max_transfers(value, options.search.max_transfers)) {
+                error = "options: --max-transfers must be an integer in [0, 1000000]";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--format", value, matched)) {
+            error = "options: --format requires text or json";
+            return false;
+        }
+        if (matched) {
+            if (!parse_report_format(value, options.format)) {
+                error = "options: --format must be text or json";
+                return false;
+            }
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--pareto") {
+            options.search.pareto = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--rounds") {
+            options.search.pareto = true;
+            options.search.rounds = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--bidirectional") {
+            options.search.bidirectional = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--ch") {
+            options.hierarchy = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--verify") {
+            options.verify = true;
+            continue;
+        }
+
+        if (std::string(argv[i]) == "--stats") {
+            options.stats = true;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--network", value, matched)) {
+            error = "options: --network requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.service.network_path = value;
+            continue;
+        }
+
+        error = std::string("options: unknown option ") + argv[i];
+        return false;
     }
+    if (options.threads == 0) {
+        options.threads = default_thread_count();
+    }
+    return true;
 }
 
-} // namespace
+// Сообщение разбора не меняется; позиция печатается отдельной строкой.
+void report_parse_error(const std::string& error, const ParseLocation& where) {
+    std::cerr << error << "\n";
+    if (where.line > 0) {
+        std::cerr << "  at line " << where.line << ", column " << where.column << "\n";
+    }
+}
 
-int main() {
-    InputData data;
+// --deltas: новые веса рёбер применяются к снимку одним пакетом (топология
+// и зоны не меняются).
+bool apply_delta_file(const Options& options, FrozenGraph& fg) {
+    if (options.deltas_path.empty()) {
+        return true;
+    }
+    std::ifstream in(options.deltas_path, std::ios::binary);
+    if (!in) {
+        std::cerr << "deltas: cannot open " << options.deltas_path << "\n";
+        return false;
+    }
+    std::vector<EdgeDelta> deltas;
     std::string error;
-
-    if (!parse_all(std::cin, data, error)) {
+    ParseLocation where;
+    if (!parse_deltas(in, deltas, error, &where)) {
+        report_parse_error(error, where);
+        return false;
+    }
+    if (!frozen_apply_deltas(fg, deltas, error)) {
         std::cerr << error << "\n";
-        return 1;
+        return false;
+    }
+    return true;
+}
+
+// Запросы решаются параллельно, печать — строго в порядке запросов.
+// С --ch иерархия, с --alt ориентиры строятся один раз на пакет (если
+// запросы есть); при обоих флагах отвечает иерархия, ориентиры не нужны.
+// С --cache запросы без --ch и --alt отвечаются по кэшу деревьев, счетчики
+// кэша печатаются в stderr. С --pareto отвечает Парето-поиск, предобработка
+// для него не строится. После блоков REQUEST — блоки MATRIX (с --ch — по
+// иерархии, она строится и ради одних матриц); с --matrix-out ячейки идут
+// в файл. Без предобработки поиски читают веса дуг, материализованные один
+// раз на пакет; модель пересадок тоже разбирается один раз. С json
+// (--format json) запросы и матрицы дописываются в него массивами
+// "requests" и "matrices" вместо текстовых блоков. false — файл не записан.
+bool print_requests(const Options& options, const FrozenGraph& fg, const ModelParams& model,
+                    const std::vector<Request>& requests, const std::vector<MatrixRequest>& matrices,
+                    OutputBuffer* json) {
+    SearchOptions search = options.search;
+    const bool prepare = !search.pareto && !requests.empty();
+    std::optional<PhaseTimer> prepare_timer(std::in_place, Phase::Prepare);
+    ContractionHierarchy ch;
+    if (options.hierarchy && (prepare || !matrices.empty())) {
+        ch = build_contraction_hierarchy(fg, model);
+        search.hierarchy = &ch;
+    }
+    Landmarks lm;
+    if (options.landmarks > 0 && !options.hierarchy && prepare) {
+        lm = build_landmarks(fg, options.landmarks);
+        search.landmarks = &lm;
+    }
+    search.transfer_model = classify_transfer_model(model);
+    ArcWeights weights;
+    if (search.hierarchy == nullptr && search.landmarks == nullptr && (prepare || !matrices.empty())) {
+        weights = materialize_arc_weights(fg, model.sensitivity);
+        search.arc_weights = &weights;
+    }
+    PathTreeCache cache(static_cast<std::size_t>(options.cache_mb) << 20);
+    if (options.cache_mb > 0 && !search.pareto) {
+        search.tree_cache = &cache;
+        search.model_fingerprint = model_fingerprint(model);
+    }
+    prepare_timer.reset();
+    if (json != nullptr) {
+        json->append(",\"requests\":[");
+    }
+    solve_batch(
+        fg,
+        model,
+        search,
+        requests,
+        options.threads,
+        [&requests, json](std::size_t i, const std::vector<Route>& routes) {
+            const PhaseTimer timer(Phase::Output);
+            if (json == nullptr) {
+                print_request(std::cout, i, requests[i], routes, requests.size());
+                return;
+            }
+            if (i > 0) {
+                json->put(',');
+            }
+            write_request_json(*json, requests[i], routes);
+        }
+    );
+    if (search.tree_cache != nullptr) {
+        const PathTreeCacheStats stats = cache.stats();
+        std::cerr << "cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.evictions << " evictions, " << stats.entries << " trees ("
+                  << (stats.bytes >> 20) << " MB)\n";
+    }
+
+    std::vector<TravelMatrix> results;
+    results.reserve(matrices.size());
+    if (json != nullptr) {
+        json->append("],\"matrices\":[");
+    }
+    for (std::size_t i = 0; i < matrices.size(); ++i) {
+        {
+            const PhaseTimer timer(Phase::Search);
+            results.push_back(travel_time_matrix(fg, model, matrices[i].sources, matrices[i].targets, search, options.threads));
+        }
+        const PhaseTimer timer(Phase::Output);
+        if (json != nullptr) {
+            if (i > 0) {
+                json->put(',');
+            }
+            write_matrix_json(*json, results.back(), options.matrix_path.empty());
+            continue;
+        }
+        if (i > 0 || !requests.empty()) {
+            std::cout << '\n';
+        }
+        print_matrix(std::cout, i, results.back(), options.matrix_path.empty());
+    }
+    if (json != nullptr) {
+        const PhaseTimer timer(Phase::Output);
+        json->append("]}\n");
+        json->flush();
+    }
+    if (!options.matrix_path.empty()) {
+        const PhaseTimer timer(Phase::Output);
+        std::string error;
+        if (!write_matrix_file(options.matrix_path, results, error)) {
+            std::cerr << error << "\n";
+            return false;
+        }
+        std::cerr << "matrix: " << results.size() << " matrices written to " << options.matrix_path << "\n";
     }
+    return true;
+}
 
-    if (!validate_all(data, error)) {
+// --convert: сеть из stdin (блок запросов, если есть, не читается) -> файл снимка.
+int run_convert(const Options& options) {
+    InputData data;
+    std::string error;
+    ParseLocation where;
+    {
+        const PhaseTimer timer(Phase::Parse);
+        if (!parse_network(std::cin, data, error, &where)) {
+            report_parse_error(error, where);
+            return 1;
+        }
+    }
+    {
+        const PhaseTimer timer(Phase::Validate);
+        if (!validate_graph(data.g, error) || !validate_model(data.g, data.model, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+    std::optional<PhaseTimer> prepare_timer(std::in_place, Phase::Prepare);
+    FrozenGraph fg = freeze_graph(data.g);
+    if (!apply_delta_file(options, fg)) {
+        return 1;
+    }
+    prepare_timer.reset();
+    const PhaseTimer timer(Phase::Output);
+    if (!write_snapshot(options.convert_path, fg, data.model, error, options.threads)) {
         std::cerr << error << "\n";
         return 1;
     }
+    std::cerr << "snapshot: " << options.convert_path << " (" << data.g.n << " stations, "
+              << data.g.m << " edges)\n";
+    return 0;
+}
 
-    print_isolated_zones(data.g, TransportType::Metro, "metro");
-    std::cout << '\n';
-    print_isolated_zones(data.g, TransportType::Bus, "bus");
-    std::cout << '\n';
-    print_isolated_zones(data.g, TransportType::Rail, "rail");
-    std::cout << '\n';
-    print_isolated_zones(data.g, TransportType::All, "all");
-    std::cout << '\n';
+// --snapshot: сеть и метки компонент из снимка, в stdin — блок запросов.
+int run_snapshot(const Options& options) {
+    Snapshot snap;
+    std::string error;
+    std::vector<Request> requests;
+    std::vector<MatrixRequest> matrices;
+    {
+        // Загрузка снимка — часть разбора входа.
+        const PhaseTimer timer(Phase::Parse);
+        if (!load_snapshot(options.snapshot_path, snap, options.verify, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        ParseLocation where;
+        if (!parse_requests(std::cin, snap.g.n, requests, error, &where, &matrices)) {
+            report_parse_error(error, where);
+            return 1;
+        }
+    }
+    {
+        const PhaseTimer timer(Phase::Validate);
+        if (!validate_requests(snap.g.n, requests, error) || !validate_matrix_requests(snap.g.n, matrices, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+    {
+        const PhaseTimer timer(Phase::Prepare);
+        if (!apply_delta_file(options, snap.g)) {
+            return 1;
+        }
+    }
+    std::optional<OutputBuffer> json;
+    {
+        const PhaseTimer timer(Phase::Zones);
+        if (options.format == ReportFormat::Json) {
+            json.emplace(&std::cout);
+            json->append("{\"zones\":");
+            write_zones_json(*json, snap.component_labels, snap.g.n);
+        } else {
+            print_zones_report(std::cout, snap.component_labels, snap.g.n);
+        }
+    }
+    return print_requests(options, snap.g, snap.model, requests, matrices, json ? &*json : nullptr) ? 0 : 1;
+}
 
-    for (std::size_t i = 0; i < data.requests.size(); ++i) {
-        const Request& rq = data.requests[i];
-        const std::vector<Route> routes = solve_request(data.g, data.model, rq);
+// Вход целиком из stdin: сеть, запросы, матрицы.
+int run_text(const Options& options) {
+    InputData data;
+    std::string error;
+    {
+        const PhaseTimer timer(Phase::Parse);
+        ParseLocation where;
+        if (!parse_all(std::cin, data, error, &where)) {
+            report_parse_error(error, where);
+            return 1;
+        }
+    }
+    {
+        const PhaseTimer timer(Phase::Validate);
+        if (!validate_all(data, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
 
-        std::cout << "REQUEST " << (i + 1) << " (start " << rq.start << ", k " << rq.k << ")\n";
-        if (routes.empty()) {
-            std::cout << "No targets\n";
+    // Топология дальше не меняется: строим CSR-снимок один раз для всех проходов.
+    std::optional<PhaseTimer> prepare_timer(std::in_place, Phase::Prepare);
+    FrozenGraph fg = freeze_graph(data.g);
+    if (!apply_delta_file(options, fg)) {
+        return 1;
+    }
+    prepare_timer.reset();
+
+    std::optional<OutputBuffer> json;
+    {
+        const PhaseTimer timer(Phase::Zones);
+        if (options.format == ReportFormat::Json) {
+            json.emplace(&std::cout);
+            json->append("{\"zones\":");
+            write_zones_json(*json, fg, options.threads);
         } else {
-            for (const Route& route : routes) {
-                print_route_formatted(route, rq.start);
-            }
+            print_zones_report(std::cout, fg, options.threads);
         }
+    }
+    return print_requests(options, fg, data.model, data.requests, data.matrices, json ? &*json : nullptr) ? 0 : 1;
+}
 
-        if (i + 1 < data.requests.size()) {
-            std::cout << '\n';
-        }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string error;
+
+    Options options;
+    if (!parse_options(argc, argv, options, error)) {
+        std::cerr << error << "\n";
+        return 1;
     }
 
-    return 0;
+    if (options.serve) {
+        return run_service(options.service);
+    }
+
+    int code = 0;
+    if (!options.convert_path.empty()) {
+        code = run_convert(options);
+    } else if (!options.snapshot_path.empty()) {
+        code = run_snapshot(options);
+    } else {
+        code = run_text(options);
+    }
+
+    // --stats: последней строкой stderr, и при ошибке тоже.
+    if (options.stats) {
+        std::cout.flush();
+        write_stats_json(std::cerr, stats_collect());
+        std::cerr << "\n";
+    }
+    return code;
 }
@@ -0,0 +1,119 @@
+#include "matrix.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char kMagic[8] = {'R', 'N', 'A', 'V', 'M', 'T', 'R', 'X'};
+constexpr std::uint32_t kEndianMarker = 0x01020304u;
+
+static_assert(sizeof(int) == 4, "matrix file stores int as int32");
+static_assert(sizeof(double) == 8, "matrix file stores double as float64");
+
+template <typename T>
+void write_value(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+bool read_value(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+bool read_array(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+    values.resize(count);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+} // namespace
+
+bool write_matrix_file(const std::string& path, const std::vector<TravelMatrix>& matrices, std::string& error) {
+    error.clear();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "matrix: cannot open " + path + " for writing";
+        return false;
+    }
+    out.write(kMagic, sizeof(kMagic));
+    write_value(out, kMatrixFileVersion);
+    write_value(out, kEndianMarker);
+    write_value(out, static_cast<std::uint32_t>(matrices.size()));
+    for (const TravelMatrix& m : matrices) {
+        write_value(out, static_cast<std::uint32_t>(m.sources.size()));
+        write_value(out, static_cast<std::uint32_t>(m.targets.size()));
+        write_array(out, m.sources);
+        write_array(out, m.targets);
+        write_array(out, m.time);
+        write_array(out, m.transfers);
+    }
+    out.flush();
+    if (!out) {
+        error = "matrix: write failed for " + path;
+        return false;
+    }
+    return true;
+}
+
+bool read_matrix_file(const std::string& path, std::vector<TravelMatrix>& matrices, std::string& error) {
+    error.clear();
+    matrices.clear();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        error = "matrix: cannot open " + path;
+        return false;
+    }
+    const std::uint64_t file_size = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    char magic[sizeof(kMagic)] = {};
+    std::uint32_t version = 0;
+    std::uint32_t endian = 0;
+    std::uint32_t count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "matrix: bad magic";
+        return false;
+    }
+    if (!read_value(in, version) || !read_value(in, endian) || !read_value(in, count)) {
+        error = "matrix: truncated header";
+        return false;
+    }
+    if (endian != kEndianMarker) {
+        error = "matrix: byte order mismatch";
+        return false;
+    }
+    if (version != kMatrixFileVersion) {
+        error = "matrix: unsupported version";
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t s = 0;
+        std::uint32_t t = 0;
+        TravelMatrix m;
+        if (!read_value(in, s) || !read_value(in, t)) {
+            error = "matrix: truncated file";
+            return false;
+        }
+        // Размеры проверяются по длине файла до выделения памяти.
+        const std::uint64_t cells = static_cast<std::uint64_t>(s) * t;
+        const std::uint64_t left = file_size - static_cast<std::uint64_t>(in.tellg());
+        if ((static_cast<std::uint64_t>(s) + t) * sizeof(int) + cells * (sizeof(double) + sizeof(int)) > left) {
+            error = "matrix: truncated file";
+            return false;
+        }
+        if (!read_array(in, m.sources, s) || !read_array(in, m.targets, t) || !read_array(in, m.time, static_cast<std::size_t>(cells))
+            || !read_array(in, m.transfers, static_cast<std::size_t>(cells))) {
+            error = "matrix: truncated file";
+            return false;
+        }
+        matrices.push_back(std::move(m));
+    }
+    return true;
+}
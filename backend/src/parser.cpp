@@ -1,21 +1,166 @@
 #include "parser.hpp"
+#include "stats.hpp"
 
-#include <sstream>
+#include <charconv>
+#include <iterator>
 #include <limits>
+#include <string_view>
+
+/*
+Разбор идет по буферу в памяти: поток (stdin, файл) читается целиком один раз,
+числа читаются std::from_chars без локали и без копирования через streambuf.
+Принимается тот же язык, что у std::istream >> в локали "C": пробельные
+символы как разделители, необязательный знак, для double — десятичная запись
+с экспонентой (inf/nan не принимаются, как и istream).
+*/
+namespace {
+
+struct EdgeRecord {
+    int u = 0;
+    int v = 0;
+    int mode = 0;
+    double base_time = 0.0;
+    double load = 0.0;
+};
+
+bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Пропустить пробелы и запомнить начало очередного токена (для позиции ошибки).
+void skip_space(TextCursor& in) {
+    while (in.cur < in.end && is_space(*in.cur)) {
+        ++in.cur;
+    }
+    in.token = in.cur;
+}
+
+// Следующий токен — слово word: прочитать его и вернуть true; иначе курсор
+// остается на месте. Остальные токены входа — числа, так что слово не
+// спутать с ними при любой расстановке переводов строк.
+bool read_keyword(TextCursor& in, std::string_view word) {
+    skip_space(in);
+    const std::size_t left = static_cast<std::size_t>(in.end - in.cur);
+    if (left < word.size() || std::string_view(in.cur, word.size()) != word) {
+        return false;
+    }
+    if (left > word.size() && !is_space(in.cur[word.size()])) {
+        return false;
+    }
+    in.cur += word.size();
+    return true;
+}
+
+// Явный '+' istream принимает, from_chars — нет; после знака должна идти цифра
+// (или '.' для double), иначе "+-5" прочитался бы как -5.
+const char* skip_plus(const TextCursor& in, bool allow_dot) {
+    const char* p = in.cur;
+    if (p < in.end && *p == '+') {
+        ++p;
+        if (p >= in.end || !(is_digit(*p) || (allow_dot && *p == '.'))) {
+            return nullptr;
+        }
+    }
+    return p;
+}
 
 // Маленькие “корменовские” процедуры чтения токенов
-static bool read_int(std::istream& in, int& x) {
-    return static_cast<bool>(in >> x);
+bool read_int(TextCursor& in, int& x) {
+    skip_space(in);
+    const char* p = skip_plus(in, false);
+    if (p == nullptr) {
+        return false;
+    }
+    const auto res = std::from_chars(p, in.end, x);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    in.cur = res.ptr;
+    return true;
 }
 
-static bool read_double(std::istream& in, double& x) {
-    return static_cast<bool>(in >> x);
+bool read_double(TextCursor& in, double& x) {
+    skip_space(in);
+    const char* p = skip_plus(in, true);
+    if (p == nullptr) {
+        return false;
+    }
+    const char* q = (p < in.end && *p == '-') ? p + 1 : p;
+    if (q >= in.end || !(is_digit(*q) || *q == '.')) {
+        return false; // inf, nan, hex и прочее istream тоже не читает
+    }
+    const auto res = std::from_chars(p, in.end, x, std::chars_format::general);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    in.cur = res.ptr;
+    return true;
 }
 
-static std::string make_err(const std::string& msg) {
+std::string make_err(const std::string& msg) {
     return msg;
 }
 
+// Резерв по заявленному числу элементов, но не больше, чем может уместиться
+// в остатке буфера (min_bytes — минимальная длина записи одного элемента).
+std::size_t reserve_hint(const TextCursor& in, int count, std::size_t min_bytes) {
+    const std::size_t left = static_cast<std::size_t>(in.end - in.cur) / min_bytes + 1;
+    const std::size_t want = count > 0 ? static_cast<std::size_t>(count) : 0;
+    return want < left ? want : left;
+}
+
+std::string read_stream(std::istream& in) {
+    std::string text;
+    char chunk[1 << 16];
+    for (;;) {
+        in.read(chunk, sizeof(chunk));
+        const std::streamsize got = in.gcount();
+        if (got <= 0) {
+            break;
+        }
+        text.append(chunk, static_cast<std::size_t>(got));
+    }
+    stats_add(Counter::ParsedBytes, text.size());
+    return text;
+}
+
+void set_location(const TextCursor& in, ParseLocation* where) {
+    if (where != nullptr) {
+        *where = locate(in.begin, static_cast<std::size_t>(in.token - in.begin));
+    }
+}
+
+} // namespace
+
+ParseLocation locate(const char* text, std::size_t offset) {
+    ParseLocation loc;
+    loc.offset = offset;
+    loc.line = 1;
+    loc.column = 1;
+    for (std::size_t i = 0; i < offset; ++i) {
+        if (text[i] == '\n') {
+            ++loc.line;
+            loc.column = 1;
+        } else {
+            ++loc.column;
+        }
+    }
+    return loc;
+}
+
+TextCursor make_cursor(const char* data, std::size_t size) {
+    TextCursor in;
+    in.begin = data;
+    in.cur = data;
+    in.end = data + size;
+    in.token = data;
+    return in;
+}
+
 /*
 ОЖИДАЕМЫЙ ФОРМАТ (можно поменять здесь, если у вас иначе):
 N M
@@ -28,17 +173,26 @@ M lines:
   u v mode base_time load
 Q
 Q queries:
-  start T k  (then T targets)
+  start T k  (then T targets, then optional "max R")
+[P
+ P matrix requests:
+   S s1 .. sS T t1 .. tT]
 */
-bool parse_all(std::istream& in, InputData& data, std::string& error) {
+bool parse_network(TextCursor& in, InputData& data, std::string& error) {
     error.clear();
 
     int N = 0, M = 0;
-    if (!read_int(in, N) || !read_int(in, M)) {
+    if (!read_int(in, N)) {
+        error = make_err("parse: cannot read N M");
+        return false;
+    }
+    const char* header = in.token;
+    if (!read_int(in, M)) {
         error = make_err("parse: cannot read N M");
         return false;
     }
     if (N <= 0 || M < 0) {
+        in.token = header;
         error = make_err("parse: invalid N or M");
         return false;
     }
@@ -79,26 +233,64 @@ bool parse_all(std::istream& in, InputData& data, std::string& error) {
         data.model.station_transfer[v] = lt;
     }
 
-    // edges
+    // edges: сначала читаются и проверяются все строки (ошибки — в порядке
+    // чтения, как при вставке по одной), затем по степеням вершин резервируются
+    // списки смежности и рёбра вставляются без перераспределений.
+    std::vector<EdgeRecord> edges;
+    edges.reserve(reserve_hint(in, M, 10));
     for (int i = 0; i < M; ++i) {
-        int u = 0, v = 0, mode = 0;
-        double base_time = 0.0, load = 0.0;
+        EdgeRecord r;
 
-        if (!read_int(in, u) || !read_int(in, v) || !read_int(in, mode) ||
-            !read_double(in, base_time) || !read_double(in, load)) {
+        if (!read_int(in, r.u)) {
+            error = make_err("parse: cannot read an edge line: u v mode base_time load");
+            return false;
+        }
+        const char* line = in.token;
+        if (!read_int(in, r.v) || !read_int(in, r.mode) ||
+            !read_double(in, r.base_time) || !read_double(in, r.load)) {
             error = make_err("parse: cannot read an edge line: u v mode base_time load");
             return false;
         }
 
-        // graph_add_undirected проверит диапазоны (вершины, mode, load)
+        // graph_check_undirected проверит диапазоны (вершины, mode, load)
         try {
-            graph_add_undirected(data.g, u, v, mode, base_time, load);
+            graph_check_undirected(data.g, r.u, r.v, r.mode, r.base_time, r.load);
         } catch (const std::exception& e) {
+            in.token = line;
             error = std::string("parse: invalid edge: ") + e.what();
             return false;
         }
+        edges.push_back(r);
     }
 
+    std::vector<int> degree(static_cast<std::size_t>(N) + 1, 0);
+    std::array<std::vector<int>, 3> mode_degree;
+    for (auto& d : mode_degree) {
+        d.assign(static_cast<std::size_t>(N) + 1, 0);
+    }
+    for (const EdgeRecord& r : edges) {
+        ++degree[r.u];
+        ++degree[r.v];
+        ++mode_degree[static_cast<std::size_t>(r.mode)][r.u];
+        ++mode_degree[static_cast<std::size_t>(r.mode)][r.v];
+    }
+    for (int v = 1; v <= N; ++v) {
+        data.g.adj[v].reserve(static_cast<std::size_t>(degree[v]));
+        for (std::size_t m = 0; m < 3; ++m) {
+            data.g.adjacency[m][v].reserve(static_cast<std::size_t>(mode_degree[m][v]));
+        }
+    }
+    for (const EdgeRecord& r : edges) {
+        graph_add_undirected(data.g, r.u, r.v, r.mode, r.base_time, r.load);
+    }
+    stats_add(Counter::ParsedEdges, edges.size());
+
+    return true;
+}
+
+bool parse_requests(TextCursor& in, int N, std::vector<Request>& requests, std::string& error) {
+    error.clear();
+
     // queries
     int Q = 0;
     if (!read_int(in, Q)) {
@@ -110,24 +302,30 @@ bool parse_all(std::istream& in, InputData& data, std::string& error) {
         return false;
     }
 
-    data.requests.clear();
-    data.requests.reserve(static_cast<std::size_t>(Q));
+    requests.clear();
+    requests.reserve(reserve_hint(in, Q, 6));
 
     for (int qi = 0; qi < Q; ++qi) {
         Request rq;
         int T = 0;
 
-        if (!read_int(in, rq.start) || !read_int(in, T) || !read_double(in, rq.k)) {
+        if (!read_int(in, rq.start)) {
+            error = make_err("parse: cannot read query header: start T k");
+            return false;
+        }
+        const char* header = in.token;
+        if (!read_int(in, T) || !read_double(in, rq.k)) {
             error = make_err("parse: cannot read query header: start T k");
             return false;
         }
         if (rq.start < 1 || rq.start > N || T < 0) {
+            in.token = header;
             error = make_err("parse: invalid query header values");
             return false;
         }
 
         rq.targets.clear();
-        rq.targets.reserve(static_cast<std::size_t>(T));
+        rq.targets.reserve(reserve_hint(in, T, 2));
 
         for (int j = 0; j < T; ++j) {
             int t = 0;
@@ -138,8 +336,180 @@ bool parse_all(std::istream& in, InputData& data, std::string& error) {
             rq.targets.push_back(t);
         }
 
-        data.requests.push_back(rq);
+        // Необязательный предел пересадок: "max R" после целей.
+        if (read_keyword(in, "max")) {
+            int cap = 0;
+            if (!read_int(in, cap)) {
+                error = make_err("parse: cannot read max_transfers in query");
+                return false;
+            }
+            if (cap < 0) {
+                error = make_err("parse: invalid max_transfers in query");
+                return false;
+            }
+            rq.max_transfers = cap;
+        }
+
+        requests.push_back(rq);
+    }
+    stats_add(Counter::ParsedRequests, requests.size());
+
+    return true;
+}
+
+bool parse_matrix_requests(TextCursor& in, std::vector<MatrixRequest>& matrices, std::string& error) {
+    error.clear();
+    matrices.clear();
+
+    // Блок начинается словом matrix; другой текст после запросов, как и
+    // раньше, не читается.
+    if (!read_keyword(in, "matrix")) {
+        return true;
+    }
+    int P = 0;
+    if (!read_int(in, P)) {
+        error = make_err("parse: cannot read P");
+        return false;
+    }
+    if (P < 0) {
+        error = make_err("parse: invalid P");
+        return false;
+    }
+
+    matrices.reserve(reserve_hint(in, P, 4));
+    for (int pi = 0; pi < P; ++pi) {
+        MatrixRequest mr;
+        for (std::vector<int>* list : {&mr.sources, &mr.targets}) {
+            int count = 0;
+            if (!read_int(in, count)) {
+                error = make_err("parse: cannot read matrix request: S sources T targets");
+                return false;
+            }
+            if (count < 0) {
+                error = make_err("parse: invalid matrix request size");
+                return false;
+            }
+            list->reserve(reserve_hint(in, count, 2));
+            for (int i = 0; i < count; ++i) {
+                int v = 0;
+                if (!read_int(in, v)) {
+                    error = make_err("parse: cannot read station in matrix request");
+                    return false;
+                }
+                list->push_back(v);
+            }
+        }
+        matrices.push_back(std::move(mr));
+    }
+
+    return true;
+}
+
+/*
+ФАЙЛ ИЗМЕНЕНИЙ:
+D
+D lines:
+  id base_time load
+*/
+bool parse_deltas(TextCursor& in, std::vector<EdgeDelta>& deltas, std::string& error) {
+    error.clear();
+
+    int D = 0;
+    if (!read_int(in, D)) {
+        error = make_err("parse: cannot read D");
+        return false;
+    }
+    if (D < 0) {
+        error = make_err("parse: invalid D");
+        return false;
+    }
+
+    deltas.clear();
+    deltas.reserve(reserve_hint(in, D, 6));
+    for (int i = 0; i < D; ++i) {
+        EdgeDelta d;
+        if (!read_int(in, d.id) || !read_double(in, d.base_time) || !read_double(in, d.load)) {
+            error = make_err("parse: cannot read a delta line: id base_time load");
+            return false;
+        }
+        deltas.push_back(d);
     }
 
     return true;
 }
+
+bool parse_k_values(TextCursor& in, std::vector<double>& ks, std::string& error) {
+    error.clear();
+
+    int K = 0;
+    if (!read_int(in, K)) {
+        error = make_err("parse: cannot read K");
+        return false;
+    }
+    if (K < 0) {
+        error = make_err("parse: invalid K");
+        return false;
+    }
+
+    ks.clear();
+    ks.reserve(reserve_hint(in, K, 2));
+    for (int i = 0; i < K; ++i) {
+        double k = 0.0;
+        if (!read_double(in, k)) {
+            error = make_err("parse: cannot read k value");
+            return false;
+        }
+        ks.push_back(k);
+    }
+
+    return true;
+}
+
+bool parse_all(TextCursor& in, InputData& data, std::string& error) {
+    if (!parse_network(in, data, error)) {
+        return false;
+    }
+    return parse_requests(in, data.g.n, data.requests, error) && parse_matrix_requests(in, data.matrices, error);
+}
+
+bool parse_all(std::istream& in, InputData& data, std::string& error, ParseLocation* where) {
+    const std::string text = read_stream(in);
+    TextCursor cur = make_cursor(text.data(), text.size());
+    const bool ok = parse_all(cur, data, error);
+    if (!ok) {
+        set_location(cur, where);
+    }
+    return ok;
+}
+
+bool parse_network(std::istream& in, InputData& data, std::string& error, ParseLocation* where) {
+    const std::string text = read_stream(in);
+    TextCursor cur = make_cursor(text.data(), text.size());
+    const bool ok = parse_network(cur, data, error);
+    if (!ok) {
+        set_location(cur, where);
+    }
+    return ok;
+}
+
+bool parse_requests(std::istream& in, int N, std::vector<Request>& requests, std::string& error, ParseLocation* where,
+                    std::vector<MatrixRequest>* matrices) {
+    const std::string text = read_stream(in);
+    TextCursor cur = make_cursor(text.data(), text.size());
+    const bool ok = parse_requests(cur, N, requests, error)
+        && (matrices == nullptr || parse_matrix_requests(cur, *matrices, error));
+    if (!ok) {
+        set_location(cur, where);
+    }
+    return ok;
+}
+
+bool parse_deltas(std::istream& in, std::vector<EdgeDelta>& deltas, std::string& error, ParseLocation* where) {
+    const std::string text = read_stream(in);
+    TextCursor cur = make_cursor(text.data(), text.size());
+    const bool ok = parse_deltas(cur, deltas, error);
+    if (!ok) {
+        set_location(cur, where);
+    }
+    return ok;
+}
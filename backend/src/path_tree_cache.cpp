@@ -0,0 +1,112 @@
+#include "path_tree_cache.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// Перемешивание splitmix64: каждый бит входа влияет на все биты выхода.
+std::uint64_t mix(std::uint64_t h, double x) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(bits));
+    h ^= bits + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+} // namespace
+
+std::uint64_t model_fingerprint(const ModelParams& model) {
+    std::uint64_t h = 0x243f6a8885a308d3ull;
+    for (double s : model.sensitivity) {
+        h = mix(h, s);
+    }
+    for (const auto& row : model.trans) {
+        for (double t : row) {
+            h = mix(h, t);
+        }
+    }
+    h = mix(h, static_cast<double>(model.station_transfer.size()));
+    for (double lt : model.station_transfer) {
+        h = mix(h, lt);
+    }
+    return h != 0 ? h : 1;
+}
+
+std::shared_ptr<const PathTree> PathTreeCache::get(const FrozenGraph& g, const ModelParams& model,
+                                                   std::uint64_t fingerprint, int start) {
+    const Key key{start, fingerprint, g.version};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (g.version > newest_version_) {
+            invalidate_before(g.version);
+            newest_version_ = g.version;
+        }
+        const auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            ++stats_.hits;
+            return it->second->second;
+        }
+        ++stats_.misses;
+    }
+
+    std::shared_ptr<PathTree> tree = std::make_shared<PathTree>();
+    if (!build_path_tree(g, model, start, *tree)) {
+        return nullptr;
+    }
+    const std::size_t bytes = tree->memory_bytes();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (key.version != newest_version_ || bytes > limit_bytes_ || index_.count(key) != 0) {
+        return tree;
+    }
+    lru_.emplace_front(key, tree);
+    index_.emplace(key, lru_.begin());
+    stats_.bytes += bytes;
+    while (stats_.bytes > limit_bytes_) {
+        evict_oldest();
+    }
+    return tree;
+}
+
+void PathTreeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+PathTreeCacheStats PathTreeCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PathTreeCacheStats s = stats_;
+    s.entries = lru_.size();
+    return s;
+}
+
+// Удалить деревья для весов старше version (вызывается под мьютексом).
+void PathTreeCache::invalidate_before(std::uint64_t version) {
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->first.version < version) {
+            stats_.bytes -= it->second->memory_bytes();
+            index_.erase(it->first);
+            it = lru_.erase(it);
+            ++stats_.invalidations;
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Вытеснить давно не использованное дерево (вызывается под мьютексом).
+void PathTreeCache::evict_oldest() {
+    const Entry& last = lru_.back();
+    stats_.bytes -= last.second->memory_bytes();
+    index_.erase(last.first);
+    lru_.pop_back();
+    ++stats_.evictions;
+}
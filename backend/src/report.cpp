@@ -0,0 +1,284 @@
+#include "report.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+std::vector<std::vector<int>> get_isolated_components(const FrozenGraph& g, TransportType type, int threads) {
+    std::vector<std::vector<int>> components = get_connected_components(g, type, threads);
+    if (!components.empty()) {
+        components.erase(components.begin());
+    }
+    return components;
+}
+
+// Печать списка компонент, пропуская первую (крупнейшую).
+void print_zone_list(std::ostream& out, const std::vector<std::vector<int>>& components, std::size_t first) {
+    if (components.size() <= first) {
+        out << "None\n";
+        return;
+    }
+    for (std::size_t i = first; i < components.size(); ++i) {
+        const auto& zone = components[i];
+        out << (i - first + 1) << ". " << zone.size() << " stations: ";
+        for (std::size_t j = 0; j < zone.size(); ++j) {
+            out << zone[j];
+            if (j + 1 < zone.size()) {
+                out << ' ';
+            }
+        }
+        out << '\n';
+    }
+}
+
+// Путь маршрута в формате format_path.
+void print_path(std::ostream& out, const Route& route, int start) {
+    if (!route.reachable) {
+        out << "unreachable";
+        return;
+    }
+    if (route.steps.empty()) {
+        out << start;
+        return;
+    }
+    for (std::size_t i = 0; i < route.steps.size(); ++i) {
+        const Step& step = route.steps[i];
+        if (i > 0) {
+            out << ' ';
+        }
+        out << step.from << "-[" << mode_label(step.mode) << "]->" << step.to;
+    }
+}
+
+// Время или null: в JSON нет бесконечности.
+void put_json_time(OutputBuffer& out, double x) {
+    if (std::isfinite(x)) {
+        out.put_double(x);
+    } else {
+        out.append("null");
+    }
+}
+
+void put_json_ints(OutputBuffer& out, const std::vector<int>& values) {
+    out.put('[');
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            out.put(',');
+        }
+        out.put_int(values[i]);
+    }
+    out.put(']');
+}
+
+// Массив зон: компоненты начиная с first (крупнейшая пропускается).
+void put_json_zones(OutputBuffer& out, const std::vector<std::vector<int>>& components, std::size_t first) {
+    out.put('[');
+    for (std::size_t i = first; i < components.size(); ++i) {
+        if (i > first) {
+            out.put(',');
+        }
+        put_json_ints(out, components[i]);
+    }
+    out.put(']');
+}
+
+const char* const kZoneKeys[4] = {"{\"metro\":", ",\"bus\":", ",\"rail\":", ",\"all\":"};
+const TransportType kZoneTypes[4] = {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All};
+
+} // namespace
+
+const char* mode_label(int mode) {
+    switch (mode) {
+        case MODE_METRO:
+            return "metro";
+        case MODE_BUS:
+            return "bus";
+        case MODE_RAIL:
+            return "rail";
+        default:
+            return "unknown";
+    }
+}
+
+std::string format_path(const Route& route, int start) {
+    std::ostringstream path;
+    print_path(path, route, start);
+    return path.str();
+}
+
+void print_route_formatted(std::ostream& out, const Route& route, int start) {
+    out << "Destination: " << route.target << " | ";
+
+    if (!route.reachable) {
+        out << "Time: INF | Transfers: INF | Metric: INF | Path: unreachable\n";
+        return;
+    }
+
+    out << std::fixed << std::setprecision(2);
+    out << "Time: " << route.time
+        << " | Transfers: " << route.transfers
+        << " | Metric: " << route.metric
+        << " | Path: ";
+    print_path(out, route, start); // сразу в поток, без строки на маршрут
+    out << '\n';
+}
+
+void print_isolated_zones(std::ostream& out, const FrozenGraph& g, TransportType type, const std::string& label, int threads) {
+    out << "ISOLATED ZONES (" << label << ")\n";
+    print_zone_list(out, get_isolated_components(g, type, threads), 0);
+}
+
+void print_zones_report(std::ostream& out, const FrozenGraph& g, int threads) {
+    print_isolated_zones(out, g, TransportType::Metro, "metro", threads);
+    out << '\n';
+    print_isolated_zones(out, g, TransportType::Bus, "bus", threads);
+    out << '\n';
+    print_isolated_zones(out, g, TransportType::Rail, "rail", threads);
+    out << '\n';
+    print_isolated_zones(out, g, TransportType::All, "all", threads);
+    out << '\n';
+}
+
+void print_zones_report(std::ostream& out, const std::array<ArrayView<int>, 4>& labels, int n) {
+    static const char* const kLabels[4] = {"metro", "bus", "rail", "all"};
+    for (std::size_t t = 0; t < 4; ++t) {
+        out << "ISOLATED ZONES (" << kLabels[t] << ")\n";
+        print_zone_list(out, components_from_labels(labels[t], n), 1);
+        out << '\n';
+    }
+}
+
+void print_request(std::ostream& out, std::size_t index, const Request& rq, const std::vector<Route>& routes, std::size_t total) {
+    out << "REQUEST " << (index + 1) << " (start " << rq.start << ", k " << rq.k << ")\n";
+    if (routes.empty()) {
+        out << "No targets\n";
+    } else {
+        for (const Route& route : routes) {
+            print_route_formatted(out, route, rq.start);
+        }
+    }
+
+    if (index + 1 < total) {
+        out << '\n';
+    }
+}
+
+void print_matrix(std::ostream& out, std::size_t index, const TravelMatrix& matrix, bool cells) {
+    out << "MATRIX " << (index + 1) << " (" << matrix.sources.size() << " sources, " << matrix.targets.size()
+        << " targets)\n";
+    if (!cells) {
+        return;
+    }
+    for (std::size_t i = 0; i < matrix.sources.size(); ++i) {
+        for (std::size_t j = 0; j < matrix.targets.size(); ++j) {
+            const std::size_t c = matrix.index(i, j);
+            out << "From: " << matrix.sources[i] << " | To: " << matrix.targets[j] << " | ";
+            if (matrix.transfers[c] < 0) {
+                out << "Time: INF | Transfers: INF\n";
+                continue;
+            }
+            out << std::fixed << std::setprecision(2);
+            out << "Time: " << matrix.time[c] << " | Transfers: " << matrix.transfers[c] << '\n';
+        }
+    }
+}
+
+void write_zones_json(OutputBuffer& out, const FrozenGraph& g, int threads) {
+    for (std::size_t t = 0; t < 4; ++t) {
+        out.append(kZoneKeys[t]);
+        put_json_zones(out, get_connected_components(g, kZoneTypes[t], threads), 1);
+    }
+    out.put('}');
+}
+
+void write_zones_json(OutputBuffer& out, const std::array<ArrayView<int>, 4>& labels, int n) {
+    for (std::size_t t = 0; t < 4; ++t) {
+        out.append(kZoneKeys[t]);
+        put_json_zones(out, components_from_labels(labels[t], n), 1);
+    }
+    out.put('}');
+}
+
+void write_request_json(OutputBuffer& out, const Request& rq, const std::vector<Route>& routes) {
+    out.append("{\"start\":");
+    out.put_int(rq.start);
+    out.append(",\"k\":");
+    out.put_double(rq.k);
+    out.append(",\"routes\":[");
+    for (std::size_t r = 0; r < routes.size(); ++r) {
+        const Route& route = routes[r];
+        if (r > 0) {
+            out.put(',');
+        }
+        out.append("{\"target\":");
+        out.put_int(route.target);
+        if (!route.reachable) {
+            out.append(",\"reachable\":false,\"time\":null,\"transfers\":null,\"metric\":null,\"steps\":[]}");
+            continue;
+        }
+        out.append(",\"reachable\":true,\"time\":");
+        put_json_time(out, route.time);
+        out.append(",\"transfers\":");
+        out.put_int(route.transfers);
+        out.append(",\"metric\":");
+        put_json_time(out, route.metric);
+        out.append(",\"steps\":[");
+        for (std::size_t i = 0; i < route.steps.size(); ++i) {
+            const Step& step = route.steps[i];
+            out.append(i > 0 ? ",{\"from\":" : "{\"from\":");
+            out.put_int(step.from);
+            out.append(",\"to\":");
+            out.put_int(step.to);
+            out.append(",\"mode\":\"");
+            out.append(mode_label(step.mode));
+            out.append("\"}");
+        }
+        out.append("]}");
+    }
+    out.append("]}");
+}
+
+void write_matrix_json(OutputBuffer& out, const TravelMatrix& matrix, bool cells) {
+    out.append("{\"sources\":");
+    put_json_ints(out, matrix.sources);
+    out.append(",\"targets\":");
+    put_json_ints(out, matrix.targets);
+    if (cells) {
+        out.append(",\"time\":[");
+        for (std::size_t i = 0; i < matrix.sources.size(); ++i) {
+            out.append(i > 0 ? ",[" : "[");
+            for (std::size_t j = 0; j < matrix.targets.size(); ++j) {
+                const std::size_t c = matrix.index(i, j);
+                if (j > 0) {
+                    out.put(',');
+                }
+                if (matrix.transfers[c] < 0) {
+                    out.append("null");
+                } else {
+                    put_json_time(out, matrix.time[c]);
+                }
+            }
+            out.put(']');
+        }
+        out.append("],\"transfers\":[");
+        for (std::size_t i = 0; i < matrix.sources.size(); ++i) {
+            out.append(i > 0 ? ",[" : "[");
+            for (std::size_t j = 0; j < matrix.targets.size(); ++j) {
+                const std::size_t c = matrix.index(i, j);
+                if (j > 0) {
+                    out.put(',');
+                }
+                if (matrix.transfers[c] < 0) {
+                    out.append("null");
+                } else {
+                    out.put_int(matrix.transfers[c]);
+                }
+            }
+            out.put(']');
+        }
+        out.put(']');
+    }
+    out.put('}');
+}
@@ -0,0 +1,888 @@
+#include "service.hpp"
+
+#include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "matrix.hpp"
+#include "parser.hpp"
+#include "pareto.hpp"
+#include "path_tree_cache.hpp"
+#include "report.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "validator.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kMaxHeaderBytes = 64 * 1024;
+constexpr std::size_t kMaxBodyBytes = 512u * 1024u * 1024u;
+constexpr int kIdleTimeoutSec = 60;
+constexpr int kStopPollMs = 200; // как часто цикл приема проверяет остановку
+
+// Сеть, подготовленная один раз: модель, CSR-снимок, веса дуг для модели и
+// готовый отчет по зонам.
+struct LoadedNetwork {
+    FrozenGraph fg;
+    ModelParams model;
+    ArcWeights arc_weights;
+    std::string source;       // текст раздела сети (для сравнения с телом /api/run)
+    std::string zones_report; // вывод print_zones_report
+    std::string zones_json;   // то же, write_zones_json
+    std::uint64_t model_fingerprint = 0;
+    TransferModel transfer_model = TransferModel::Matrix;
+};
+
+// Текущая сеть; читатели берут копию shared_ptr и работают без блокировок.
+class NetworkSlot {
+public:
+    std::shared_ptr<const LoadedNetwork> get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_;
+    }
+    void set(std::shared_ptr<const LoadedNetwork> next) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_ = std::move(next);
+    }
+    // Заменить сеть, только если текущая все еще expected (иначе ее уже
+    // сменил другой писатель, и изменение надо повторить на новой).
+    bool replace(const std::shared_ptr<const LoadedNetwork>& expected, std::shared_ptr<const LoadedNetwork> next) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_ != expected) {
+            return false;
+        }
+        current_ = std::move(next);
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const LoadedNetwork> current_;
+};
+
+struct RunResult {
+    int exit_code = 0;
+    std::string out;
+    std::string err;
+    bool json = false; // out — документ JSON (?format=json), отдается полем "result"
+};
+
+// LOAD-NETWORK(text): разбор раздела сети, проверка графа и модели,
+// заморозка и отчет по зонам. consumed — длина раздела сети в text.
+std::shared_ptr<LoadedNetwork> load_network(const std::string& text, std::size_t& consumed, std::string& error) {
+    InputData data;
+    TextCursor in = make_cursor(text.data(), text.size());
+    if (!parse_network(in, data, error)) {
+        return nullptr;
+    }
+    if (!validate_graph(data.g, error) || !validate_model(data.g, data.model, error)) {
+        return nullptr;
+    }
+    consumed = static_cast<std::size_t>(in.cur - in.begin);
+
+    auto net = std::make_shared<LoadedNetwork>();
+    net->source = text.substr(0, consumed);
+    net->fg = freeze_graph(data.g);
+    net->model = std::move(data.model);
+    net->model_fingerprint = model_fingerprint(net->model);
+    net->transfer_model = classify_transfer_model(net->model);
+    net->arc_weights = materialize_arc_weights(net->fg, net->model.sensitivity);
+    std::ostringstream zones;
+    print_zones_report(zones, net->fg);
+    net->zones_report = zones.str();
+    OutputBuffer zones_json;
+    write_zones_json(zones_json, net->fg);
+    net->zones_json = zones_json.take();
+    return net;
+}
+
+// Сеть из бинарного снимка: отчет по зонам строится по сохраненным меткам.
+std::shared_ptr<LoadedNetwork> load_network_snapshot(const std::string& path, std::string& error) {
+    Snapshot snap;
+    if (!load_snapshot(path, snap, false, error)) {
+        return nullptr;
+    }
+    auto net = std::make_shared<LoadedNetwork>();
+    net->fg = snap.g;
+    net->model = std::move(snap.model);
+    net->model_fingerprint = model_fingerprint(net->model);
+    net->transfer_model = classify_transfer_model(net->model);
+    net->arc_weights = materialize_arc_weights(net->fg, net->model.sensitivity);
+    std::ostringstream zones;
+    print_zones_report(zones, snap.component_labels, snap.g.n);
+    net->zones_report = zones.str();
+    OutputBuffer zones_json;
+    write_zones_json(zones_json, snap.component_labels, snap.g.n);
+    net->zones_json = zones_json.take();
+    return net;
+}
+
+// Блок запросов (Q и Q запросов) к сети net и необязательный блок матриц;
+// печатает блоки REQUEST и MATRIX, а с json — поля "requests":[...],
+// "matrices":[...] (без фигурных скобок). cache (если есть) общий для всех
+// соединений.
+bool answer_requests(const LoadedNetwork& net, PathTreeCache* cache, const char* text, std::size_t size,
+                     std::ostream& out, OutputBuffer* json, std::string& error) {
+    TextCursor in = make_cursor(text, size);
+    std::vector<Request> requests;
+    std::vector<MatrixRequest> matrices;
+    if (!parse_requests(in, net.fg.n, requests, error) || !parse_matrix_requests(in, matrices, error)) {
+        return false;
+    }
+    if (!validate_requests(net.fg.n, requests, error) || !validate_matrix_requests(net.fg.n, matrices, error)) {
+        return false;
+    }
+    SearchOptions search;
+    search.tree_cache = cache;
+    search.model_fingerprint = net.model_fingerprint;
+    search.arc_weights = &net.arc_weights;
+    search.transfer_model = net.transfer_model;
+    if (json != nullptr) {
+        json->append("\"requests\":[");
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            if (i > 0) {
+                json->put(',');
+            }
+            write_request_json(*json, requests[i], solve_request(net.fg, net.model, requests[i], search));
+        }
+        json->append("],\"matrices\":[");
+        for (std::size_t i = 0; i < matrices.size(); ++i) {
+            if (i > 0) {
+                json->put(',');
+            }
+            write_matrix_json(*json, travel_time_matrix(net.fg, net.model, matrices[i].sources, matrices[i].targets, search),
+                              true);
+        }
+        json->put(']');
+        return true;
+    }
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        print_request(out, i, requests[i], solve_request(net.fg, net.model, requests[i], search), requests.size());
+    }
+    for (std::size_t i = 0; i < matrices.size(); ++i) {
+        if (i > 0 || !requests.empty()) {
+            out << '\n';
+        }
+        print_matrix(out, i, travel_time_matrix(net.fg, net.model, matrices[i].sources, matrices[i].targets, search),
+                     true);
+    }
+    return true;
+}
+
+bool starts_with_network(const std::string& body, const LoadedNetwork& net) {
+    const std::string& src = net.source;
+    // Пустой source (после /api/deltas, сеть из снимка) — префикс любого тела.
+    if (src.empty()) {
+        return false;
+    }
+    if (body.size() < src.size() || body.compare(0, src.size(), src) != 0) {
+        return false;
+    }
+    return body.size() == src.size() || std::isspace(static_cast<unsigned char>(body[src.size()]));
+}
+
+// /api/run: то же, что один запуск CLI, но без повторного разбора сети.
+// Другая сеть в теле решается только для этого ответа: загруженную сеть
+// меняют лишь /api/network и /api/deltas. json — ответ как у --format json.
+RunResult handle_run(const NetworkSlot& slot, PathTreeCache* cache, const std::string& body, bool json) {
+    RunResult res;
+    std::shared_ptr<const LoadedNetwork> net = slot.get();
+    std::size_t consumed = 0;
+
+    if (net && starts_with_network(body, *net)) {
+        consumed = net->source.size();
+    } else {
+        std::string error;
+        std::shared_ptr<LoadedNetwork> loaded = load_network(body, consumed, error);
+        if (!loaded) {
+            res.exit_code = 1;
+            res.err = error + "\n";
+            return res;
+        }
+        net = loaded;
+        cache = nullptr; // кэш деревьев — для загруженной сети
+    }
+
+    std::ostringstream out;
+    OutputBuffer doc;
+    if (json) {
+        doc.append("{\"zones\":");
+        doc.append(net->zones_json);
+        doc.put(',');
+    } else {
+        out << net->zones_report;
+    }
+    std::string error;
+    if (!answer_requests(*net, cache, body.data() + consumed, body.size() - consumed, out, json ? &doc : nullptr,
+                         error)) {
+        res.exit_code = 1;
+        res.err = error + "\n";
+        return res;
+    }
+    if (json) {
+        doc.put('}');
+        res.out = doc.take();
+        res.json = true;
+    } else {
+        res.out = out.str();
+    }
+    return res;
+}
+
+RunResult handle_network(NetworkSlot& slot, const std::string& body) {
+    RunResult res;
+    std::size_t consumed = 0;
+    std::string error;
+    std::shared_ptr<LoadedNetwork> loaded = load_network(body, consumed, error);
+    if (!loaded) {
+        res.exit_code = 1;
+        res.err = error + "\n";
+        return res;
+    }
+    res.out = "loaded " + std::to_string(loaded->fg.n) + " stations, " + std::to_string(loaded->fg.m) + " edges\n";
+    slot.set(std::move(loaded));
+    return res;
+}
+
+RunResult handle_route(const NetworkSlot& slot, PathTreeCache* cache, const std::string& body, bool json) {
+    RunResult res;
+    const std::shared_ptr<const LoadedNetwork> net = slot.get();
+    if (!net) {
+        res.exit_code = 1;
+        res.err = "service: no network loaded\n";
+        return res;
+    }
+    std::ostringstream out;
+    OutputBuffer doc;
+    if (json) {
+        doc.put('{');
+    }
+    std::string error;
+    if (!answer_requests(*net, cache, body.data(), body.size(), out, json ? &doc : nullptr, error)) {
+        res.exit_code = 1;
+        res.err = error + "\n";
+        return res;
+    }
+    if (json) {
+        doc.put('}');
+        res.out = doc.take();
+        res.json = true;
+    } else {
+        res.out = out.str();
+    }
+    return res;
+}
+
+// /api/sweep: "K k1 ... kK", затем блок запросов. Каждый запрос решается
+// одним Парето-поиском сразу для всех k; блоки REQUEST идут по запросам,
+// внутри запроса — по k.
+RunResult handle_sweep(const NetworkSlot& slot, const std::string& body) {
+    RunResult res;
+    const std::shared_ptr<const LoadedNetwork> net = slot.get();
+    if (!net) {
+        res.exit_code = 1;
+        res.err = "service: no network loaded\n";
+        return res;
+    }
+    TextCursor in = make_cursor(body.data(), body.size());
+    std::vector<double> ks;
+    std::vector<Request> requests;
+    std::string error;
+    if (!parse_k_values(in, ks, error) || !parse_requests(in, net->fg.n, requests, error)
+        || !validate_requests(net->fg.n, requests, error)) {
+        res.exit_code = 1;
+        res.err = error + "\n";
+        return res;
+    }
+    for (double k : ks) {
+        if (!std::isfinite(k) || k < 0.0) {
+            res.exit_code = 1;
+            res.err = "sweep: k must be finite and >= 0\n";
+            return res;
+        }
+    }
+
+    std::ostringstream out;
+    const std::size_t total = requests.size() * ks.size();
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const std::vector<std::vector<Route>> answers = solve_request_pareto(net->fg, net->model, requests[i], ks);
+        for (std::size_t j = 0; j < ks.size(); ++j) {
+            Request shown = requests[i];
+            shown.k = ks[j];
+            print_request(out, i * ks.size() + j, shown, answers[j], total);
+        }
+    }
+    res.out = out.str();
+    return res;
+}
+
+// /api/deltas: новые веса рёбер текущей сети (файл изменений в теле).
+// Новая версия сети разделяет с прежней CSR-массивы, копируются только веса;
+// запросы, уже взявшие прежнюю версию, досчитываются по ней. В копии
+// материализованных весов пересчитываются только дуги измененных рёбер.
+RunResult handle_deltas(NetworkSlot& slot, const std::string& body) {
+    RunResult res;
+    TextCursor in = make_cursor(body.data(), body.size());
+    std::vector<EdgeDelta> deltas;
+    std::string error;
+    if (!parse_deltas(in, deltas, error)) {
+        res.exit_code = 1;
+        res.err = error + "\n";
+        return res;
+    }
+    for (;;) {
+        const std::shared_ptr<const LoadedNetwork> net = slot.get();
+        if (!net) {
+            res.exit_code = 1;
+            res.err = "service: no network loaded\n";
+            return res;
+        }
+        auto next = std::make_shared<LoadedNetwork>();
+        next->fg = net->fg;
+        next->model = net->model;
+        next->zones_report = net->zones_report; // топология та же
+        next->zones_json = net->zones_json;
+        next->model_fingerprint = net->model_fingerprint;
+        next->transfer_model = net->transfer_model;
+        // source пуст: текст сети больше не описывает ее веса, и /api/run
+        // с этим текстом разберет сеть заново.
+        if (!frozen_apply_deltas(next->fg, deltas, error)) {
+            res.exit_code = 1;
+            res.err = error + "\n";
+            return res;
+        }
+        next->arc_weights = net->arc_weights;
+        update_arc_weights(next->arc_weights, next->fg, next->model.sensitivity, deltas);
+        if (slot.replace(net, next)) {
+            res.out = "applied " + std::to_string(deltas.size()) + " deltas, version "
+                    + std::to_string(next->fg.version) + "\n";
+            return res;
+        }
+    }
+}
+
+RunResult handle_zones(const NetworkSlot& slot, bool json) {
+    RunResult res;
+    const std::shared_ptr<const LoadedNetwork> net = slot.get();
+    if (!net) {
+        res.exit_code = 1;
+        res.err = "service: no network loaded\n";
+        return res;
+    }
+    if (json) {
+        res.out = "{\"zones\":" + net->zones_json + "}";
+        res.json = true;
+    } else {
+        res.out = net->zones_report;
+    }
+    return res;
+}
+
+RunResult handle_cache(const PathTreeCache* cache) {
+    RunResult res;
+    if (cache == nullptr) {
+        res.out = "disabled\n";
+        return res;
+    }
+    const PathTreeCacheStats stats = cache->stats();
+    res.out = "hits " + std::to_string(stats.hits) + "\nmisses " + std::to_string(stats.misses)
+            + "\nevictions " + std::to_string(stats.evictions) + "\ninvalidations "
+            + std::to_string(stats.invalidations) + "\ntrees " + std::to_string(stats.entries)
+            + "\nbytes " + std::to_string(stats.bytes) + "\nlimit_bytes "
+            + std::to_string(cache->limit_bytes()) + "\n";
+    return res;
+}
+
+// -------------------- HTTP/1.1 --------------------
+
+void append_json_string(std::string& out, const std::string& s) {
+    out += '"';
+    for (const char ch : s) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    out += '"';
+}
+
+// stats (если есть) — поле "stats", как у server.py с --stats.
+std::string run_payload(const RunResult& res, long long duration_us, const StatsBlock* stats) {
+    std::string json = "{\"ok\": ";
+    json += (res.exit_code == 0) ? "true" : "false";
+    json += ", \"exit_code\": " + std::to_string(res.exit_code);
+    json += ", \"stdout\": ";
+    if (res.json && res.exit_code == 0) {
+        // Готовый документ вставляется как есть, без экранирования.
+        json += "\"\", \"result\": ";
+        json += res.out;
+    } else {
+        append_json_string(json, res.out);
+    }
+    json += ", \"stderr\": ";
+    append_json_string(json, res.err);
+    json += ", \"duration_ms\": " + std::to_string(duration_us / 1000);
+    json += ", \"duration_us\": " + std::to_string(duration_us);
+    if (stats != nullptr) {
+        std::ostringstream block;
+        write_stats_object(block, *stats);
+        json += ", \"stats\": " + block.str();
+    }
+    json += "}";
+    return json;
+}
+
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::string query; // после '?', без него
+    std::string body;
+    std::string origin; // заголовок Origin; пуст — запрос не из браузера
+    bool keep_alive = true;
+};
+
+// Пути, которые меняют загруженную сеть. CORS у них нет, а запрос с Origin
+// (страница браузера с чужого сайта) отклоняется: простой POST браузер
+// отправляет и без разрешения CORS, запрещено лишь читать ответ.
+bool mutating_path(const std::string& path) {
+    return path == "/api/network" || path == "/api/deltas";
+}
+
+std::string lower(std::string s) {
+    for (char& c : s) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return s;
+}
+
+std::string trim(const std::string& s) {
+    std::size_t b = 0;
+    std::size_t e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+// Параметр format=json в строке запроса.
+// В строке запроса есть параметр param ("format=json", "stats=1").
+bool has_param(const std::string& query, const char* param) {
+    std::size_t begin = 0;
+    while (begin <= query.size()) {
+        std::size_t end = query.find('&', begin);
+        if (end == std::string::npos) end = query.size();
+        if (query.compare(begin, end - begin, param) == 0) return true;
+        begin = end + 1;
+    }
+    return false;
+}
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t k = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (k <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(k);
+    }
+    return true;
+}
+
+// Соединение с буфером: после одного запроса в буфере может остаться начало следующего.
+class Connection {
+public:
+    explicit Connection(int fd) : fd_(fd) {}
+
+    // 1 — запрос прочитан, 0 — соединение закрыто, -1 — ошибка формата.
+    int read_request(HttpRequest& rq) {
+        std::size_t header_end = std::string::npos;
+        while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer_.size() > kMaxHeaderBytes) return -1;
+            if (!fill()) return buffer_.empty() ? 0 : -1;
+        }
+
+        std::istringstream head(buffer_.substr(0, header_end));
+        std::string line;
+        std::getline(head, line);
+        std::istringstream request_line(line);
+        std::string version;
+        request_line >> rq.method >> rq.path >> version;
+        if (rq.method.empty() || rq.path.empty()) return -1;
+        rq.keep_alive = (version != "HTTP/1.0");
+
+        std::size_t length = 0;
+        while (std::getline(head, line)) {
+            const std::size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            const std::string name = lower(trim(line.substr(0, colon)));
+            const std::string value = trim(line.substr(colon + 1));
+            if (name == "content-length") {
+                char* end = nullptr;
+                const unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+                if (end == value.c_str() || n > kMaxBodyBytes) return -1;
+                length = static_cast<std::size_t>(n);
+            } else if (name == "origin") {
+                rq.origin = value;
+            } else if (name == "connection") {
+                const std::string v = lower(value);
+                if (v == "close") rq.keep_alive = false;
+                if (v == "keep-alive") rq.keep_alive = true;
+            }
+        }
+
+        const std::size_t body_begin = header_end + 4;
+        while (buffer_.size() < body_begin + length) {
+            if (!fill()) return -1;
+        }
+        rq.body.assign(buffer_, body_begin, length);
+        buffer_.erase(0, body_begin + length);
+
+        const std::size_t query = rq.path.find('?');
+        if (query != std::string::npos) {
+            rq.query = rq.path.substr(query + 1);
+            rq.path.resize(query);
+        }
+        while (rq.path.size() > 1 && rq.path.back() == '/') rq.path.pop_back();
+        return 1;
+    }
+
+    // cors — разрешить чтение ответа страницам с любого сайта (только для
+    // путей, которые сеть не меняют).
+    bool respond(int status, const char* reason, const std::string& body, bool keep_alive, bool cors) {
+        std::string out = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n";
+        out += "Content-Type: application/json; charset=utf-8\r\n";
+        out += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        if (cors) {
+            out += "Access-Control-Allow-Origin: *\r\n";
+            out += "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
+            out += "Access-Control-Allow-Headers: Content-Type\r\n";
+        }
+        out += "Cache-Control: no-store\r\n";
+        out += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        out += body;
+        return send_all(fd_, out);
+    }
+
+private:
+    bool fill() {
+        char chunk[64 * 1024];
+        const ssize_t k = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (k <= 0) return false;
+        buffer_.append(chunk, static_cast<std::size_t>(k));
+        return true;
+    }
+
+    int fd_;
+    std::string buffer_;
+};
+
+// Запросы одного соединения до его закрытия; fd закрывает вызывающий.
+void serve_connection(int fd, ServiceCore& core) {
+    timeval tv{};
+    tv.tv_sec = kIdleTimeoutSec;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    Connection conn(fd);
+    for (;;) {
+        HttpRequest rq;
+        const int status = conn.read_request(rq);
+        if (status == 0) break;
+        if (status < 0) {
+            conn.respond(400, "Bad Request", "{\"ok\": false, \"error\": \"bad request\"}", false, false);
+            break;
+        }
+        const bool cors = !mutating_path(rq.path);
+        if (rq.method == "OPTIONS") {
+            if (!conn.respond(204, "No Content", "", rq.keep_alive, cors)) break;
+            if (!rq.keep_alive) break;
+            continue;
+        }
+
+        std::string payload;
+        bool sent = false;
+        if (!cors && !rq.origin.empty()) {
+            sent = conn.respond(403, "Forbidden", "{\"ok\": false, \"error\": \"cross-origin request\"}",
+                                rq.keep_alive, false);
+        } else if (core.handle(rq.method, rq.path, rq.query, rq.body, payload)) {
+            sent = conn.respond(200, "OK", payload, rq.keep_alive, cors);
+        } else {
+            sent = conn.respond(404, "Not Found", "{\"ok\": false, \"error\": \"not found\"}", rq.keep_alive, cors);
+        }
+        if (!sent || !rq.keep_alive) break;
+    }
+}
+
+// Остановка по SIGINT/SIGTERM: цикл приема проверяет флаг между poll.
+volatile std::sig_atomic_t g_stop = 0;
+
+void request_stop(int) {
+    g_stop = 1;
+}
+
+// Пул потоков соединений: одновременно обслуживается не больше workers
+// соединений, остальные ждут в очереди listen. Потоки создаются один раз,
+// поэтому и рабочие таблицы поиска (thread_local в solve_request) живут
+// дольше соединения. stop() закрывает открытые соединения на чтение —
+// начатый ответ дописывается — и присоединяет потоки.
+class ConnectionPool {
+public:
+    ConnectionPool(ServiceCore& core, int workers) : core_(core) {
+        for (int i = 0; i < workers; ++i) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~ConnectionPool() {
+        stop();
+    }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Ждать свободного потока не дольше timeout; true — соединение можно
+    // принимать.
+    bool wait_idle(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return idle_cv_.wait_for(lock, timeout, [this] { return idle_ > pending_.size(); });
+    }
+
+    void submit(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(fd);
+        }
+        work_cv_.notify_one();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+            for (int fd : pending_) {
+                ::close(fd);
+            }
+            pending_.clear();
+            for (int fd : active_) {
+                ::shutdown(fd, SHUT_RD);
+            }
+        }
+        work_cv_.notify_all();
+        for (std::thread& t : threads_) {
+            t.join();
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ++idle_;
+            idle_cv_.notify_one();
+            work_cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            --idle_;
+            if (stopping_) {
+                return;
+            }
+            const int fd = pending_.front();
+            pending_.pop_front();
+            active_.push_back(fd);
+            lock.unlock();
+
+            serve_connection(fd, core_);
+
+            lock.lock();
+            // Из active_ — до close: stop() не должен задеть чужой fd с тем же номером.
+            active_.erase(std::find(active_.begin(), active_.end(), fd));
+            ::close(fd);
+        }
+    }
+
+    ServiceCore& core_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<int> pending_;
+    std::vector<int> active_;
+    std::size_t idle_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace
+
+struct ServiceCore::State {
+    NetworkSlot slot;
+    PathTreeCache cache;
+    PathTreeCache* shared_cache;
+
+    explicit State(std::size_t cache_bytes)
+        : cache(cache_bytes), shared_cache(cache_bytes > 0 ? &cache : nullptr) {}
+};
+
+ServiceCore::ServiceCore(std::size_t cache_bytes) : state_(std::make_unique<State>(cache_bytes)) {}
+
+ServiceCore::~ServiceCore() = default;
+
+bool ServiceCore::load_file(const std::string& path, std::string& error) {
+    std::shared_ptr<LoadedNetwork> loaded;
+    if (is_snapshot_file(path)) {
+        loaded = load_network_snapshot(path, error);
+    } else {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "service: cannot open " + path;
+            return false;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        std::size_t consumed = 0;
+        loaded = load_network(text.str(), consumed, error);
+    }
+    if (!loaded) {
+        return false;
+    }
+    state_->slot.set(std::move(loaded));
+    return true;
+}
+
+bool ServiceCore::handle(const std::string& method, const std::string& path, const std::string& query,
+                         const std::string& body, std::string& response) {
+    NetworkSlot& slot = state_->slot;
+    PathTreeCache* cache = state_->shared_cache;
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool json = has_param(query, "format=json");
+    // Запрос целиком обрабатывается в вызывающем потоке, поэтому разность
+    // блока потока до и после — счетчики только этого ответа, даже когда
+    // соседние соединения ищут параллельно.
+    const bool with_stats = has_param(query, "stats=1");
+    const StatsBlock before = thread_stats();
+    RunResult res;
+    if (method == "POST" && path == "/api/run") {
+        res = handle_run(slot, cache, body, json);
+    } else if (method == "POST" && path == "/api/network") {
+        res = handle_network(slot, body);
+    } else if (method == "POST" && path == "/api/deltas") {
+        res = handle_deltas(slot, body);
+    } else if (method == "POST" && path == "/api/route") {
+        res = handle_route(slot, cache, body, json);
+    } else if (method == "POST" && path == "/api/sweep") {
+        res = handle_sweep(slot, body);
+    } else if (method == "GET" && path == "/api/zones") {
+        res = handle_zones(slot, json);
+    } else if (method == "GET" && path == "/api/cache") {
+        res = handle_cache(cache);
+    } else if (method == "GET" && path == "/api/health") {
+        res.out = slot.get() ? "loaded\n" : "empty\n";
+    } else {
+        return false;
+    }
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    StatsBlock used = thread_stats();
+    used -= before;
+    response = run_payload(res, us, with_stats ? &used : nullptr);
+    return true;
+}
+
+int run_service(const ServiceOptions& options) {
+    ServiceCore core(options.cache_bytes);
+    if (!options.network_path.empty()) {
+        std::string error;
+        if (!core.load_file(options.network_path, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::perror("service: socket");
+        return 1;
+    }
+    const int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(options.port));
+    if (::inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "service: invalid host " << options.host << "\n";
+        ::close(listener);
+        return 1;
+    }
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listener, 64) < 0) {
+        std::perror("service: bind/listen");
+        ::close(listener);
+        return 1;
+    }
+
+    std::cerr << "service: listening on " << options.host << ":" << options.port << "\n";
+
+    g_stop = 0;
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    // Соединение принимается, только когда есть свободный поток пула; иначе
+    // клиенты ждут в очереди listen, а не плодят потоки.
+    ConnectionPool pool(core, options.max_connections);
+    const std::chrono::milliseconds tick(kStopPollMs);
+    while (!g_stop) {
+        if (!pool.wait_idle(tick)) {
+            continue;
+        }
+        pollfd p{listener, POLLIN, 0};
+        if (::poll(&p, 1, kStopPollMs) <= 0) {
+            continue;
+        }
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd >= 0) {
+            pool.submit(fd);
+        }
+    }
+
+    ::close(listener);
+    pool.stop();
+    std::cerr << "service: stopped\n";
+    return 0;
+}
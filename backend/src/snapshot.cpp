@@ -0,0 +1,317 @@
+#include "snapshot.hpp"
+
+#include "algorithms.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char kMagic[8] = {'R', 'N', 'A', 'V', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t kEndianMarker = 0x01020304u;
+
+std::uint64_t align_up(std::uint64_t x) {
+    return (x + kSnapshotAlign - 1) / kSnapshotAlign * kSnapshotAlign;
+}
+
+// Контрольная сумма по 8-байтным словам; длина данных кратна 8
+// (секции дополнены нулями до kSnapshotAlign).
+struct Checksum {
+    std::uint64_t h = 0x243F6A8885A308D3ull;
+
+    void update(const void* data, std::size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i + 8 <= bytes; i += 8) {
+            std::uint64_t w = 0;
+            std::memcpy(&w, p + i, 8);
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+            h ^= h >> 32;
+        }
+    }
+};
+
+std::uint64_t header_checksum(const SnapshotHeader& h) {
+    Checksum c;
+    c.update(&h, offsetof(SnapshotHeader, header_checksum));
+    return c.h;
+}
+
+struct SectionData {
+    const void* data;
+    std::uint64_t bytes;
+};
+
+template <typename T>
+SectionData section_of(ArrayView<T> v) {
+    return SectionData{v.data(), static_cast<std::uint64_t>(v.size() * sizeof(T))};
+}
+
+template <typename T>
+SectionData section_of(const std::vector<T>& v) {
+    return SectionData{v.data(), static_cast<std::uint64_t>(v.size() * sizeof(T))};
+}
+
+bool check_section(const SnapshotHeader& h, int id, std::uint64_t expected_bytes, std::uint64_t file_size) {
+    const SnapshotSection& s = h.sections[id];
+    return s.bytes == expected_bytes
+        && s.offset % kSnapshotAlign == 0
+        && s.offset >= sizeof(SnapshotHeader)
+        && s.offset <= file_size
+        && s.bytes <= file_size - s.offset;
+}
+
+template <typename T>
+ArrayView<T> view_of(const unsigned char* base, const SnapshotSection& s) {
+    return ArrayView<T>(reinterpret_cast<const T*>(base + s.offset), static_cast<std::size_t>(s.bytes / sizeof(T)));
+}
+
+// Массивы, которые поиски используют как индексы, проверяются всегда, даже
+// без verify: смещения не убывают от 0 до числа дуг, концы дуг — станции
+// 1..n, id рёбер неотрицательны, метки зон — -1 или номер компоненты < n.
+// Иначе испорченный файл с верной контрольной суммой заголовка давал бы
+// чтение за пределами отображения.
+bool check_arrays(const FrozenGraph& g, const std::array<ArrayView<int>, 4>& labels, std::string& error) {
+    if (g.offsets[0] != 0 || static_cast<std::size_t>(g.offsets.back()) != g.to.size()) {
+        error = "snapshot: corrupted offsets";
+        return false;
+    }
+    for (std::size_t i = 1; i < g.offsets.size(); ++i) {
+        if (g.offsets[i] < g.offsets[i - 1]) {
+            error = "snapshot: corrupted offsets";
+            return false;
+        }
+    }
+    for (std::size_t arc = 0; arc < g.to.size(); ++arc) {
+        if (g.to[arc] < 1 || g.to[arc] > g.n) {
+            error = "snapshot: arc to invalid station";
+            return false;
+        }
+        if (g.edge_id[arc] < 0) {
+            error = "snapshot: invalid edge id";
+            return false;
+        }
+    }
+    for (const ArrayView<int>& t : labels) {
+        for (int v = 0; v <= g.n; ++v) {
+            if (t[static_cast<std::size_t>(v)] < -1 || t[static_cast<std::size_t>(v)] >= g.n) {
+                error = "snapshot: invalid zone label";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool write_snapshot(const std::string& path, const FrozenGraph& g, const ModelParams& model, std::string& error, int threads) {
+    error.clear();
+
+    const std::vector<int> labels[4] = {
+        component_labels(g, TransportType::Metro, threads),
+        component_labels(g, TransportType::Bus, threads),
+        component_labels(g, TransportType::Rail, threads),
+        component_labels(g, TransportType::All, threads),
+    };
+
+    const SectionData sections[kSectionCount] = {
+        section_of(g.offsets),
+        section_of(g.to),
+        section_of(g.edge_id),
+        section_of(g.base_time),
+        section_of(g.load),
+        section_of(model.station_transfer),
+        section_of(labels[0]),
+        section_of(labels[1]),
+        section_of(labels[2]),
+        section_of(labels[3]),
+    };
+
+    SnapshotHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kSnapshotVersion;
+    h.endian = kEndianMarker;
+    h.header_bytes = static_cast<std::uint32_t>(sizeof(SnapshotHeader));
+    h.section_count = kSectionCount;
+    h.n = g.n;
+    h.m = g.m;
+    h.arc_count = static_cast<std::uint64_t>(g.arc_count());
+    for (int i = 0; i < 3; ++i) {
+        h.sensitivity[i] = model.sensitivity[static_cast<std::size_t>(i)];
+        for (int j = 0; j < 3; ++j) {
+            h.trans[3 * i + j] = model.trans[static_cast<std::size_t>(i)][static_cast<std::size_t>(j)];
+        }
+    }
+
+    std::uint64_t pos = align_up(sizeof(SnapshotHeader));
+    for (int s = 0; s < kSectionCount; ++s) {
+        h.sections[s].offset = pos;
+        h.sections[s].bytes = sections[s].bytes;
+        pos = align_up(pos + sections[s].bytes);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "snapshot: cannot open " + path + " for writing";
+        return false;
+    }
+
+    // Заголовок пишется дважды: заглушка, затем итоговый с контрольными суммами.
+    const std::vector<char> zeros(static_cast<std::size_t>(kSnapshotAlign), 0);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(zeros.data(), static_cast<std::streamsize>(align_up(sizeof(h)) - sizeof(h)));
+
+    Checksum payload;
+    for (int s = 0; s < kSectionCount; ++s) {
+        const std::uint64_t padded = align_up(sections[s].bytes);
+        out.write(static_cast<const char*>(sections[s].data), static_cast<std::streamsize>(sections[s].bytes));
+        out.write(zeros.data(), static_cast<std::streamsize>(padded - sections[s].bytes));
+
+        // Сумма считается по тем же байтам, что легли в файл (данные + нули).
+        const std::uint64_t whole = sections[s].bytes / 8 * 8;
+        payload.update(sections[s].data, static_cast<std::size_t>(whole));
+        unsigned char tail[kSnapshotAlign + 8] = {};
+        std::memcpy(tail, static_cast<const unsigned char*>(sections[s].data) + whole,
+                    static_cast<std::size_t>(sections[s].bytes - whole));
+        payload.update(tail, static_cast<std::size_t>(padded - whole));
+    }
+
+    h.payload_checksum = payload.h;
+    h.header_checksum = header_checksum(h);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.flush();
+    if (!out) {
+        error = "snapshot: write failed for " + path;
+        return false;
+    }
+    return true;
+}
+
+bool load_snapshot(const std::string& path, Snapshot& out, bool verify, std::string& error) {
+    error.clear();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "snapshot: cannot open " + path;
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        error = "snapshot: file too small";
+        return false;
+    }
+    const std::uint64_t size = static_cast<std::uint64_t>(st.st_size);
+    void* addr = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = "snapshot: mmap failed";
+        return false;
+    }
+    std::shared_ptr<const void> mapping(addr, [size](const void* p) {
+        ::munmap(const_cast<void*>(p), static_cast<std::size_t>(size));
+    });
+
+    const unsigned char* base = static_cast<const unsigned char*>(addr);
+    SnapshotHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "snapshot: bad magic";
+        return false;
+    }
+    if (h.endian != kEndianMarker) {
+        error = "snapshot: byte order mismatch";
+        return false;
+    }
+    if (h.version != kSnapshotVersion || h.header_bytes != sizeof(SnapshotHeader) || h.section_count != kSectionCount) {
+        error = "snapshot: unsupported version";
+        return false;
+    }
+    if (h.header_checksum != header_checksum(h)) {
+        error = "snapshot: header checksum mismatch";
+        return false;
+    }
+    if (h.n <= 0 || h.m < 0 || h.arc_count != 2 * static_cast<std::uint64_t>(h.m)) {
+        error = "snapshot: invalid N or M";
+        return false;
+    }
+
+    const std::uint64_t rows = static_cast<std::uint64_t>(h.n) + 1;
+    const std::uint64_t arcs = h.arc_count;
+    const std::uint64_t expected[kSectionCount] = {
+        (3 * rows + 1) * sizeof(int),
+        arcs * sizeof(int),
+        arcs * sizeof(int),
+        arcs * sizeof(double),
+        arcs * sizeof(double),
+        rows * sizeof(double),
+        rows * sizeof(int),
+        rows * sizeof(int),
+        rows * sizeof(int),
+        rows * sizeof(int),
+    };
+    for (int s = 0; s < kSectionCount; ++s) {
+        if (!check_section(h, s, expected[s], size)) {
+            error = "snapshot: section out of bounds";
+            return false;
+        }
+    }
+
+    if (verify) {
+        Checksum payload;
+        const std::uint64_t first = align_up(sizeof(SnapshotHeader));
+        payload.update(base + first, static_cast<std::size_t>(size - first));
+        if (payload.h != h.payload_checksum) {
+            error = "snapshot: payload checksum mismatch";
+            return false;
+        }
+    }
+
+    FrozenGraph g;
+    g.n = h.n;
+    g.m = h.m;
+    g.offsets = view_of<int>(base, h.sections[kSectionOffsets]);
+    g.to = view_of<int>(base, h.sections[kSectionTo]);
+    g.edge_id = view_of<int>(base, h.sections[kSectionEdgeId]);
+    g.base_time = view_of<double>(base, h.sections[kSectionBaseTime]);
+    g.load = view_of<double>(base, h.sections[kSectionLoad]);
+    std::array<ArrayView<int>, 4> labels;
+    for (int t = 0; t < 4; ++t) {
+        labels[static_cast<std::size_t>(t)] = view_of<int>(base, h.sections[kSectionLabelsMetro + t]);
+    }
+    if (!check_arrays(g, labels, error)) {
+        return false;
+    }
+    g.storage = mapping;
+    g.version = next_weights_version();
+
+    const ArrayView<double> station = view_of<double>(base, h.sections[kSectionStationTransfer]);
+    for (int i = 0; i < 3; ++i) {
+        out.model.sensitivity[static_cast<std::size_t>(i)] = h.sensitivity[i];
+        for (int j = 0; j < 3; ++j) {
+            out.model.trans[static_cast<std::size_t>(i)][static_cast<std::size_t>(j)] = h.trans[3 * i + j];
+        }
+    }
+    out.model.station_transfer.assign(station.begin(), station.end());
+
+    out.component_labels = labels;
+    out.g = std::move(g);
+    return true;
+}
+
+bool is_snapshot_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
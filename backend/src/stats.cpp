@@ -0,0 +1,92 @@
+#include "stats.hpp"
+
+#include <cstdio>
+#include <mutex>
+
+namespace {
+
+// Порядок — как в enum Counter.
+const char* const kCounterNames[kCounterCount] = {
+    "parsed_bytes", "parsed_edges", "parsed_requests",
+    "validated_arcs", "validated_requests",
+    "dfs_vertices", "dfs_arcs",
+    "searches", "heap_pushes", "stale_pops", "settled_states", "relaxations",
+};
+
+const char* const kPhaseNames[kPhaseCount] = {"parse", "validate", "zones", "prepare", "search", "output"};
+
+std::mutex g_mutex;
+StatsBlock g_total;
+
+} // namespace
+
+StatsBlock& StatsBlock::operator+=(const StatsBlock& other) {
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        counters[i] += other.counters[i];
+    }
+    for (std::size_t i = 0; i < kPhaseCount; ++i) {
+        phase_ns[i] += other.phase_ns[i];
+    }
+    return *this;
+}
+
+StatsBlock& StatsBlock::operator-=(const StatsBlock& other) {
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        counters[i] -= other.counters[i];
+    }
+    for (std::size_t i = 0; i < kPhaseCount; ++i) {
+        phase_ns[i] -= other.phase_ns[i];
+    }
+    return *this;
+}
+
+StatsBlock& thread_stats() {
+    thread_local StatsBlock block;
+    return block;
+}
+
+void stats_flush_thread() {
+    if constexpr (kStatsEnabled) {
+        StatsBlock& own = thread_stats();
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_total += own;
+        own = StatsBlock{};
+    }
+}
+
+StatsBlock stats_collect() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    StatsBlock total = g_total;
+    total += thread_stats();
+    return total;
+}
+
+void stats_reset() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_total = StatsBlock{};
+    thread_stats() = StatsBlock{};
+}
+
+void write_stats_json(std::ostream& out, const StatsBlock& stats) {
+    out << "{\"stats\":";
+    write_stats_object(out, stats);
+    out << '}';
+}
+
+void write_stats_object(std::ostream& out, const StatsBlock& stats) {
+    if (!kStatsEnabled) {
+        out << "{\"enabled\":false}";
+        return;
+    }
+    out << "{\"enabled\":true,\"counters\":{";
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        out << (i > 0 ? "," : "") << '"' << kCounterNames[i] << "\":" << stats.counters[i];
+    }
+    out << "},\"phases_ms\":{";
+    for (std::size_t i = 0; i < kPhaseCount; ++i) {
+        char ms[32];
+        std::snprintf(ms, sizeof(ms), "%.3f", static_cast<double>(stats.phase_ns[i]) / 1e6);
+        out << (i > 0 ? "," : "") << '"' << kPhaseNames[i] << "\":" << ms;
+    }
+    out << "}}";
+}
@@ -1,4 +1,5 @@
 #include "validator.hpp"
+#include "stats.hpp"
 
 #include <cmath>      // std::isfinite
 #include <limits>
@@ -14,7 +15,9 @@ bool validate_graph(const Graph& g, std::string& error) {
     if ((int)g.adj.size() != g.n + 1) { error = "validate_graph: adj size must be N+1"; return false; }
 
     // Проверим каждое ребро в списках смежности
+    std::size_t arcs = 0;
     for (int u = 1; u <= g.n; ++u) {
+        arcs += g.adj[u].size();
         for (const Edge& e : g.adj[u]) {
             if (e.to < 1 || e.to > g.n) {
                 error = "validate_graph: edge has invalid 'to' vertex";
@@ -43,6 +46,7 @@ bool validate_graph(const Graph& g, std::string& error) {
     // g.m — число неориентированных ребер; не обязаны строго сверять,
     // но базово оно должно быть >=0
     if (g.m < 0) { error = "validate_graph: M must be >= 0"; return false; }
+    stats_add(Counter::ValidatedArcs, arcs);
 
     return true;
 }
@@ -86,12 +90,16 @@ bool validate_model(const Graph& g, const ModelParams& m, std::string& error) {
 }
 
 bool validate_requests(const Graph& g, const std::vector<Request>& reqs, std::string& error) {
+    return validate_requests(g.n, reqs, error);
+}
+
+bool validate_requests(int n, const std::vector<Request>& reqs, std::string& error) {
     error.clear();
 
     for (std::size_t qi = 0; qi < reqs.size(); ++qi) {
         const Request& r = reqs[qi];
 
-        if (r.start < 1 || r.start > g.n) {
+        if (r.start < 1 || r.start > n) {
             error = "validate_requests: query has invalid start station";
             return false;
         }
@@ -100,12 +108,34 @@ bool validate_requests(const Graph& g, const std::vector<Request>& reqs, std::st
             return false;
         }
         for (int t : r.targets) {
-            if (t < 1 || t > g.n) {
+            if (t < 1 || t > n) {
                 error = "validate_requests: query has invalid target station";
                 return false;
             }
         }
     }
+    stats_add(Counter::ValidatedRequests, reqs.size());
+
+    return true;
+}
+
+bool validate_matrix_requests(int n, const std::vector<MatrixRequest>& matrices, std::string& error) {
+    error.clear();
+
+    for (const MatrixRequest& mr : matrices) {
+        for (int s : mr.sources) {
+            if (s < 1 || s > n) {
+                error = "validate_matrix_requests: matrix has invalid source station";
+                return false;
+            }
+        }
+        for (int t : mr.targets) {
+            if (t < 1 || t > n) {
+                error = "validate_matrix_requests: matrix has invalid target station";
+                return false;
+            }
+        }
+    }
 
     return true;
 }
@@ -114,5 +144,6 @@ bool validate_all(const InputData& data, std::string& error) {
     if (!validate_graph(data.g, error)) return false;
     if (!validate_model(data.g, data.model, error)) return false;
     if (!validate_requests(data.g, data.requests, error)) return false;
+    if (!validate_matrix_requests(data.g.n, data.matrices, error)) return false;
     return true;
 }
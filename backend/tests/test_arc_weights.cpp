@@ -0,0 +1,122 @@
+#include "algorithms.hpp"
+#include "arc_weights.hpp"
+#include "matrix.hpp"
+#include "parser.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Массив бит в бит равен arc_time, вид дуги — срезу CSR.
+void check_weights(const FrozenGraph& fg, const std::array<double, 3>& s, const ArcWeights& w) {
+    CHECK(w.matches(fg, s));
+    CHECK(w.mode.size() == fg.arc_count());
+    for (int u = 1; u <= fg.n; ++u) {
+        for (int m = 0; m < 3; ++m) {
+            for (int a = fg.mode_begin(u, m); a < fg.mode_end(u, m); ++a) {
+                const std::size_t i = static_cast<std::size_t>(a);
+                CHECK(w.mode[i] == m);
+                CHECK(w.time[i] == arc_time(fg, a, m, s));
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    const int n = 80;
+    Graph g;
+    graph_init(g, n);
+    TestRandom next(29u);
+    add_random_edges(g, next, n, 230);
+    FrozenGraph fg = freeze_graph(g);
+    ModelParams model = random_model(n);
+
+    ArcWeights w = materialize_arc_weights(fg, model.sensitivity);
+    check_weights(fg, model.sensitivity, w);
+
+    {
+        // Поиски с массивом и без него дают те же маршруты: Дейкстра по
+        // целям, двунаправленный поиск, radix-куча, фиксированная точка.
+        SearchOptions plain;
+        SearchOptions radix;
+        radix.queue = QueueKind::Radix;
+        SearchOptions fixed;
+        fixed.time_resolution = 0.5;
+        for (int s = 1; s <= n; s += 7) {
+            Request many{s, {2, 11, 37, 64, s}, 1.5};
+            Request one{s, {1 + (s * 13) % n}, 0.5};
+            for (SearchOptions options : {plain, radix, fixed}) {
+                const std::vector<Route> a = solve_request(fg, model, many, options);
+                const std::vector<Route> b = solve_request(fg, model, one, options);
+                options.arc_weights = &w;
+                expect_same_routes(a, solve_request(fg, model, many, options));
+                expect_same_routes(b, solve_request(fg, model, one, options));
+            }
+        }
+
+        // Матрица по Дейкстре.
+        SearchOptions options;
+        options.arc_weights = &w;
+        const std::vector<int> sources{1, 5, 9, 40};
+        const std::vector<int> targets{3, 6, 70, 80};
+        const TravelMatrix a = travel_time_matrix(fg, model, sources, targets);
+        const TravelMatrix b = travel_time_matrix(fg, model, sources, targets, options);
+        CHECK(a.time == b.time && a.transfers == b.transfers);
+    }
+
+    {
+        // Изменения весов рёбер: пересчитываются дуги этих рёбер, результат
+        // совпадает с новой материализацией.
+        std::vector<EdgeDelta> deltas;
+        for (int i = 0; i < 20; ++i) {
+            deltas.push_back(EdgeDelta{static_cast<int>(next(static_cast<unsigned>(fg.m))), 2.0 + next(7),
+                                       0.05 * next(20)});
+        }
+        FrozenGraph changed = fg;
+        std::string error;
+        CHECK(frozen_apply_deltas(changed, deltas, error));
+        CHECK(!w.matches(changed, model.sensitivity)); // старый массив не годится
+
+        ArcWeights updated = w;
+        update_arc_weights(updated, changed, model.sensitivity, deltas);
+        check_weights(changed, model.sensitivity, updated);
+        CHECK(updated.time == materialize_arc_weights(changed, model.sensitivity).time);
+
+        // Второй пакет поверх первого (индекс рёбер уже построен).
+        const std::vector<EdgeDelta> more{{deltas[0].id, 7.5, 0.9}, {0, 1.0, 0.0}};
+        CHECK(frozen_apply_deltas(changed, more, error));
+        update_arc_weights(updated, changed, model.sensitivity, more);
+        check_weights(changed, model.sensitivity, updated);
+
+        // Поиск с устаревшим массивом считает по формуле.
+        SearchOptions stale;
+        stale.arc_weights = &w;
+        const Request rq{1, {20, 50, 79}, 0.0};
+        expect_same_routes(solve_request(changed, model, rq), solve_request(changed, model, rq, stale));
+    }
+
+    {
+        // Новая чувствительность одного вида: пересчитываются дуги вида.
+        ModelParams other = model;
+        other.sensitivity[1] = 3.25;
+        ArcWeights updated = w;
+        update_arc_weights(updated, fg, other.sensitivity, {});
+        check_weights(fg, other.sensitivity, updated);
+        CHECK(updated.time == materialize_arc_weights(fg, other.sensitivity).time);
+        CHECK(!w.matches(fg, other.sensitivity));
+
+        // Массив другой топологии: полный пересчет.
+        ArcWeights empty;
+        update_arc_weights(empty, fg, other.sensitivity, {});
+        check_weights(fg, other.sensitivity, empty);
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include "contraction.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+ModelParams make_model(int n) {
+    ModelParams model{};
+    model.station_transfer.assign(static_cast<std::size_t>(n) + 1, 0.0);
+    return model;
+}
+
+// Шаги образуют путь из start в target, а их стоимость равна времени маршрута.
+void expect_path(const FrozenGraph& g, const ModelParams& model, const Request& rq, const Route& route) {
+    if (route.steps.empty()) {
+        return;
+    }
+    CHECK(route.steps.front().from == rq.start);
+    CHECK(route.steps.back().to == route.target);
+    for (std::size_t i = 1; i < route.steps.size(); ++i) {
+        CHECK(route.steps[i - 1].to == route.steps[i].from);
+    }
+    Route copy = route;
+    evaluate_route(g, model, copy, rq.k);
+    CHECK(copy.time == route.time);
+    CHECK(copy.transfers == route.transfers);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Пересадка metro -> bus дешевле, чем прямой rail: ярлык должен
+        // раскрыться в исходные шаги с видами транспорта.
+        Graph g;
+        graph_init(g, 4);
+        graph_add_undirected(g, 1, 2, MODE_METRO, 2.0, 0.0);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 2.0, 0.0);
+        graph_add_undirected(g, 3, 4, MODE_BUS, 2.0, 0.0);
+        graph_add_undirected(g, 1, 4, MODE_RAIL, 10.0, 0.0);
+
+        ModelParams model = make_model(4);
+        model.trans = {{{0.0, 1.0, 1.0}, {1.0, 0.0, 1.0}, {1.0, 1.0, 0.0}}};
+        model.station_transfer[3] = 0.5;
+
+        const FrozenGraph fg = freeze_graph(g);
+        const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+
+        Request rq;
+        rq.start = 1;
+        rq.k = 2.0;
+        rq.targets = {4, 1};
+        const std::vector<Route> routes = solve_request_ch(ch, fg, model, rq);
+        CHECK(routes.size() == 2);
+
+        CHECK(routes[0].target == 1);
+        CHECK(routes[0].reachable);
+        CHECK(routes[0].steps.empty());
+
+        const Route& route = routes[1];
+        CHECK(route.target == 4);
+        CHECK(route.reachable);
+        CHECK(route.time == 7.5);
+        CHECK(route.transfers == 1);
+        CHECK(route.metric == 9.5);
+        CHECK(route.steps.size() == 3);
+        CHECK(route.steps[0].from == 1 && route.steps[0].to == 2 && route.steps[0].mode == MODE_METRO);
+        CHECK(route.steps[1].from == 2 && route.steps[1].to == 3 && route.steps[1].mode == MODE_METRO);
+        CHECK(route.steps[2].from == 3 && route.steps[2].to == 4 && route.steps[2].mode == MODE_BUS);
+    }
+
+    {
+        // Случайные сети с двоично-рациональными весами (сложение точное):
+        // значения должны совпадать с полным проходом Дейкстры бит в бит.
+        const int n = 80;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(11u);
+        for (int i = 0; i < 200; ++i) {
+            const int u = 1 + static_cast<int>(next(n));
+            const int v = 1 + static_cast<int>(next(n));
+            graph_add_undirected(g, u, v, static_cast<int>(next(3)), static_cast<double>(next(8)), 0.25 * next(5));
+        }
+
+        ModelParams model = make_model(n);
+        model.sensitivity = {0.5, 1.0, 0.25};
+        model.trans = {{{0.0, 2.0, 0.5}, {1.5, 0.0, 3.0}, {0.0, 2.5, 0.0}}}; // несимметричная
+        for (int v = 1; v <= n; ++v) {
+            model.station_transfer[v] = 0.5 * next(3);
+        }
+
+        const FrozenGraph fg = freeze_graph(g);
+        const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+
+        SearchOptions options;
+        options.hierarchy = &ch;
+
+        for (int start = 1; start <= n; start += 3) {
+            Request rq;
+            rq.start = start;
+            rq.k = 1.5;
+            for (int t = 0; t < 6; ++t) {
+                rq.targets.push_back(1 + static_cast<int>(next(n)));
+            }
+
+            const DijkstraStateResult dj = dijkstra_states(fg, model, start);
+            const std::vector<Route> routes = solve_request(fg, model, rq, options);
+            CHECK(routes.size() == rq.targets.size());
+            for (const Route& route : routes) {
+                const Route full = build_route_to_target(dj, model, start, route.target, rq.k);
+                CHECK(route.reachable == full.reachable);
+                if (route.reachable) {
+                    CHECK(route.time == full.time);
+                    CHECK(route.transfers == full.transfers);
+                    CHECK(route.metric == full.metric);
+                    expect_path(fg, model, rq, route);
+                }
+            }
+        }
+    }
+
+    {
+        // Рёбра с нулевым временем: ярлык, добавленный при равенстве
+        // стоимостей, раскрывался в обход 1-[bus]->2 2-[bus]->1 1-[bus]->2.
+        // Шаги должны совпасть с маршрутом Дейкстры.
+        const int edges[][4] = {
+            {2, 2, 2, 2}, {4, 1, 2, 1}, {1, 3, 0, 4}, {4, 4, 1, 9}, {3, 1, 0, 2}, {4, 3, 1, 8},
+            {3, 4, 2, 3}, {1, 3, 2, 10}, {3, 1, 2, 10}, {3, 3, 0, 1}, {4, 1, 1, 1}, {1, 3, 1, 6},
+            {1, 4, 2, 9}, {2, 1, 1, 0}, {1, 2, 1, 4}, {1, 3, 1, 5}, {4, 4, 2, 6}, {1, 3, 1, 10},
+        };
+        const double loads[] = {0.87, 0.16, 0.47, 0.0, 0.5, 0.83, 0.9, 0.7, 0.21, 0.48, 0.0, 0.0,
+                                0.5, 0.08, 0.0, 0.5, 0.64, 0.0};
+        Graph g;
+        graph_init(g, 4);
+        for (std::size_t i = 0; i < std::size(edges); ++i) {
+            graph_add_undirected(g, edges[i][0], edges[i][1], edges[i][2], edges[i][3], loads[i]);
+        }
+        ModelParams model = make_model(4);
+        model.sensitivity = {0.6, 0.63, 0.07};
+        model.trans = {{{0.0, 0.0, 3.0}, {2.0, 0.0, 1.0}, {1.0, 3.0, 0.0}}};
+        model.station_transfer = {0.0, 2.0, 2.0, 1.0, 1.0};
+
+        const FrozenGraph fg = freeze_graph(g);
+        const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+        Request rq;
+        rq.start = 3;
+        rq.k = 0.0;
+        rq.targets = {4, 2, 1};
+        const std::vector<Route> routes = solve_request_ch(ch, fg, model, rq);
+        const DijkstraStateResult dj = dijkstra_states(fg, model, rq.start);
+        for (const Route& route : routes) {
+            const Route full = build_route_to_target(dj, model, rq.start, route.target, rq.k);
+            CHECK(route.steps.size() == full.steps.size());
+            for (std::size_t i = 0; i < route.steps.size(); ++i) {
+                CHECK(route.steps[i].from == full.steps[i].from);
+                CHECK(route.steps[i].to == full.steps[i].to);
+                CHECK(route.steps[i].mode == full.steps[i].mode);
+            }
+        }
+    }
+
+    {
+        // Случайные сети, где много рёбер нулевого времени: шаги иерархии не
+        // возвращаются ни в start, ни в пройденное состояние (станция, вид) —
+        // такой цикл всегда лишний; стоимость та же, что у Дейкстры. Станция
+        // может повториться с другим видом: при несимметричных пересадках
+        // крюк бывает дешевле.
+        const int n = 12;
+        TestRandom next(5u);
+        for (int round = 0; round < 40; ++round) {
+            Graph g;
+            graph_init(g, n);
+            for (int i = 0; i < 30; ++i) {
+                const int u = 1 + static_cast<int>(next(n));
+                const int v = 1 + static_cast<int>(next(n));
+                const double base = next(2) == 0 ? 0.0 : static_cast<double>(next(4));
+                graph_add_undirected(g, u, v, static_cast<int>(next(3)), base, 0.0);
+            }
+            ModelParams model = make_model(n);
+            model.trans = {{{0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}, {2.0, 0.0, 0.0}}};
+
+            const FrozenGraph fg = freeze_graph(g);
+            const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+            Request rq;
+            rq.start = 1 + static_cast<int>(next(n));
+            rq.k = 1.0;
+            for (int t = 1; t <= n; ++t) {
+                rq.targets.push_back(t);
+            }
+            const DijkstraStateResult dj = dijkstra_states(fg, model, rq.start);
+            for (const Route& route : solve_request_ch(ch, fg, model, rq)) {
+                const Route full = build_route_to_target(dj, model, rq.start, route.target, rq.k);
+                CHECK(route.reachable == full.reachable);
+                if (!route.reachable) {
+                    continue;
+                }
+                CHECK(route.time == full.time);
+                CHECK(route.transfers == full.transfers);
+                std::vector<bool> seen(3 * (static_cast<std::size_t>(n) + 1), false);
+                for (const Step& step : route.steps) {
+                    CHECK(step.to != rq.start);
+                    const std::size_t state = 3 * static_cast<std::size_t>(step.to) + static_cast<std::size_t>(step.mode);
+                    CHECK(!seen[state]);
+                    seen[state] = true;
+                }
+                expect_path(fg, model, rq, route);
+            }
+        }
+    }
+
+    {
+        // Почти равные суммы: 0.1 + 0.2 > 0.3 в double. Иерархия, как и
+        // Дейкстра, выбирает 1-[metro]->4 4-[bus]->3 с пересадкой.
+        Graph g;
+        graph_init(g, 4);
+        graph_add_undirected(g, 1, 2, MODE_METRO, 0.1, 0.0);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 0.2, 0.0);
+        graph_add_undirected(g, 1, 4, MODE_METRO, 0.0, 0.0);
+        graph_add_undirected(g, 4, 3, MODE_BUS, 0.3, 0.0);
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams model = make_model(4);
+        const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+
+        Request rq;
+        rq.start = 1;
+        rq.k = 5.0;
+        rq.targets = {3};
+        const std::vector<Route> routes = solve_request_ch(ch, fg, model, rq);
+        CHECK(routes.size() == 1 && routes[0].transfers == 1 && routes[0].time == 0.3);
+        CHECK(routes[0].steps.size() == 2 && routes[0].steps[0].to == 4);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "landmarks.hpp"
+#include "parser.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+ModelParams make_model(int n) {
+    ModelParams model{};
+    model.sensitivity = {1.0, 2.0, 0.5};
+    for (auto& row : model.trans) {
+        row = {0.0, 1.5, 2.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(n) + 1, 0.25);
+    return model;
+}
+
+// Сторона ребра id в Adj[u].
+const Edge& side(const Graph& g, int u, int id) {
+    for (const Edge& e : g.adj[u]) {
+        if (e.id == id) {
+            return e;
+        }
+    }
+    throw std::logic_error("no such side");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Изменение по id меняет обе стороны; индекс сторон остается верным
+        // после удаления соседнего ребра и для петли.
+        Graph g;
+        graph_init(g, 4);
+        graph_add_undirected(g, 1, 2, MODE_BUS, 1.0, 0.0);   // id 0
+        graph_add_undirected(g, 1, 3, MODE_METRO, 2.0, 0.0); // id 1
+        graph_add_undirected(g, 1, 1, MODE_RAIL, 3.0, 0.0);  // id 2, петля
+        graph_add_undirected(g, 4, 1, MODE_BUS, 4.0, 0.0);   // id 3
+        const std::uint64_t version = g.version;
+
+        CHECK(graph_remove_undirected(g, 0));
+        CHECK(g.version == version + 1);
+        CHECK(graph_update_edge(g, 1, 5.0, 0.5));
+        CHECK(graph_update_edge(g, 2, 6.0, 0.25));
+        CHECK(graph_update_edge(g, 3, 7.0, 1.0));
+        CHECK(g.version == version + 4);
+        CHECK(side(g, 1, 1).base_time == 5.0 && side(g, 3, 1).load == 0.5);
+        CHECK(side(g, 4, 3).base_time == 7.0 && side(g, 1, 3).load == 1.0);
+        for (const Edge& e : g.adj[1]) {
+            if (e.id == 2) {
+                CHECK(e.base_time == 6.0 && e.load == 0.25); // обе стороны петли
+            }
+        }
+
+        CHECK(!graph_update_edge(g, 0, 1.0, 0.0)); // удалено
+        CHECK(!graph_update_edge(g, 9, 1.0, 0.0));
+        bool thrown = false;
+        try {
+            graph_update_edge(g, 1, 1.0, 1.5);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(g.version == version + 4);
+
+        CHECK(graph_remove_undirected(g, 2));
+        CHECK(graph_remove_undirected(g, 1));
+        CHECK(graph_update_edge(g, 3, 8.0, 0.0));
+        CHECK(side(g, 1, 3).base_time == 8.0 && g.adj[1].size() == 1);
+    }
+
+    {
+        // Пакет изменений снимка равен пересборке снимка из измененного Graph;
+        // копия, сделанная до изменений, видит прежние веса.
+        const int n = 40;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(17u);
+        add_random_edges(g, next, n, 120);
+        const ModelParams model = make_model(n);
+
+        FrozenGraph fg = freeze_graph(g);
+        const FrozenGraph before = fg;
+        const Landmarks lm = build_landmarks(fg, 4);
+
+        std::vector<EdgeDelta> deltas;
+        for (int i = 0; i < 300; ++i) {
+            EdgeDelta d;
+            d.id = static_cast<int>(next(static_cast<unsigned>(g.next_id)));
+            d.base_time = 0.5 + next(20);
+            d.load = 0.05 * next(21);
+            deltas.push_back(d);
+            graph_update_edge(g, d.id, d.base_time, d.load);
+        }
+        std::string error;
+        CHECK(frozen_apply_deltas(fg, deltas, error));
+        CHECK(fg.version > before.version);
+
+        const FrozenGraph rebuilt = freeze_graph(g);
+        for (std::size_t arc = 0; arc < fg.arc_count(); ++arc) {
+            CHECK(fg.base_time[arc] == rebuilt.base_time[arc]);
+            CHECK(fg.load[arc] == rebuilt.load[arc]);
+        }
+        bool changed = false;
+        for (std::size_t arc = 0; arc < before.arc_count(); ++arc) {
+            changed = changed || before.base_time[arc] != fg.base_time[arc];
+        }
+        CHECK(changed);
+
+        // Ориентиры построены для прежних весов: запрос решает обычный поиск.
+        SearchOptions alt;
+        alt.landmarks = &lm;
+        for (int s = 1; s <= n; s += 7) {
+            Request rq;
+            rq.start = s;
+            rq.k = 0.5;
+            rq.targets = {1, n / 2, n};
+            expect_same_routes(solve_request(fg, model, rq, alt), solve_request(rebuilt, model, rq));
+        }
+
+        // Неверный пакет отклоняется целиком.
+        const std::uint64_t version = fg.version;
+        const double first = fg.base_time[0];
+        std::vector<EdgeDelta> bad = {{fg.edge_id[0], first + 1.0, 0.0}, {g.next_id + 5, 1.0, 0.0}};
+        CHECK(!frozen_apply_deltas(fg, bad, error));
+        CHECK(!error.empty());
+        bad = {{fg.edge_id[0], first + 1.0, 0.0}, {fg.edge_id[0], -1.0, 0.0}};
+        CHECK(!frozen_apply_deltas(fg, bad, error));
+        CHECK(fg.version == version && fg.base_time[0] == first);
+
+        CHECK(frozen_update_edge(fg, fg.edge_id[0], first + 1.0, 0.0));
+        CHECK(fg.base_time[0] == first + 1.0 && fg.version > version);
+        CHECK(!frozen_update_edge(fg, -1, 1.0, 0.0));
+    }
+
+    {
+        // Формат файла изменений.
+        std::istringstream in("2\n3 1.5 0.25\n0 +2 1\n");
+        std::vector<EdgeDelta> deltas;
+        std::string error;
+        CHECK(parse_deltas(in, deltas, error));
+        CHECK(deltas.size() == 2);
+        CHECK(deltas[0].id == 3 && deltas[0].base_time == 1.5 && deltas[0].load == 0.25);
+        CHECK(deltas[1].id == 0 && deltas[1].base_time == 2.0 && deltas[1].load == 1.0);
+
+        std::istringstream broken("2\n3 1.5 0.25\n0 x 1\n");
+        ParseLocation where;
+        CHECK(!parse_deltas(broken, deltas, error, &where));
+        CHECK(error == "parse: cannot read a delta line: id base_time load");
+        CHECK(where.line == 3 && where.column == 3);
+    }
+
+    return 0;
+}
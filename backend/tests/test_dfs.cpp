@@ -1,6 +1,6 @@
 #include "algorithms.hpp"
+#include "test_support.hpp"
 #include <iostream>
-#include <cassert>
 #include <vector>
 
 int main() {
@@ -27,19 +27,60 @@ int main() {
     graph_add_undirected(g, 4, 5, MODE_BUS, 1.0, 0.0);
 
     const auto metro = get_connected_components(g, TransportType::Metro);
-    assert(metro.size() == 3);
-    assert((metro[0] == std::vector<int>{1, 2, 3}));
-    assert((metro[1] == std::vector<int>{4, 5}));
-    assert((metro[2] == std::vector<int>{6}));
+    CHECK(metro.size() == 3);
+    CHECK((metro[0] == std::vector<int>{1, 2, 3}));
+    CHECK((metro[1] == std::vector<int>{4, 5}));
+    CHECK((metro[2] == std::vector<int>{6}));
 
     const auto rail = get_connected_components(g, TransportType::Rail);
-    assert(rail.size() == 1);
-    assert(rail[0].size() == 6);
-    assert(rail[0].front() == 1);
-    assert(rail[0].back() == 6);
+    CHECK(rail.size() == 1);
+    CHECK(rail[0].size() == 6);
+    CHECK(rail[0].front() == 1);
+    CHECK(rail[0].back() == 6);
 
     const auto bus_isolated = get_isolated_zones(g, TransportType::Bus);
-    assert((bus_isolated == std::vector<int>{6}));
+    CHECK((bus_isolated == std::vector<int>{6}));
+
+    {
+        // Коридор из 300000 станций: рекурсивный DFS переполнил бы стек.
+        const int n = 300000;
+        Graph corridor;
+        graph_init(corridor, n);
+        for (int v = 1; v < n; ++v) {
+            graph_add_undirected(corridor, v, v + 1, MODE_RAIL, 1.0, 0.0);
+        }
+        const FrozenGraph fc = freeze_graph(corridor);
+        const auto sequential = get_connected_components(fc, TransportType::Rail);
+        CHECK(sequential.size() == 1);
+        CHECK(static_cast<int>(sequential[0].size()) == n);
+        CHECK(get_connected_components(fc, TransportType::Rail, 4) == sequential);
+        CHECK(get_connected_components(fc, TransportType::Metro, 4).size() == static_cast<std::size_t>(n));
+    }
+
+    {
+        // Случайная разреженная сеть: параллельный union-find дает те же
+        // компоненты в том же порядке, что DFS, для каждого вида.
+        const int n = 20000;
+        Graph random;
+        graph_init(random, n);
+        unsigned seed = 3u;
+        auto next = [&seed](unsigned mod) {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 8) % mod;
+        };
+        for (int i = 0; i < 24000; ++i) {
+            const int u = 1 + static_cast<int>(next(n));
+            const int v = 1 + static_cast<int>(next(n));
+            graph_add_undirected(random, u, v, static_cast<int>(next(3)), 1.0, 0.0);
+        }
+        const FrozenGraph fr = freeze_graph(random);
+        for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+            const auto sequential = get_connected_components(fr, t);
+            CHECK(get_connected_components(fr, t, 2) == sequential);
+            CHECK(get_connected_components(fr, t, 8) == sequential);
+            CHECK(component_labels(fr, t, 4) == component_labels(fr, t));
+        }
+    }
 
     return 0;
 }
@@ -1,6 +1,6 @@
 #include "algorithms.hpp"
+#include "test_support.hpp"
 
-#include <cassert>
 #include <cmath>
 #include <iostream>
 #include <vector>
@@ -14,9 +14,9 @@ ModelParams make_model(int n) {
 }
 
 void expect_step(const Step& step, int from, int to, int mode) {
-    assert(step.from == from);
-    assert(step.to == to);
-    assert(step.mode == mode);
+    CHECK(step.from == from);
+    CHECK(step.to == to);
+    CHECK(step.mode == mode);
 }
 
 } // namespace
@@ -32,11 +32,11 @@ int main() {
         const DijkstraStateResult dj = dijkstra_states(g, model, 1);
         const Route route = build_route_to_target(dj, model, 1, 1, 2.0);
 
-        assert(route.reachable);
-        assert(route.time == 0.0);
-        assert(route.transfers == 0);
-        assert(route.metric == 0.0);
-        assert(route.steps.empty());
+        CHECK(route.reachable);
+        CHECK(route.time == 0.0);
+        CHECK(route.transfers == 0);
+        CHECK(route.metric == 0.0);
+        CHECK(route.steps.empty());
     }
 
     {
@@ -50,11 +50,11 @@ int main() {
         const DijkstraStateResult dj = dijkstra_states(g, model, 1);
         const Route route = build_route_to_target(dj, model, 1, 3, 2.0);
 
-        assert(route.reachable);
-        assert(route.time == 10.0);
-        assert(route.transfers == 0);
-        assert(route.metric == 10.0);
-        assert(route.steps.size() == 1);
+        CHECK(route.reachable);
+        CHECK(route.time == 10.0);
+        CHECK(route.transfers == 0);
+        CHECK(route.metric == 10.0);
+        CHECK(route.steps.size() == 1);
         expect_step(route.steps[0], 1, 3, MODE_RAIL);
     }
 
@@ -72,11 +72,11 @@ int main() {
         const DijkstraStateResult dj = dijkstra_states(g, model, 1);
         const Route route = build_route_to_target(dj, model, 1, 3, 5.0);
 
-        assert(route.reachable);
-        assert(route.time == 8.0);
-        assert(route.transfers == 1);
-        assert(route.metric == 13.0);
-        assert(route.steps.size() == 2);
+        CHECK(route.reachable);
+        CHECK(route.time == 8.0);
+        CHECK(route.transfers == 1);
+        CHECK(route.metric == 13.0);
+        CHECK(route.steps.size() == 2);
         expect_step(route.steps[0], 1, 2, MODE_METRO);
         expect_step(route.steps[1], 2, 3, MODE_BUS);
     }
@@ -90,9 +90,9 @@ int main() {
         const DijkstraStateResult dj = dijkstra_states(g, model, 1);
         const Route route = build_route_to_target(dj, model, 1, 3, 1.0);
 
-        assert(!route.reachable);
-        assert(!std::isfinite(route.time));
-        assert(route.steps.empty());
+        CHECK(!route.reachable);
+        CHECK(!std::isfinite(route.time));
+        CHECK(route.steps.empty());
     }
 
     {
@@ -106,13 +106,298 @@ int main() {
         const DijkstraStateResult dj = dijkstra_states(g, model, 1);
         const Route route = build_route_to_target(dj, model, 1, 2, 0.0);
 
-        assert(route.reachable);
-        assert(route.time == 15.0);
-        assert(route.transfers == 0);
-        assert(route.metric == 15.0);
-        assert(route.steps.size() == 1);
+        CHECK(route.reachable);
+        CHECK(route.time == 15.0);
+        CHECK(route.transfers == 0);
+        CHECK(route.metric == 15.0);
+        CHECK(route.steps.size() == 1);
         expect_step(route.steps[0], 1, 2, MODE_METRO);
     }
 
+    {
+        // Поиск, ограниченный целями, должен давать те же маршруты, что и полный проход.
+        const int n = 60;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(7u);
+        for (int i = 0; i < 150; ++i) {
+            const int u = 1 + static_cast<int>(next(n));
+            const int v = 1 + static_cast<int>(next(n));
+            graph_add_undirected(g, u, v, static_cast<int>(next(3)), static_cast<double>(next(10)), 0.25 * next(5));
+        }
+
+        ModelParams model = make_model(n);
+        model.sensitivity = {0.5, 1.0, 0.25};
+        model.trans = {{{0.0, 2.0, 1.0}, {2.0, 0.0, 3.0}, {1.0, 3.0, 0.0}}};
+        for (int v = 1; v <= n; ++v) {
+            model.station_transfer[v] = 0.5 * next(3);
+        }
+
+        for (int start = 1; start <= n; start += 7) {
+            Request rq;
+            rq.start = start;
+            rq.k = 1.5;
+            rq.targets = {1 + static_cast<int>(next(n)), 1 + static_cast<int>(next(n)), start};
+
+            const DijkstraStateResult dj = dijkstra_states(g, model, start);
+            const std::vector<Route> routes = solve_request(g, model, rq);
+            CHECK(routes.size() == rq.targets.size());
+            for (const Route& route : routes) {
+                const Route full = build_route_to_target(dj, model, start, route.target, rq.k);
+                CHECK(route.reachable == full.reachable);
+                CHECK(route.transfers == full.transfers);
+                CHECK(route.steps.size() == full.steps.size());
+                if (route.reachable) {
+                    CHECK(route.time == full.time);
+                    CHECK(route.metric == full.metric);
+                }
+            }
+
+            // Radix-куча с точным временем — те же значения, что и двоичная куча.
+            SearchOptions radix;
+            radix.queue = QueueKind::Radix;
+            const FrozenGraph fg = freeze_graph(g);
+            const std::vector<Route> radix_routes = solve_request(fg, model, rq, radix);
+            CHECK(radix_routes.size() == routes.size());
+            for (std::size_t i = 0; i < routes.size(); ++i) {
+                CHECK(radix_routes[i].target == routes[i].target);
+                CHECK(radix_routes[i].reachable == routes[i].reachable);
+                if (routes[i].reachable) {
+                    CHECK(radix_routes[i].time == routes[i].time);
+                    CHECK(radix_routes[i].transfers == routes[i].transfers);
+                }
+            }
+
+            // Фиксированная точка: ошибка не больше resolution / 2 на шаг каждого из двух путей.
+            for (QueueKind queue : {QueueKind::BinaryHeap, QueueKind::Radix}) {
+                SearchOptions fixed;
+                fixed.queue = queue;
+                fixed.time_resolution = 0.05;
+                for (const Route& route : solve_request(fg, model, rq, fixed)) {
+                    const Route full = build_route_to_target(dj, model, start, route.target, rq.k);
+                    CHECK(route.reachable == full.reachable);
+                    if (route.reachable) {
+                        CHECK(route.time >= full.time - 1e-9);
+                        const double steps = static_cast<double>(route.steps.size() + full.steps.size());
+                        CHECK(route.time <= full.time + 0.5 * fixed.time_resolution * steps + 1e-9);
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // Двунаправленный поиск (одна цель) против полного прохода; часть
+        // вершин изолирована, веса двоично-рациональные (сложение точное).
+        const int n = 70;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(29u);
+        for (int i = 0; i < 120; ++i) {
+            const int u = 1 + static_cast<int>(next(n - 5));
+            const int v = 1 + static_cast<int>(next(n - 5));
+            graph_add_undirected(g, u, v, static_cast<int>(next(3)), static_cast<double>(next(6)), 0.5 * next(3));
+        }
+
+        ModelParams model = make_model(n);
+        model.sensitivity = {0.5, 0.25, 1.0};
+        model.trans = {{{0.0, 1.5, 0.0}, {2.0, 0.0, 0.5}, {1.0, 3.0, 0.0}}};
+        for (int v = 1; v <= n; ++v) {
+            model.station_transfer[v] = 0.25 * next(4);
+        }
+        const FrozenGraph fg = freeze_graph(g);
+
+        for (int start = 1; start <= n; start += 5) {
+            const DijkstraStateResult dj = dijkstra_states(fg, model, start);
+            for (int target = 1; target <= n; target += 3) {
+                const Route full = build_route_to_target(dj, model, start, target, 2.0);
+                const Route route = bidirectional_route(fg, model, start, target, 2.0);
+                CHECK(route.reachable == full.reachable);
+                if (!route.reachable) {
+                    continue;
+                }
+                CHECK(route.time == full.time);
+                CHECK(route.transfers == full.transfers);
+                CHECK(route.metric == full.metric);
+                int at = start;
+                for (const Step& step : route.steps) {
+                    CHECK(step.from == at);
+                    at = step.to;
+                }
+                CHECK(at == target);
+            }
+        }
+    }
+
+    {
+        // Почти равные суммы: 0.1 + 0.2 > 0.3 в double. Дейкстра выбирает
+        // 1-[metro]->4 4-[bus]->3 с пересадкой; двунаправленный поиск и
+        // ответ по умолчанию не должны считать пути равными.
+        Graph g;
+        graph_init(g, 4);
+        graph_add_undirected(g, 1, 2, MODE_METRO, 0.1, 0.0);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 0.2, 0.0);
+        graph_add_undirected(g, 1, 4, MODE_METRO, 0.0, 0.0);
+        graph_add_undirected(g, 4, 3, MODE_BUS, 0.3, 0.0);
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams model = make_model(4);
+
+        Request rq;
+        rq.start = 1;
+        rq.k = 5.0;
+        rq.targets = {3};
+        const std::vector<Route> routes = solve_request(fg, model, rq);
+        CHECK(routes.size() == 1 && routes[0].transfers == 1 && routes[0].time == 0.3);
+        CHECK(routes[0].steps.size() == 2 && routes[0].steps[0].to == 4);
+
+        const Route bi = bidirectional_route(fg, model, 1, 3, 5.0);
+        CHECK(bi.time == 0.3 && bi.transfers == 1 && bi.steps.size() == 2 && bi.steps[0].to == 4);
+    }
+
+    {
+        // Рабочая область: поиски подряд в одной области дают то же, что
+        // dijkstra_states с нуля; ограниченный поиск касается только
+        // исследованной области, а не всей сети.
+        const int n = 80;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(41u);
+        for (int i = 0; i < 100; ++i) {
+            const int u = 1 + static_cast<int>(next(40));
+            const int v = 1 + static_cast<int>(next(40));
+            graph_add_undirected(g, u, v, static_cast<int>(next(3)), 1.0 + next(4), 0.5 * next(3));
+        }
+        for (int v = 41; v < n; ++v) {
+            graph_add_undirected(g, v, v + 1, MODE_RAIL, 1.0, 0.0); // отдельная цепь
+        }
+        const ModelParams model = make_model(n);
+        const FrozenGraph fg = freeze_graph(g);
+
+        SearchWorkspace ws;
+        for (int start = 1; start <= n; start += 3) {
+            dijkstra_states(fg, model, start, ws);
+            const DijkstraStateResult dj = dijkstra_states(fg, model, start);
+            CHECK(ws.start() == start);
+            for (int target = 1; target <= n; ++target) {
+                for (int m = 0; m < 3; ++m) {
+                    CHECK(ws.time(target, m) == dj.time(target, m));
+                    CHECK(ws.transfers(target, m) == dj.transfers(target, m));
+                    CHECK(ws.parent_v(target, m) == dj.parent_v(target, m));
+                }
+                const Route a = build_route_to_target(ws, target, 1.0);
+                const Route b = build_route_to_target(dj, model, start, target, 1.0);
+                CHECK(a.reachable == b.reachable && a.time == b.time && a.steps.size() == b.steps.size());
+            }
+        }
+
+        Request rq;
+        rq.start = 78;
+        rq.k = 1.0;
+        rq.targets = {80, 76};
+        SearchOptions options;
+        options.bidirectional = false;
+        const std::vector<Route> routes = solve_request(fg, model, rq, options, ws);
+        CHECK(routes.size() == 2 && routes[0].time == 2.0 && routes[1].time == 2.0);
+        CHECK(ws.explored() < 10); // 75..80, а не вся сеть
+        CHECK(!ws.reached(1));
+    }
+
+    {
+        // Модели пересадок: разбор и совпадение ответов с общим поиском.
+        const int n = 60;
+        ModelParams model = make_model(n);
+        CHECK(classify_transfer_model(model) == TransferModel::Plain);
+        for (auto& row : model.trans) {
+            row = {1.5, 1.5, 1.5};
+        }
+        model.trans[2][2] = 7.0; // диагональ не используется
+        model.station_transfer.assign(static_cast<std::size_t>(n) + 1, 0.5);
+        model.station_transfer[0] = 3.0; // станции с 1
+        CHECK(classify_transfer_model(model) == TransferModel::Uniform);
+        model.station_transfer[n] = 0.25;
+        CHECK(classify_transfer_model(model) == TransferModel::Matrix);
+        model.station_transfer[n] = 0.5;
+        model.trans[0][2] = 1.0;
+        CHECK(classify_transfer_model(model) == TransferModel::Matrix);
+
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(17u);
+        for (int i = 0; i < 200; ++i) {
+            graph_add_undirected(g, 1 + static_cast<int>(next(n)), 1 + static_cast<int>(next(n)),
+                                 static_cast<int>(next(3)), 1.0 + next(4), 0.25 * next(4));
+        }
+        const FrozenGraph fg = freeze_graph(g);
+
+        ModelParams plain = make_model(n);
+        plain.sensitivity = {1.0, 0.5, 2.0};
+        ModelParams uniform = plain;
+        for (auto& row : uniform.trans) {
+            row = {0.0, 1.5, 1.5};
+        }
+        uniform.trans[1] = {1.5, 0.0, 1.5};
+        uniform.trans[2] = {1.5, 1.5, 0.0};
+        uniform.station_transfer.assign(static_cast<std::size_t>(n) + 1, 0.5);
+        CHECK(classify_transfer_model(plain) == TransferModel::Plain);
+        CHECK(classify_transfer_model(uniform) == TransferModel::Uniform);
+
+        SearchOptions general;
+        general.bidirectional = false;
+        SearchOptions radix = general;
+        radix.queue = QueueKind::Radix;
+        SearchOptions fixed = general;
+        fixed.time_resolution = 0.25;
+        for (const ModelParams* m : {&plain, &uniform}) {
+            for (int start = 1; start <= n; start += 5) {
+                Request rq;
+                rq.start = start;
+                rq.k = 2.0;
+                rq.targets = {1, 7, 19, 33, 52, start};
+                for (SearchOptions options : {general, radix, fixed}) {
+                    const std::vector<Route> a = solve_request(fg, *m, rq, options);
+                    options.transfer_model = classify_transfer_model(*m);
+                    const std::vector<Route> b = solve_request(fg, *m, rq, options);
+                    CHECK(a.size() == b.size());
+                    for (std::size_t i = 0; i < a.size(); ++i) {
+                        CHECK(a[i].target == b[i].target && a[i].reachable == b[i].reachable);
+                        CHECK(a[i].time == b[i].time && a[i].transfers == b[i].transfers);
+                        CHECK(a[i].metric == b[i].metric);
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // Почти равные суммы: веса 0.1, 0.2, 0.3 и 0.7 без нагрузки, так что
+        // 0.1 + 0.2 и 0.3 различаются в последнем разряде. Ядро без штрафов
+        // дает те же маршруты, шаг в шаг, что общее ядро с матрицей.
+        const int n = 40;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(53u);
+        const double base[] = {0.1, 0.2, 0.3, 0.7};
+        for (int i = 0; i < 160; ++i) {
+            graph_add_undirected(g, 1 + static_cast<int>(next(n)), 1 + static_cast<int>(next(n)),
+                                 static_cast<int>(next(3)), base[next(4)], 0.0);
+        }
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams plain = make_model(n);
+        CHECK(classify_transfer_model(plain) == TransferModel::Plain);
+
+        SearchOptions general;
+        SearchOptions special;
+        special.transfer_model = TransferModel::Plain;
+        for (int start = 1; start <= n; ++start) {
+            Request rq;
+            rq.start = start;
+            rq.k = 0.5;
+            for (int t = 1; t <= n; ++t) {
+                rq.targets.push_back(t);
+            }
+            expect_same_routes(solve_request(fg, plain, rq, special), solve_request(fg, plain, rq, general));
+        }
+    }
+
     return 0;
 }
\ No newline at end of file
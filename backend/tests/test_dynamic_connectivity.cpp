@@ -0,0 +1,93 @@
+#include "dynamic_connectivity.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// Зоны динамической сети совпадают с пересчетом по CSR-снимку.
+void expect_same_zones(const DynamicGraph& dg) {
+    const FrozenGraph fg = freeze_graph(dg.g);
+    for (TransportType t : {TransportType::Metro, TransportType::Bus, TransportType::Rail, TransportType::All}) {
+        CHECK(dynamic_connected_components(dg, t) == get_connected_components(fg, t));
+        CHECK(dynamic_isolated_zones(dg, t) == get_isolated_zones(fg, t));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Закрытие перегона цикла не меняет зон, закрытие моста — меняет;
+        // повторное открытие возвращает исходное разбиение.
+        Graph g;
+        graph_init(g, 6);
+        graph_add_undirected(g, 1, 2, MODE_METRO, 1.0, 0.0); // id 0
+        graph_add_undirected(g, 2, 3, MODE_METRO, 1.0, 0.0); // id 1
+        graph_add_undirected(g, 3, 1, MODE_METRO, 1.0, 0.0); // id 2
+        graph_add_undirected(g, 3, 4, MODE_METRO, 1.0, 0.0); // id 3, мост
+        graph_add_undirected(g, 4, 5, MODE_BUS, 1.0, 0.0);   // id 4
+
+        DynamicGraph dg;
+        dynamic_graph_init(dg, g);
+        CHECK(dg.zones[MODE_METRO].component_count() == 3);
+        CHECK((dynamic_isolated_zones(dg, TransportType::Metro) == std::vector<int>{5, 6}));
+
+        CHECK(dynamic_graph_remove(dg, 0));
+        CHECK(dg.zones[MODE_METRO].connected(1, 4));
+        CHECK(dynamic_graph_remove(dg, 3));
+        CHECK(!dg.zones[MODE_METRO].connected(1, 4));
+        CHECK(dg.zones[MODE_METRO].component_size(1) == 3);
+        CHECK((dynamic_isolated_zones(dg, TransportType::Metro) == std::vector<int>{4, 5, 6}));
+        CHECK(!dynamic_graph_remove(dg, 3));
+        expect_same_zones(dg);
+
+        const int id = dynamic_graph_add(dg, 4, 2, MODE_METRO, 2.0, 0.5);
+        CHECK(id == 5);
+        CHECK(dg.g.m == 4);
+        CHECK((dynamic_isolated_zones(dg, TransportType::Metro) == std::vector<int>{5, 6}));
+        expect_same_zones(dg);
+    }
+
+    {
+        // Случайная серия закрытий и открытий (с параллельными рёбрами и
+        // петлями) сверяется с пересчетом после каждого шага.
+        const int n = 60;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(5u);
+        for (int i = 0; i < 90; ++i) {
+            graph_add_undirected(g, 1 + static_cast<int>(next(n)), 1 + static_cast<int>(next(n)),
+                                 static_cast<int>(next(3)), 1.0, 0.0);
+        }
+
+        DynamicGraph dg;
+        dynamic_graph_init(dg, g);
+        expect_same_zones(dg);
+
+        std::vector<int> open;
+        for (int id = 0; id < g.next_id; ++id) {
+            open.push_back(id);
+        }
+        for (int step = 0; step < 600; ++step) {
+            if (!open.empty() && next(2) == 0) {
+                const std::size_t i = next(static_cast<unsigned>(open.size()));
+                CHECK(dynamic_graph_remove(dg, open[i]));
+                open[i] = open.back();
+                open.pop_back();
+            } else {
+                open.push_back(dynamic_graph_add(dg, 1 + static_cast<int>(next(n)), 1 + static_cast<int>(next(n)),
+                                                 static_cast<int>(next(3)), 1.0, 0.0));
+            }
+            if (step % 7 == 0) {
+                expect_same_zones(dg);
+            }
+        }
+        expect_same_zones(dg);
+    }
+
+    return 0;
+}
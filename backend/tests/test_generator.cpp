@@ -0,0 +1,109 @@
+#include "algorithms.hpp"
+#include "generator.hpp"
+#include "parser.hpp"
+#include "test_support.hpp"
+#include "validator.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string text_of(const GeneratedNetwork& net) {
+    std::ostringstream out;
+    write_network_text(out, net);
+    return out.str();
+}
+
+} // namespace
+
+int main() {
+    GeneratorParams params;
+    params.seed = 42;
+    params.stations = 2500;
+    params.queries = 200;
+    params.matrices = 2;
+    params.pockets = 3;
+    params.pocket_size = 4;
+
+    const GeneratedNetwork net = generate_network(params);
+    CHECK(net.n == 2500);
+    CHECK(net.requests.size() == 200);
+
+    // Все три вида транспорта.
+    int per_mode[3] = {0, 0, 0};
+    for (const GeneratedEdge& e : net.edges) {
+        ++per_mode[e.mode];
+    }
+    CHECK(per_mode[0] > 0 && per_mode[1] > 0 && per_mode[2] > 0);
+    CHECK(per_mode[1] > per_mode[0] && per_mode[1] > per_mode[2]);
+
+    // Текст читается parse_all, проходит проверку и дает ту же сеть.
+    const std::string text = text_of(net);
+    std::istringstream in(text);
+    InputData data;
+    std::string error;
+    CHECK(parse_all(in, data, error));
+    CHECK(validate_all(data, error));
+    CHECK(data.g.n == net.n);
+    CHECK(data.g.m == static_cast<int>(net.edges.size()));
+    CHECK(data.requests.size() == net.requests.size());
+    CHECK(data.matrices.size() == 2);
+    for (std::size_t i = 0; i < net.edges.size(); ++i) {
+        const GeneratedEdge& e = net.edges[i];
+        const EdgeSlot& slot = data.g.slots[i];
+        const Edge& read = data.g.adj[static_cast<std::size_t>(slot.u)][static_cast<std::size_t>(slot.iu)];
+        CHECK(slot.u == e.u && slot.v == e.v && read.mode == e.mode);
+        CHECK(read.base_time == e.base_time && read.load == e.load);
+    }
+    for (std::size_t i = 0; i < net.requests.size(); ++i) {
+        CHECK(data.requests[i].start == net.requests[i].start);
+        CHECK(data.requests[i].k == net.requests[i].k);
+        CHECK(data.requests[i].targets == net.requests[i].targets);
+    }
+
+    // Детерминизм: тот же seed — тот же текст, другой seed — другой.
+    CHECK(text_of(generate_network(params)) == text);
+    GeneratorParams other = params;
+    other.seed = 43;
+    CHECK(text_of(generate_network(other)) != text);
+
+    // Карманы отделены от города: каждый — своя компонента по всем видам.
+    const FrozenGraph fg = freeze_graph(generated_graph(net));
+    const std::vector<int> labels = component_labels(fg, TransportType::All);
+    const int grid = net.n - params.pockets * params.pocket_size;
+    for (int k = 0; k < params.pockets; ++k) {
+        const int first = grid + k * params.pocket_size + 1;
+        for (int v = first; v < first + params.pocket_size; ++v) {
+            CHECK(labels[static_cast<std::size_t>(v)] == labels[static_cast<std::size_t>(first)]);
+            CHECK(labels[static_cast<std::size_t>(v)] != labels[1]);
+        }
+    }
+
+    // Запросы в карман не имеют маршрута.
+    bool pocket_query = false;
+    for (const Request& rq : net.requests) {
+        if (rq.targets[0] > grid) {
+            pocket_query = true;
+            for (const Route& route : solve_request(fg, net.model, rq)) {
+                CHECK(route.target <= grid || !route.reachable);
+            }
+        }
+    }
+    CHECK(pocket_query);
+
+    // Недопустимые параметры.
+    GeneratorParams bad = params;
+    bad.stations = 10;
+    bool thrown = false;
+    try {
+        generate_network(bad);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "landmarks.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+ModelParams make_model(int n) {
+    ModelParams model{};
+    model.station_transfer.assign(static_cast<std::size_t>(n) + 1, 0.0);
+    return model;
+}
+
+// Кратчайшее время до t по полному проходу Дейкстры (лучший из трех видов).
+double best_time(const DijkstraStateResult& dj, int t) {
+    double best = dj.time(t, 0);
+    for (int m = 1; m < 3; ++m) {
+        best = std::fmin(best, dj.time(t, m));
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Две компоненты и станция без рёбер: каждой компоненте — свой
+        // ориентир, между компонентами оценка бесконечна.
+        Graph g;
+        graph_init(g, 6);
+        graph_add_undirected(g, 1, 2, MODE_BUS, 2.0, 0.5);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 3.0, 0.0);
+        graph_add_undirected(g, 4, 5, MODE_RAIL, 1.0, 1.0);
+
+        const FrozenGraph fg = freeze_graph(g);
+        const Landmarks lm = build_landmarks(fg, 3);
+        CHECK(lm.nodes.size() == 3);
+        CHECK(lm.nodes[0] == 4); // недостижима из станции 1
+        CHECK(lm.nodes[1] == 3);
+        CHECK(lm.nodes[2] == 2);
+
+        CHECK(landmark_bound(lm, 1, 3) > 4.99 && landmark_bound(lm, 1, 3) <= 5.0);
+        CHECK(landmark_bound(lm, 1, 1) == 0.0);
+        CHECK(std::isinf(landmark_bound(lm, 1, 4)));
+        CHECK(std::isinf(landmark_bound(lm, 6, 2)));
+
+        ModelParams model = make_model(6);
+        Request rq;
+        rq.start = 1;
+        rq.k = 1.0;
+        rq.targets = {4, 3, 1, 6};
+        const std::vector<Route> routes = solve_request_alt(lm, fg, model, rq);
+        CHECK(routes.size() == 4);
+        CHECK(routes[0].target == 1 && routes[0].reachable);
+        CHECK(routes[1].target == 3 && routes[1].reachable);
+        CHECK(routes[1].time == 5.0 && routes[1].transfers == 1);
+        CHECK(!routes[2].reachable && !routes[3].reachable);
+    }
+
+    {
+        // Случайные сети с двоично-рациональными весами (сложение точное):
+        // оценка не превышает расстояния при любой модели, а A* дает те же
+        // значения, что полный проход Дейкстры, и не больше извлечений,
+        // чем поиск без ориентиров.
+        const int n = 90;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(7u);
+        for (int i = 0; i < 220; ++i) {
+            const int u = 1 + static_cast<int>(next(n));
+            const int v = 1 + static_cast<int>(next(n));
+            graph_add_undirected(g, u, v, static_cast<int>(next(3)), 1.0 + static_cast<double>(next(8)), 0.25 * next(5));
+        }
+
+        ModelParams model = make_model(n);
+        model.sensitivity = {0.5, 1.0, 0.25};
+        model.trans = {{{0.0, 2.0, 0.5}, {1.5, 0.0, 3.0}, {0.0, 2.5, 0.0}}};
+        for (int v = 1; v <= n; ++v) {
+            model.station_transfer[v] = 0.5 * next(3);
+        }
+
+        const FrozenGraph fg = freeze_graph(g);
+        const Landmarks lm = build_landmarks(fg, 6);
+        const Landmarks none = build_landmarks(fg, 0);
+        CHECK(lm.nodes.size() == 6);
+        CHECK(none.nodes.empty());
+
+        SearchOptions options;
+        options.landmarks = &lm;
+
+        std::size_t settled_alt = 0;
+        std::size_t settled_plain = 0;
+        for (int start = 1; start <= n; start += 2) {
+            const DijkstraStateResult dj = dijkstra_states(fg, model, start);
+            for (int t = 1; t <= n; ++t) {
+                const double d = best_time(dj, t);
+                const double h = landmark_bound(lm, start, t);
+                CHECK(std::isinf(d) ? std::isinf(h) : h <= d);
+            }
+
+            Request rq;
+            rq.start = start;
+            rq.k = 2.0;
+            rq.targets = {1 + static_cast<int>(next(n))};
+            if (start % 3 == 0) {
+                rq.targets.push_back(1 + static_cast<int>(next(n)));
+                rq.targets.push_back(start);
+            }
+
+            const std::vector<Route> routes = solve_request(fg, model, rq, options);
+            solve_request_alt(lm, fg, model, rq, &settled_alt);
+            solve_request_alt(none, fg, model, rq, &settled_plain);
+            CHECK(routes.size() == rq.targets.size());
+            for (const Route& route : routes) {
+                const Route full = build_route_to_target(dj, model, start, route.target, rq.k);
+                CHECK(route.reachable == full.reachable);
+                if (route.reachable) {
+                    CHECK(route.time == full.time);
+                    CHECK(route.transfers == full.transfers);
+                    CHECK(route.metric == full.metric);
+                    if (!route.steps.empty()) {
+                        CHECK(route.steps.front().from == start);
+                        CHECK(route.steps.back().to == route.target);
+                    }
+                }
+            }
+        }
+        CHECK(settled_alt <= settled_plain);
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "contraction.hpp"
+#include "matrix.hpp"
+#include "parser.hpp"
+#include "test_support.hpp"
+#include "validator.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Ячейки совпадают с лучшими состояниями полного прохода Дейкстры; exact —
+// время бит в бит (без иерархии).
+void check_matrix(const FrozenGraph& fg, const ModelParams& model, const TravelMatrix& m, bool exact) {
+    CHECK(m.time.size() == m.sources.size() * m.targets.size());
+    CHECK(m.transfers.size() == m.time.size());
+    for (std::size_t i = 0; i < m.sources.size(); ++i) {
+        const DijkstraStateResult dj = dijkstra_states(fg, model, m.sources[i]);
+        for (std::size_t j = 0; j < m.targets.size(); ++j) {
+            const Route r = build_route_to_target(dj, m.targets[j], 0.0);
+            const std::size_t c = m.index(i, j);
+            if (!r.reachable) {
+                CHECK(std::isinf(m.time[c]) && m.transfers[c] == -1);
+                continue;
+            }
+            CHECK(m.transfers[c] == r.transfers);
+            CHECK(exact ? m.time[c] == r.time : close(m.time[c], r.time));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Разбор блока матриц: необязателен и начинается словом matrix,
+        // станции проверяет валидатор.
+        const std::string net = "3 2\n1 1 1\n0 0 0\n0 0 0\n0 0 0\n0 0 0\n1 2 0 1 0\n2 3 1 1 0\n";
+        InputData data;
+        std::string error;
+        std::istringstream plain(net + "1\n1 1 0 3\n");
+        CHECK(parse_all(plain, data, error) && data.matrices.empty());
+
+        // Текст после запросов без слова matrix не читается.
+        std::istringstream trailing(net + "1\n1 1 0 3\n2\n# конец\n");
+        CHECK(parse_all(trailing, data, error) && data.requests.size() == 1 && data.matrices.empty());
+
+        std::istringstream with(net + "0\nmatrix 2\n2 1 3 1 2\n0 0\n");
+        CHECK(parse_all(with, data, error));
+        CHECK(data.requests.empty() && data.matrices.size() == 2);
+        CHECK((data.matrices[0].sources == std::vector<int>{1, 3}));
+        CHECK((data.matrices[0].targets == std::vector<int>{2}));
+        CHECK(data.matrices[1].sources.empty() && data.matrices[1].targets.empty());
+        CHECK(validate_all(data, error));
+
+        std::istringstream bad_station(net + "0\nmatrix 1\n1 4 1 1\n");
+        CHECK(parse_all(bad_station, data, error) && !validate_all(data, error));
+        CHECK(error == "validate_matrix_requests: matrix has invalid source station");
+
+        std::istringstream truncated(net + "0\nmatrix 1\n2 1\n");
+        ParseLocation where;
+        CHECK(!parse_all(truncated, data, error, &where));
+        CHECK(error == "parse: cannot read station in matrix request");
+        std::istringstream negative(net + "0\nmatrix -1\n");
+        CHECK(!parse_all(negative, data, error) && error == "parse: invalid P");
+    }
+
+    {
+        // Случайная сеть с изолированными станциями: Дейкстра и корзины по
+        // иерархии дают те же ячейки, что полные проходы.
+        const int n = 60;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(41u);
+        add_random_edges(g, next, n - 3, 150);
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams model = random_model(n);
+
+        std::vector<int> sources;
+        std::vector<int> targets;
+        for (int v = 1; v <= n; v += 3) {
+            sources.push_back(v);
+        }
+        for (int v = 2; v <= n; v += 2) {
+            targets.push_back(v);
+        }
+        targets.push_back(sources[4]); // источник среди целей: 0 и 0
+
+        const TravelMatrix plain = travel_time_matrix(fg, model, sources, targets);
+        check_matrix(fg, model, plain, true);
+        CHECK(plain.time[plain.index(4, targets.size() - 1)] == 0.0);
+        CHECK(plain.transfers[plain.index(4, targets.size() - 1)] == 0);
+
+        const TravelMatrix threaded = travel_time_matrix(fg, model, sources, targets, SearchOptions{}, 4);
+        CHECK(threaded.time == plain.time && threaded.transfers == plain.transfers);
+
+        const ContractionHierarchy ch = build_contraction_hierarchy(fg, model);
+        SearchOptions options;
+        options.hierarchy = &ch;
+        const TravelMatrix buckets = travel_time_matrix(fg, model, sources, targets, options, 3);
+        check_matrix(fg, model, buckets, false);
+
+        // Ячейки по иерархии бит в бит равны ответам на запросы по ней же.
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            Request rq;
+            rq.start = sources[i];
+            rq.k = 0.0;
+            rq.targets = targets;
+            for (const Route& r : solve_request_ch(ch, fg, model, rq)) {
+                std::size_t j = 0;
+                while (targets[j] != r.target) {
+                    ++j;
+                }
+                const std::size_t c = buckets.index(i, j);
+                CHECK(r.reachable ? buckets.time[c] == r.time && buckets.transfers[c] == r.transfers
+                                   : buckets.transfers[c] == -1);
+            }
+        }
+
+        // Пустые списки — пустая матрица.
+        CHECK(travel_time_matrix(fg, model, {}, targets).time.empty());
+        CHECK(travel_time_matrix(fg, model, sources, {}, options).time.empty());
+
+        // Бинарный файл: запись и чтение без потерь.
+        const std::string path = "test_matrix.bin";
+        std::string error;
+        CHECK(write_matrix_file(path, {plain, TravelMatrix{}}, error));
+        std::vector<TravelMatrix> loaded;
+        CHECK(read_matrix_file(path, loaded, error));
+        CHECK(loaded.size() == 2);
+        CHECK(loaded[0].sources == plain.sources && loaded[0].targets == plain.targets);
+        CHECK(loaded[0].time == plain.time && loaded[0].transfers == plain.transfers);
+        CHECK(loaded[1].sources.empty() && loaded[1].time.empty());
+
+        {
+            std::FILE* f = std::fopen(path.c_str(), "r+b");
+            CHECK(f != nullptr);
+            std::fputc('X', f);
+            std::fclose(f);
+        }
+        CHECK(!read_matrix_file(path, loaded, error) && error == "matrix: bad magic");
+        std::remove(path.c_str());
+    }
+
+    return 0;
+}
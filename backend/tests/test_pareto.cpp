@@ -0,0 +1,190 @@
+#include "pareto.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Эталон: Дейкстра по слоям (v, m, j) — j пересадок ровно, j <= max_j.
+// best[v][j] — наименьшее время до v ровно с j пересадками.
+std::vector<std::vector<double>> layered_times(const FrozenGraph& g, const ModelParams& model, int start, int max_j) {
+    const int layers = max_j + 1;
+    auto id = [layers](int v, int m, int j) { return (v * 4 + m) * layers + j; };
+    std::vector<double> dist(static_cast<std::size_t>((g.n + 1) * 4 * layers), kInf);
+    using Item = std::tuple<double, int, int, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+    dist[id(start, 3, 0)] = 0.0;
+    q.push({0.0, start, 3, 0});
+    while (!q.empty()) {
+        const auto [t, u, a, j] = q.top();
+        q.pop();
+        if (t > dist[id(u, a, j)]) {
+            continue;
+        }
+        for (int b = 0; b < 3; ++b) {
+            const bool change = a != 3 && a != b;
+            const int nj = j + (change ? 1 : 0);
+            if (nj > max_j) {
+                continue;
+            }
+            const double penalty = change ? model.trans[a][b] + model.station_transfer[u] : 0.0;
+            for (int arc = g.mode_begin(u, b); arc < g.mode_end(u, b); ++arc) {
+                const int v = g.to[static_cast<std::size_t>(arc)];
+                const double nt = t + (arc_time(g, arc, b, model.sensitivity) + penalty);
+                if (nt < dist[id(v, b, nj)]) {
+                    dist[id(v, b, nj)] = nt;
+                    q.push({nt, v, b, nj});
+                }
+            }
+        }
+    }
+    std::vector<std::vector<double>> best(static_cast<std::size_t>(g.n) + 1, std::vector<double>(layers, kInf));
+    for (int v = 1; v <= g.n; ++v) {
+        for (int m = 0; m < 3; ++m) {
+            for (int j = 0; j < layers; ++j) {
+                best[v][j] = std::fmin(best[v][j], dist[id(v, m, j)]);
+            }
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // 1 -> 3: автобус и метро с пересадкой (быстрее) или медленный
+        // автобус без пересадки. Дейкстра дает быстрый путь при любом k,
+        // Парето-поиск — лучший по метрике.
+        Graph g;
+        graph_init(g, 3);
+        graph_add_undirected(g, 1, 2, MODE_BUS, 1.0, 0.0);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 1.0, 0.0);
+        graph_add_undirected(g, 1, 3, MODE_BUS, 4.0, 0.0);
+        const FrozenGraph fg = freeze_graph(g);
+        ModelParams model = random_model(3);
+        model.sensitivity = {0.0, 0.0, 0.0};
+
+        Request rq;
+        rq.start = 1;
+        rq.targets = {3};
+        const std::vector<std::vector<Route>> answers = solve_request_pareto(fg, model, rq, {0.0, 1.0, 5.0});
+        CHECK(answers.size() == 3);
+        // Быстрый путь: 1 + 1 + штраф 0.5 + 0.25 = 2.75, одна пересадка.
+        CHECK(answers[0][0].time == 2.75 && answers[0][0].transfers == 1);
+        CHECK(answers[1][0].metric == 3.75 && answers[1][0].transfers == 1);
+        CHECK(answers[2][0].time == 4.0 && answers[2][0].transfers == 0);
+        CHECK(answers[2][0].metric == 4.0 && answers[2][0].steps.size() == 1);
+
+        rq.k = 5.0;
+        const Route dijkstra = solve_request(fg, model, rq)[0];
+        CHECK(dijkstra.transfers == 1 && dijkstra.metric == 7.75);
+        SearchOptions pareto;
+        pareto.pareto = true;
+        CHECK(solve_request(fg, model, rq, pareto)[0].metric == 4.0);
+
+        const ParetoResult full = pareto_search(fg, model, 1, {});
+        const std::vector<ParetoLabel> front = pareto_front(full, 3);
+        CHECK(front.size() == 2);
+        CHECK(front[0].time == 2.75 && front[0].transfers == 1);
+        CHECK(front[1].time == 4.0 && front[1].transfers == 0);
+        CHECK(pareto_front(full, 1).size() == 1);
+
+        // Без пересадок остается только медленный путь.
+        pareto.max_transfers = 0;
+        rq.k = 0.0;
+        CHECK(solve_request(fg, model, rq, pareto)[0].time == 4.0);
+    }
+
+    {
+        // Случайная сеть: фронты совпадают с Дейкстрой по слоям пересадок,
+        // ответы для списка k — с лучшей метрикой эталона; при k = 0 —
+        // значения обычного поиска.
+        const int n = 45;
+        const int max_j = 12;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(23u);
+        add_random_edges(g, next, n, 130);
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams model = random_model(n);
+        const std::vector<double> ks = {0.0, 0.5, 2.0, 10.0};
+
+        for (int start = 1; start <= n; start += 4) {
+            const std::vector<std::vector<double>> ref = layered_times(fg, model, start, max_j);
+            ParetoOptions options;
+            options.max_transfers = max_j;
+            const ParetoResult full = pareto_search(fg, model, start, {}, options);
+
+            Request rq;
+            rq.start = start;
+            for (int t = 1; t <= n; ++t) {
+                if (t != start) {
+                    rq.targets.push_back(t);
+                }
+            }
+            const std::vector<std::vector<Route>> answers = solve_request_pareto(fg, model, rq, ks, max_j);
+
+            for (int t = 1; t <= n; ++t) {
+                if (t == start) {
+                    continue;
+                }
+                // Фронт эталона: слой j, если он быстрее всех слоев меньше.
+                std::vector<std::pair<double, int>> expected;
+                for (int j = 0; j <= max_j; ++j) {
+                    if (ref[t][j] < kInf && (expected.empty() || ref[t][j] < expected.back().first)) {
+                        expected.push_back({ref[t][j], j});
+                    }
+                }
+                const std::vector<ParetoLabel> front = pareto_front(full, t);
+                CHECK(front.size() == expected.size());
+                for (std::size_t i = 0; i < front.size(); ++i) {
+                    CHECK(close(front[i].time, expected[expected.size() - 1 - i].first));
+                    CHECK(front[i].transfers == expected[expected.size() - 1 - i].second);
+                }
+
+                for (std::size_t i = 0; i < ks.size(); ++i) {
+                    double best = kInf;
+                    for (const auto& point : expected) {
+                        best = std::fmin(best, point.first + ks[i] * point.second);
+                    }
+                    const Route* route = nullptr;
+                    for (const Route& r : answers[i]) {
+                        if (r.target == t) {
+                            route = &r;
+                        }
+                    }
+                    CHECK(route != nullptr);
+                    CHECK(route->reachable == (best < kInf));
+                    if (route->reachable) {
+                        CHECK(close(route->metric, best));
+                        Route replay = *route;
+                        evaluate_route(fg, model, replay, ks[i]);
+                        CHECK(replay.transfers == route->transfers && close(replay.time, route->time));
+                    }
+                }
+            }
+
+            rq.k = 0.0;
+            const std::vector<Route> plain = solve_request(fg, model, rq);
+            CHECK(plain.size() == answers[0].size());
+            for (std::size_t i = 0; i < plain.size(); ++i) {
+                CHECK(plain[i].target == answers[0][i].target);
+                CHECK(plain[i].time == answers[0][i].time);
+                CHECK(plain[i].transfers == answers[0][i].transfers);
+            }
+        }
+    }
+
+    return 0;
+}
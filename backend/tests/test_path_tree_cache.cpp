@@ -0,0 +1,148 @@
+#include "path_tree_cache.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main() {
+    std::cout << "start\n";
+
+    const int n = 60;
+    Graph g;
+    graph_init(g, n);
+    TestRandom next(11u);
+    add_random_edges(g, next, n, 150);
+    FrozenGraph fg = freeze_graph(g);
+    const ModelParams model = random_model(n, 0.25);
+
+    {
+        // Дерево дает те же маршруты, что полный результат dijkstra_states.
+        const DijkstraStateResult dj = dijkstra_states(fg, model, 5);
+        const PathTree tree = build_path_tree(fg, model, 5);
+        for (int t = 1; t <= n; ++t) {
+            const Route a = build_route_to_target(dj, model, 5, t, 0.5);
+            const Route b = build_route_to_target(tree, t, 0.5);
+            expect_same_routes({a}, {b});
+        }
+
+        // Упакованные раскладки: один номер состояния предка; float-время
+        // и 8-битные пересадки дают те же маршруты с точностью float.
+        CompactPathTree compact;
+        CHECK(build_path_tree(fg, model, 5, compact));
+        for (int t = 1; t <= n; ++t) {
+            for (int m = 0; m < 3; ++m) {
+                const int p = tree.parent_state(t, m);
+                CHECK(p == (p == -1 ? -1 : 4 * tree.parent_v(t, m) + tree.parent_mode(t, m)));
+            }
+            const Route a = build_route_to_target(tree, t, 0.5);
+            const Route c = build_route_to_target(compact, t, 0.5);
+            CHECK(a.reachable == c.reachable);
+            CHECK(!a.reachable || std::fabs(a.time - c.time) <= 1e-5 * a.time);
+        }
+        const std::size_t rows = static_cast<std::size_t>(n) + 1;
+        CHECK(dj.memory_bytes() == 48 * rows);
+        CHECK(tree.memory_bytes() == 42 * rows);
+        CHECK(compact.memory_bytes() == 27 * rows);
+    }
+
+    {
+        // Пересадки, которые не помещаются в тип: 8 бит — уже на цепи из
+        // 300 чередующихся видов, 16 бит — на 70000; кэш тогда не хранит
+        // дерево, а запрос решается поиском.
+        const int len = 70000;
+        Graph chain;
+        graph_init(chain, len);
+        for (int v = 1; v < len; ++v) {
+            graph_add_undirected(chain, v, v + 1, v % 2 == 0 ? MODE_BUS : MODE_METRO, 1.0, 0.0);
+        }
+        const FrozenGraph cf = freeze_graph(chain);
+        const ModelParams cm = random_model(len, 0.0);
+        CompactPathTree compact;
+        PathTree tree;
+        CHECK(!build_path_tree(cf, cm, len - 300, compact));
+        CHECK(!build_path_tree(cf, cm, 1, tree));
+
+        PathTreeCache cache(1u << 30);
+        SearchOptions cached;
+        cached.tree_cache = &cache;
+        Request rq;
+        rq.start = 1;
+        rq.targets = {len, 2};
+        const std::vector<Route> routes = solve_request(cf, cm, rq, cached);
+        expect_same_routes(routes, solve_request(cf, cm, rq));
+        CHECK(routes[1].transfers == len - 2);
+        CHECK(cache.stats().entries == 0);
+    }
+
+    {
+        // Ответы по кэшу совпадают с поиском без кэша; повтор — попадание.
+        PathTreeCache cache(64u << 20);
+        SearchOptions cached;
+        cached.tree_cache = &cache;
+        cached.model_fingerprint = model_fingerprint(model);
+        for (int round = 0; round < 2; ++round) {
+            for (int s = 1; s <= n; s += 5) {
+                Request rq;
+                rq.start = s;
+                rq.k = 0.5 * round;
+                rq.targets = {1, n / 3, n / 2, n, s};
+                expect_same_routes(solve_request(fg, model, rq, cached), solve_request(fg, model, rq));
+            }
+        }
+        PathTreeCacheStats stats = cache.stats();
+        CHECK(stats.misses == 12 && stats.hits == 12);
+        CHECK(stats.entries == 12 && stats.evictions == 0 && stats.bytes > 0);
+
+        // Другая модель — другой ключ.
+        const ModelParams other = random_model(n, 1.0);
+        CHECK(model_fingerprint(other) != model_fingerprint(model));
+        cache.get(fg, other, model_fingerprint(other), 1);
+        CHECK(cache.stats().misses == 13);
+
+        // Изменение весов: деревья прежних весов удаляются, ответы — по новым.
+        std::string error;
+        CHECK(frozen_apply_deltas(fg, {{0, 50.0, 1.0}, {7, 0.5, 0.0}}, error));
+        graph_update_edge(g, 0, 50.0, 1.0);
+        graph_update_edge(g, 7, 0.5, 0.0);
+        const FrozenGraph rebuilt = freeze_graph(g);
+        for (int s = 1; s <= n; s += 5) {
+            Request rq;
+            rq.start = s;
+            rq.targets = {2, n / 2, n - 1};
+            expect_same_routes(solve_request(fg, model, rq, cached), solve_request(rebuilt, model, rq));
+        }
+        stats = cache.stats();
+        CHECK(stats.invalidations == 13);
+        CHECK(stats.entries == 12 && stats.hits == 12);
+    }
+
+    {
+        // LRU: при пределе в два дерева третье вытесняет давно не использованное.
+        const std::size_t tree_bytes = build_path_tree(fg, model, 1).memory_bytes();
+        PathTreeCache cache(2 * tree_bytes);
+        const std::uint64_t fp = model_fingerprint(model);
+        cache.get(fg, model, fp, 1);
+        cache.get(fg, model, fp, 2);
+        cache.get(fg, model, fp, 1); // 1 — недавнее
+        cache.get(fg, model, fp, 3); // вытесняет 2
+        PathTreeCacheStats stats = cache.stats();
+        CHECK(stats.hits == 1 && stats.misses == 3 && stats.evictions == 1 && stats.entries == 2);
+        CHECK(stats.bytes <= cache.limit_bytes());
+        cache.get(fg, model, fp, 1);
+        CHECK(cache.stats().hits == 2);
+        cache.get(fg, model, fp, 2);
+        CHECK(cache.stats().misses == 4);
+
+        // Дерево больше предела не кэшируется, но отдается.
+        PathTreeCache tiny(16);
+        CHECK(tiny.get(fg, model, fp, 4)->start() == 4);
+        CHECK(tiny.stats().entries == 0);
+
+        cache.clear();
+        CHECK(cache.stats().entries == 0 && cache.stats().bytes == 0);
+    }
+
+    return 0;
+}
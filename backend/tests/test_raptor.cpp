@@ -0,0 +1,134 @@
+#include "parser.hpp"
+#include "raptor.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+void check_same_front(const std::vector<ParetoLabel>& a, const std::vector<ParetoLabel>& b) {
+    CHECK(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        CHECK(close(a[i].time, b[i].time));
+        CHECK(a[i].transfers == b[i].transfers);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    {
+        // Линия метро 1-2-3-4 и автобус 1-5-4: раунд 0 — только автобус или
+        // только метро, пересадка дает быстрее.
+        Graph g;
+        graph_init(g, 5);
+        graph_add_undirected(g, 1, 2, MODE_METRO, 2.0, 0.0);
+        graph_add_undirected(g, 2, 3, MODE_METRO, 2.0, 0.0);
+        graph_add_undirected(g, 3, 4, MODE_METRO, 2.0, 0.0);
+        graph_add_undirected(g, 1, 5, MODE_BUS, 1.0, 0.0);
+        graph_add_undirected(g, 5, 3, MODE_BUS, 1.0, 0.0);
+        const FrozenGraph fg = freeze_graph(g);
+        ModelParams model = random_model(5);
+        model.sensitivity = {0.0, 0.0, 0.0};
+
+        const ParetoResult rounds = round_search(fg, model, 1, {4});
+        const std::vector<ParetoLabel> front = pareto_front(rounds, 4);
+        // Автобус до 3 (2) + пересадка 0.5 + 0.25 + метро (2) = 4.75 против метро 6.
+        CHECK(front.size() == 2);
+        CHECK(front[0].time == 4.75 && front[0].transfers == 1);
+        CHECK(front[1].time == 6.0 && front[1].transfers == 0);
+
+        const Route fast = pareto_route(rounds, 4, 0.0);
+        CHECK(fast.steps.size() == 3 && fast.steps[2].mode == MODE_METRO);
+        CHECK(pareto_route(rounds, 4, 2.0).transfers == 0);
+
+        // Предел пересадок: общий и в запросе.
+        CHECK(pareto_front(round_search(fg, model, 1, {4}, 0), 4).size() == 1);
+        Request rq;
+        rq.start = 1;
+        rq.targets = {4, 1};
+        rq.max_transfers = 0;
+        const std::vector<std::vector<Route>> answers = solve_request_rounds(fg, model, rq, {0.0});
+        CHECK(answers[0][0].target == 1 && answers[0][0].reachable && answers[0][0].steps.empty());
+        CHECK(answers[0][1].time == 6.0 && answers[0][1].transfers == 0);
+        rq.max_transfers = std::numeric_limits<int>::max();
+        CHECK(solve_request_rounds(fg, model, rq, {0.0})[0][1].time == 4.75);
+
+        SearchOptions options;
+        options.pareto = true;
+        options.rounds = true;
+        CHECK(solve_request(fg, model, rq, options)[1].time == 4.75);
+        options.max_transfers = 0;
+        CHECK(solve_request(fg, model, rq, options)[1].time == 6.0);
+
+        // Предел из запроса ("max R", переводы строк не важны): без --pareto
+        // такой запрос решает поиск по раундам, без предела — обычная Дейкстра.
+        const std::string text = "3 1 1 0 4 max 0\n1 1 0 4\n1 1 0\n4 max\n1\n";
+        TextCursor in = make_cursor(text.data(), text.size());
+        std::vector<Request> parsed;
+        std::string error;
+        CHECK(parse_requests(in, 5, parsed, error));
+        CHECK(parsed.size() == 3);
+        CHECK(parsed[0].max_transfers == 0);
+        CHECK(parsed[1].max_transfers == std::numeric_limits<int>::max());
+        CHECK(parsed[2].targets.size() == 1 && parsed[2].targets[0] == 4);
+        CHECK(parsed[2].max_transfers == 1);
+        CHECK(solve_request(fg, model, parsed[0], SearchOptions{})[0].time == 6.0);
+        CHECK(solve_request(fg, model, parsed[1], SearchOptions{})[0].time == 4.75);
+        CHECK(solve_request(fg, model, parsed[2], SearchOptions{})[0].time == 4.75);
+
+        const std::string negative = "1\n1 1 0 4 max -1\n";
+        TextCursor bad = make_cursor(negative.data(), negative.size());
+        CHECK(!parse_requests(bad, 5, parsed, error));
+    }
+
+    {
+        // Случайная сеть: фронты совпадают с методом меток — полные и при
+        // отсечении по целям, с пределом пересадок и без.
+        const int n = 50;
+        Graph g;
+        graph_init(g, n);
+        TestRandom next(31u);
+        add_random_edges(g, next, n, 140);
+        const FrozenGraph fg = freeze_graph(g);
+        const ModelParams model = random_model(n);
+
+        for (int start = 1; start <= n; start += 3) {
+            const ParetoResult labels = pareto_search(fg, model, start, {});
+            const ParetoResult rounds = round_search(fg, model, start, {});
+            ParetoOptions capped;
+            capped.max_transfers = 2;
+            const ParetoResult labels2 = pareto_search(fg, model, start, {}, capped);
+            const ParetoResult rounds2 = round_search(fg, model, start, {}, 2);
+            for (int t = 1; t <= n; ++t) {
+                check_same_front(pareto_front(labels, t), pareto_front(rounds, t));
+                check_same_front(pareto_front(labels2, t), pareto_front(rounds2, t));
+            }
+
+            const std::vector<int> targets = {1 + (start * 7) % n, 1 + (start * 13) % n, start};
+            const ParetoResult pruned = round_search(fg, model, start, targets);
+            for (int t : targets) {
+                check_same_front(pareto_front(labels, t), pareto_front(pruned, t));
+                for (double k : {0.0, 1.0, 10.0}) {
+                    const Route a = pareto_route(labels, t, k);
+                    const Route b = pareto_route(pruned, t, k);
+                    CHECK(a.reachable == b.reachable);
+                    if (a.reachable) {
+                        CHECK(close(a.metric, b.metric) && a.transfers == b.transfers);
+                        Route replay = b;
+                        evaluate_route(fg, model, replay, k);
+                        CHECK(close(replay.time, b.time) && replay.transfers == b.transfers);
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "algorithms.hpp"
+#include "generator.hpp"
+#include "matrix.hpp"
+#include "output_buffer.hpp"
+#include "report.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Число в позиции pos документа (после ключа), как его прочтет JSON-парсер.
+double number_after(const std::string& doc, const std::string& key, std::size_t& pos) {
+    pos = doc.find(key, pos);
+    CHECK(pos != std::string::npos);
+    pos += key.size();
+    return std::strtod(doc.c_str() + pos, nullptr);
+}
+
+// Скобки сбалансированы, строки без управляющих символов.
+void check_balanced(const std::string& doc) {
+    int depth = 0;
+    for (const char c : doc) {
+        CHECK(static_cast<unsigned char>(c) >= 0x20);
+        if (c == '{' || c == '[') ++depth;
+        if (c == '}' || c == ']') --depth;
+        CHECK(depth >= 0);
+    }
+    CHECK(depth == 0);
+}
+
+} // namespace
+
+int main() {
+    // Числа: целые и кратчайшая запись double, читаемая обратно без потерь.
+    {
+        OutputBuffer out;
+        out.put_int(-42);
+        out.put(' ');
+        out.put_double(0.1 + 0.2);
+        out.put(' ');
+        out.put_fixed(20.955, 2);
+        std::istringstream in(out.str());
+        long long a = 0;
+        double b = 0.0;
+        std::string c;
+        in >> a >> b >> c;
+        CHECK(a == -42);
+        CHECK(b == 0.1 + 0.2);
+        std::ostringstream fixed;
+        fixed.setf(std::ios::fixed);
+        fixed.precision(2);
+        fixed << 20.955;
+        CHECK(c == fixed.str());
+    }
+
+    // С потоком буфер отдает текст блоками; итог тот же, что без потока.
+    {
+        std::ostringstream sink;
+        std::string expected;
+        {
+            OutputBuffer out(&sink, 16);
+            for (int i = 0; i < 100; ++i) {
+                out.put_int(i);
+                out.put(',');
+                expected += std::to_string(i) + ",";
+            }
+            CHECK(sink.str().size() >= 16); // часть ушла до конца
+        }
+        CHECK(sink.str() == expected);
+    }
+
+    GeneratorParams params;
+    params.stations = 400;
+    params.queries = 10;
+    params.pockets = 2;
+    const GeneratedNetwork net = generate_network(params);
+    const Graph g = generated_graph(net);
+    const FrozenGraph fg = freeze_graph(g);
+
+    // Зоны: те же компоненты, что в текстовом отчете, без крупнейшей.
+    {
+        OutputBuffer out;
+        write_zones_json(out, fg);
+        const std::string doc = out.take();
+        check_balanced(doc);
+        CHECK(doc.rfind("{\"metro\":[", 0) == 0);
+        const std::vector<std::vector<int>> all = get_connected_components(fg, TransportType::All);
+        std::string expected = ",\"all\":[";
+        for (std::size_t i = 1; i < all.size(); ++i) {
+            expected += i > 1 ? ",[" : "[";
+            for (std::size_t j = 0; j < all[i].size(); ++j) {
+                expected += (j > 0 ? "," : "") + std::to_string(all[i][j]);
+            }
+            expected += "]";
+        }
+        expected += "]}";
+        CHECK(doc.size() >= expected.size());
+        CHECK(doc.compare(doc.size() - expected.size(), expected.size(), expected) == 0);
+    }
+
+    // Маршруты: время и пересадки совпадают с найденными, шаги — с путем.
+    for (const Request& rq : net.requests) {
+        const std::vector<Route> routes = solve_request(fg, net.model, rq);
+        OutputBuffer out;
+        write_request_json(out, rq, routes);
+        const std::string doc = out.take();
+        check_balanced(doc);
+
+        std::size_t pos = 0;
+        CHECK(number_after(doc, "{\"start\":", pos) == rq.start);
+        for (const Route& route : routes) {
+            CHECK(number_after(doc, "{\"target\":", pos) == route.target);
+            if (!route.reachable) {
+                const std::size_t after = pos + std::to_string(route.target).size();
+                CHECK(doc.compare(after, 18, ",\"reachable\":false") == 0);
+                continue;
+            }
+            CHECK(number_after(doc, "\"time\":", pos) == route.time);
+            CHECK(number_after(doc, "\"transfers\":", pos) == route.transfers);
+            CHECK(number_after(doc, "\"metric\":", pos) == route.metric);
+            for (const Step& step : route.steps) {
+                CHECK(number_after(doc, "{\"from\":", pos) == step.from);
+                CHECK(number_after(doc, "\"to\":", pos) == step.to);
+                const std::string mode = std::string("\"mode\":\"") + mode_label(step.mode) + "\"";
+                CHECK(doc.compare(doc.find("\"mode\":", pos), mode.size(), mode) == 0);
+            }
+        }
+
+        // Текстовый отчет не изменился: путь печатается без промежуточной строки.
+        std::ostringstream text;
+        for (const Route& route : routes) {
+            print_route_formatted(text, route, rq.start);
+        }
+        std::string expected;
+        for (const Route& route : routes) {
+            std::ostringstream line;
+            line.setf(std::ios::fixed);
+            line.precision(2);
+            line << "Destination: " << route.target << " | ";
+            if (route.reachable) {
+                line << "Time: " << route.time << " | Transfers: " << route.transfers
+                     << " | Metric: " << route.metric << " | Path: " << format_path(route, rq.start);
+            } else {
+                line << "Time: INF | Transfers: INF | Metric: INF | Path: unreachable";
+            }
+            expected += line.str() + "\n";
+        }
+        CHECK(text.str() == expected);
+    }
+
+    // Матрица: недостижимые ячейки — null, без ячеек — только станции.
+    {
+        TravelMatrix m;
+        m.sources = {1, 2};
+        m.targets = {3};
+        m.time = {2.5, std::numeric_limits<double>::infinity()};
+        m.transfers = {1, -1};
+        OutputBuffer out;
+        write_matrix_json(out, m, true);
+        CHECK(out.take() == "{\"sources\":[1,2],\"targets\":[3],\"time\":[[2.5],[null]],\"transfers\":[[1],[null]]}");
+        write_matrix_json(out, m, false);
+        CHECK(out.take() == "{\"sources\":[1,2],\"targets\":[3]}");
+    }
+
+    return 0;
+}
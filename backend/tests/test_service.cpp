@@ -0,0 +1,78 @@
+#include "service.hpp"
+#include "stats.hpp"
+#include "test_support.hpp"
+
+#include <string>
+
+namespace {
+
+const char* const kNetwork =
+    "3 2\n"
+    "1 1 1\n"
+    "0 1 1\n"
+    "1 0 1\n"
+    "1 1 0\n"
+    "0 0 0\n"
+    "1 2 0 5 0\n"
+    "2 3 0 5 0\n";
+
+const char* const kRequests =
+    "1\n"
+    "1 1 0.5 3\n";
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+} // namespace
+
+int main() {
+    ServiceCore core;
+    std::string response;
+
+    CHECK(!core.handle("GET", "/api/nothing", "", "", response));
+    CHECK(core.handle("GET", "/api/health", "", "", response));
+    CHECK(contains(response, "\"stdout\": \"empty\\n\""));
+
+    // Полный вход решается по сети из тела, но загруженной ее не делает.
+    const std::string input = std::string(kNetwork) + kRequests;
+    CHECK(core.handle("POST", "/api/run", "", input, response));
+    CHECK(contains(response, "\"ok\": true"));
+    CHECK(contains(response, "Time: 10.00"));
+    CHECK(core.handle("POST", "/api/route", "", kRequests, response));
+    CHECK(contains(response, "no network loaded"));
+
+    CHECK(core.handle("POST", "/api/network", "", kNetwork, response));
+    CHECK(core.handle("POST", "/api/run", "", input, response));
+    CHECK(contains(response, "Time: 10.00"));
+
+    // После изменения весов текст сети больше не описывает загруженную сеть:
+    // тело /api/run, начинающееся с перевода строки, разбирается целиком
+    // заново, а не как один блок запросов к измененной сети.
+    CHECK(core.handle("POST", "/api/deltas", "", "1\n0 1 0\n", response));
+    CHECK(contains(response, "\"ok\": true"));
+    CHECK(core.handle("POST", "/api/route", "", kRequests, response));
+    CHECK(contains(response, "Time: 6.00"));
+
+    CHECK(core.handle("POST", "/api/run", "", "\n" + input, response));
+    CHECK(contains(response, "\"ok\": true"));
+    CHECK(contains(response, "Time: 10.00"));
+    CHECK(core.handle("POST", "/api/route", "", kRequests, response));
+    CHECK(contains(response, "Time: 6.00"));
+    CHECK(!contains(response, "\"stats\""));
+
+    // Счетчики одного ответа, а не всего потока: один запрос — один поиск
+    // и при повторе.
+    for (int i = 0; i < 2; ++i) {
+        CHECK(core.handle("POST", "/api/route", "stats=1", kRequests, response));
+        if (kStatsEnabled) {
+            CHECK(contains(response, "\"stats\": {\"enabled\":true"));
+            CHECK(contains(response, "\"parsed_requests\":1,"));
+            CHECK(contains(response, "\"searches\":1,"));
+        } else {
+            CHECK(contains(response, "\"stats\": {\"enabled\":false}"));
+        }
+    }
+
+    return 0;
+}
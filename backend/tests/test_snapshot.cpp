@@ -0,0 +1,62 @@
+#include "snapshot.hpp"
+#include "test_support.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const std::string kPath = "test_snapshot.snap";
+
+// Записать int по индексу index секции id, не трогая заголовок.
+void poke(int id, std::size_t index, int value) {
+    std::FILE* f = std::fopen(kPath.c_str(), "r+b");
+    CHECK(f != nullptr);
+    SnapshotHeader h;
+    CHECK(std::fread(&h, sizeof(h), 1, f) == 1);
+    std::fseek(f, static_cast<long>(h.sections[id].offset + index * sizeof(int)), SEEK_SET);
+    std::fwrite(&value, sizeof(value), 1, f);
+    std::fclose(f);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "start\n";
+
+    const int n = 20;
+    Graph g;
+    graph_init(g, n);
+    TestRandom next(7u);
+    add_random_edges(g, next, n, 40);
+    const FrozenGraph fg = freeze_graph(g);
+    const ModelParams model = random_model(n);
+
+    std::string error;
+    CHECK(write_snapshot(kPath, fg, model, error));
+    Snapshot snap;
+    CHECK(load_snapshot(kPath, snap, false, error));
+    CHECK(snap.g.n == n && snap.g.m == fg.m);
+    CHECK(load_snapshot(kPath, snap, true, error));
+
+    // Массивы-индексы проверяются и без verify: заголовок у испорченного
+    // файла верен, контрольную сумму данных никто не считает.
+    poke(kSectionTo, 3, n + 1);
+    CHECK(!load_snapshot(kPath, snap, false, error) && error == "snapshot: arc to invalid station");
+
+    CHECK(write_snapshot(kPath, fg, model, error));
+    poke(kSectionOffsets, 5, -1);
+    CHECK(!load_snapshot(kPath, snap, false, error) && error == "snapshot: corrupted offsets");
+
+    CHECK(write_snapshot(kPath, fg, model, error));
+    poke(kSectionEdgeId, 0, -2);
+    CHECK(!load_snapshot(kPath, snap, false, error) && error == "snapshot: invalid edge id");
+
+    CHECK(write_snapshot(kPath, fg, model, error));
+    poke(kSectionLabelsAll, 1, 1 << 30);
+    CHECK(!load_snapshot(kPath, snap, false, error) && error == "snapshot: invalid zone label");
+
+    std::remove(kPath.c_str());
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "algorithms.hpp"
+#include "batch.hpp"
+#include "generator.hpp"
+#include "parser.hpp"
+#include "stats.hpp"
+#include "test_support.hpp"
+#include "validator.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::uint64_t counter(const StatsBlock& s, Counter c) {
+    return s.counters[static_cast<std::size_t>(c)];
+}
+
+} // namespace
+
+int main() {
+    GeneratorParams params;
+    params.stations = 900;
+    params.queries = 20;
+    const GeneratedNetwork net = generate_network(params);
+    std::ostringstream text;
+    write_network_text(text, net);
+
+    stats_reset();
+    InputData data;
+    std::string error;
+    std::istringstream in(text.str());
+    CHECK(parse_all(in, data, error));
+    CHECK(validate_all(data, error));
+    const FrozenGraph fg = freeze_graph(data.g);
+
+    if (!kStatsEnabled) {
+        // Учет вырезан при сборке: счетчики остаются нулевыми.
+        const StatsBlock s = stats_collect();
+        for (const std::uint64_t x : s.counters) {
+            CHECK(x == 0);
+        }
+        std::ostringstream json;
+        write_stats_json(json, s);
+        CHECK(json.str() == "{\"stats\":{\"enabled\":false}}");
+        return 0;
+    }
+
+    {
+        const StatsBlock s = stats_collect();
+        CHECK(counter(s, Counter::ParsedBytes) == text.str().size());
+        CHECK(counter(s, Counter::ParsedEdges) == net.edges.size());
+        CHECK(counter(s, Counter::ParsedRequests) == net.requests.size());
+        CHECK(counter(s, Counter::ValidatedArcs) == 2 * net.edges.size());
+        CHECK(counter(s, Counter::ValidatedRequests) == net.requests.size());
+    }
+
+    // DFS открывает каждую вершину один раз и просматривает каждую дугу.
+    stats_reset();
+    get_connected_components(fg, TransportType::All);
+    {
+        const StatsBlock s = stats_collect();
+        CHECK(counter(s, Counter::DfsVertices) == static_cast<std::uint64_t>(fg.n));
+        CHECK(counter(s, Counter::DfsArcs) == fg.arc_count());
+    }
+
+    // Полный проход опустошает очередь: каждая вставка либо окончательна,
+    // либо снята как устаревшая.
+    stats_reset();
+    const DijkstraStateResult dj = dijkstra_states(fg, data.model, 1);
+    static_cast<void>(dj);
+    {
+        const StatsBlock s = stats_collect();
+        CHECK(counter(s, Counter::Searches) == 1);
+        CHECK(counter(s, Counter::HeapPushes) > 0);
+        CHECK(counter(s, Counter::HeapPushes) == counter(s, Counter::SettledStates) + counter(s, Counter::StalePops));
+        CHECK(counter(s, Counter::Relaxations) >= counter(s, Counter::HeapPushes) - 1);
+    }
+
+    // Двунаправленный поиск — тоже один поиск.
+    stats_reset();
+    bidirectional_route(fg, data.model, 1, fg.n / 2, 0.0);
+    CHECK(counter(stats_collect(), Counter::Searches) == 1);
+
+    // Потоки пула сливают свои блоки: сумма та же, что при одном потоке.
+    SearchOptions options;
+    options.bidirectional = false;
+    stats_reset();
+    solve_batch(fg, data.model, options, data.requests, 1, [](std::size_t, const std::vector<Route>&) {});
+    const StatsBlock one = stats_collect();
+    stats_reset();
+    solve_batch(fg, data.model, options, data.requests, 4, [](std::size_t, const std::vector<Route>&) {});
+    const StatsBlock four = stats_collect();
+    CHECK(counter(one, Counter::Searches) == data.requests.size());
+    for (const Counter c : {Counter::Searches, Counter::HeapPushes, Counter::StalePops,
+                            Counter::SettledStates, Counter::Relaxations}) {
+        CHECK(counter(one, c) == counter(four, c));
+    }
+    CHECK(one.phase_ns[static_cast<std::size_t>(Phase::Search)] > 0);
+
+    // Исключение sink или body доходит до вызывающего, потоки присоединены.
+    bool thrown = false;
+    try {
+        solve_batch(fg, data.model, options, data.requests, 4, [](std::size_t i, const std::vector<Route>&) {
+            if (i == 1) {
+                throw std::runtime_error("sink");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    thrown = false;
+    try {
+        parallel_for(100, 4, [](std::size_t i) {
+            if (i == 7) {
+                throw std::runtime_error("body");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    std::ostringstream json;
+    write_stats_json(json, four);
+    const std::string line = json.str();
+    CHECK(line.rfind("{\"stats\":{\"enabled\":true,\"counters\":{", 0) == 0);
+    CHECK(line.find("\"heap_pushes\":" + std::to_string(counter(four, Counter::HeapPushes))) != std::string::npos);
+    CHECK(line.find("\"phases_ms\":{\"parse\":") != std::string::npos);
+    CHECK(line.find('\n') == std::string::npos);
+
+    return 0;
+}
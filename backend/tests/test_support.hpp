@@ -0,0 +1,82 @@
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include "algorithms.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Общие заготовки тестов: проверка, модель, случайные сети и сравнение ответов.
+
+// Проверка теста. В отличие от assert, не выключается NDEBUG: тесты
+// проверяют и в Release-сборке.
+[[noreturn]] inline void check_failed(const char* expr, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    std::abort();
+}
+
+#define CHECK(cond) ((cond) ? static_cast<void>(0) : check_failed(#cond, __FILE__, __LINE__))
+
+// Линейный конгруэнтный генератор: одна и та же последовательность на всех
+// платформах, в отличие от std::rand.
+class TestRandom {
+public:
+    explicit TestRandom(unsigned seed) : seed_(seed) {}
+
+    // Число в [0, mod).
+    unsigned operator()(unsigned mod) {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return (seed_ >> 16) % mod;
+    }
+
+private:
+    unsigned seed_;
+};
+
+// Модель случайных сетей: штрафы пересадок различны по видам, у всех
+// станций штраф station.
+inline ModelParams random_model(int n, double station = 0.25) {
+    ModelParams model{};
+    model.sensitivity = {1.0, 2.0, 0.5};
+    for (auto& row : model.trans) {
+        row = {0.5, 1.5, 2.0};
+    }
+    model.station_transfer.assign(static_cast<std::size_t>(n) + 1, station);
+    return model;
+}
+
+// count случайных рёбер между станциями 1..stations; станции выше stations
+// остаются изолированными.
+inline void add_random_edges(Graph& g, TestRandom& next, int stations, int count) {
+    const unsigned range = static_cast<unsigned>(stations);
+    for (int i = 0; i < count; ++i) {
+        graph_add_undirected(g, 1 + static_cast<int>(next(range)), 1 + static_cast<int>(next(range)),
+                             static_cast<int>(next(3)), 1.0 + next(9), 0.1 * next(11));
+    }
+}
+
+inline bool close(double a, double b) {
+    return a == b || std::fabs(a - b) <= 1e-9 * std::fmax(1.0, std::fabs(a));
+}
+
+// Ответы совпадают бит в бит, вместе с шагами.
+inline void expect_same_routes(const std::vector<Route>& a, const std::vector<Route>& b) {
+    CHECK(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        CHECK(a[i].target == b[i].target);
+        CHECK(a[i].reachable == b[i].reachable);
+        CHECK(a[i].time == b[i].time);
+        CHECK(a[i].transfers == b[i].transfers);
+        CHECK(a[i].steps.size() == b[i].steps.size());
+        for (std::size_t j = 0; j < a[i].steps.size(); ++j) {
+            CHECK(a[i].steps[j].from == b[i].steps[j].from);
+            CHECK(a[i].steps[j].to == b[i].steps[j].to);
+            CHECK(a[i].steps[j].mode == b[i].steps[j].mode);
+        }
+    }
+}
+
+#endif // TEST_SUPPORT_HPP
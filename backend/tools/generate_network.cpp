@@ -0,0 +1,289 @@
+// Генератор синтетических сетей мегаполиса (generator.hpp) для проверок на
+// масштабе: текст в формате parse_all в stdout или --out, с --snapshot — сеть
+// в файл снимка, а в текст идут только запросы (для railway_navigator --snapshot).
+//
+//   generate_network --stations 1000000 --seed 7 --out city.txt
+//   generate_network --stations 1000000 --snapshot city.snap --out queries.txt
+#include "frozen_graph.hpp"
+#include "generator.hpp"
+#include "snapshot.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    GeneratorParams params;
+    std::string out_path;      // --out: текст в файл, по умолчанию stdout
+    std::string snapshot_path; // --snapshot: сеть в файл снимка
+    int threads = 1;           // --threads: потоки записи снимка
+};
+
+const char* const kUsage =
+    "usage: generate_network [--stations N] [--seed S] [--bus-density P]\n"
+    "       [--metro-radials R] [--metro-rings K] [--metro-spacing D] [--ring-spacing D]\n"
+    "       [--rail-corridors C] [--rail-spacing D] [--load uniform|center|bimodal] [--load-max X]\n"
+    "       [--pockets P] [--pocket-size S] [--queries Q] [--max-targets T] [--local-radius R]\n"
+    "       [--mix LOCAL,CROSS,HUB,POCKET] [--matrices P] [--matrix-size S]\n"
+    "       [--out FILE] [--snapshot FILE] [--threads T]\n";
+
+// Значение опции: "--name value" или "--name=value".
+bool option_value(int argc, char** argv, int& i, const std::string& name, std::string& value, bool& matched) {
+    const std::string arg = argv[i];
+    matched = false;
+    if (arg == name) {
+        matched = true;
+        if (i + 1 >= argc) {
+            return false;
+        }
+        value = argv[++i];
+        return true;
+    }
+    if (arg.rfind(name + "=", 0) == 0) {
+        matched = true;
+        value = arg.substr(name.size() + 1);
+        return true;
+    }
+    return true;
+}
+
+bool parse_int(const std::string& text, int& x) {
+    char* end = nullptr;
+    const long long value = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > 2000000000LL) {
+        return false;
+    }
+    x = static_cast<int>(value);
+    return true;
+}
+
+bool parse_double(const std::string& text, double& x) {
+    char* end = nullptr;
+    x = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+bool parse_seed(const std::string& text, std::uint64_t& x) {
+    char* end = nullptr;
+    x = std::strtoull(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && text[0] != '-';
+}
+
+bool parse_load(const std::string& text, LoadProfile& load) {
+    if (text == "uniform") load = LoadProfile::Uniform;
+    else if (text == "center") load = LoadProfile::Center;
+    else if (text == "bimodal") load = LoadProfile::Bimodal;
+    else return false;
+    return true;
+}
+
+// "LOCAL,CROSS,HUB,POCKET"
+bool parse_mix(const std::string& text, GeneratorParams& p) {
+    double* shares[] = {&p.mix_local, &p.mix_cross, &p.mix_hub, &p.mix_pocket};
+    std::size_t pos = 0;
+    for (int k = 0; k < 4; ++k) {
+        const std::size_t comma = k < 3 ? text.find(',', pos) : text.size();
+        if (comma == std::string::npos || (k == 3 && text.find(',', pos) != std::string::npos)) {
+            return false;
+        }
+        if (!parse_double(text.substr(pos, comma - pos), *shares[k])) {
+            return false;
+        }
+        pos = comma + 1;
+    }
+    return true;
+}
+
+bool parse_options(int argc, char** argv, Options& options, std::string& error) {
+    GeneratorParams& p = options.params;
+    struct IntOption {
+        const char* name;
+        int* target;
+    };
+    const IntOption ints[] = {
+        {"--stations", &p.stations},         {"--metro-radials", &p.metro_radials},
+        {"--metro-rings", &p.metro_rings},   {"--metro-spacing", &p.metro_spacing},
+        {"--ring-spacing", &p.ring_spacing}, {"--rail-corridors", &p.rail_corridors},
+        {"--rail-spacing", &p.rail_spacing}, {"--pockets", &p.pockets},
+        {"--pocket-size", &p.pocket_size},   {"--queries", &p.queries},
+        {"--max-targets", &p.max_targets},   {"--local-radius", &p.local_radius},
+        {"--matrices", &p.matrices},         {"--matrix-size", &p.matrix_size},
+        {"--threads", &options.threads},
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        bool matched = false;
+        bool handled = false;
+
+        for (const IntOption& opt : ints) {
+            if (!option_value(argc, argv, i, opt.name, value, matched)) {
+                error = std::string("options: ") + opt.name + " requires a value";
+                return false;
+            }
+            if (matched) {
+                if (!parse_int(value, *opt.target)) {
+                    error = std::string("options: ") + opt.name + " must be a non-negative integer";
+                    return false;
+                }
+                handled = true;
+                break;
+            }
+        }
+        if (handled) {
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--seed", value, matched)) {
+            error = "options: --seed requires a value";
+            return false;
+        }
+        if (matched) {
+            if (!parse_seed(value, p.seed)) {
+                error = "options: --seed must be an unsigned integer";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--bus-density", value, matched)) {
+            error = "options: --bus-density requires a value";
+            return false;
+        }
+        if (matched) {
+            if (!parse_double(value, p.bus_density)) {
+                error = "options: --bus-density must be a number";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--load-max", value, matched)) {
+            error = "options: --load-max requires a value";
+            return false;
+        }
+        if (matched) {
+            if (!parse_double(value, p.load_max)) {
+                error = "options: --load-max must be a number";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--load", value, matched)) {
+            error = "options: --load requires uniform, center or bimodal";
+            return false;
+        }
+        if (matched) {
+            if (!parse_load(value, p.load)) {
+                error = "options: --load must be uniform, center or bimodal";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--mix", value, matched)) {
+            error = "options: --mix requires LOCAL,CROSS,HUB,POCKET";
+            return false;
+        }
+        if (matched) {
+            if (!parse_mix(value, p)) {
+                error = "options: --mix expects four numbers LOCAL,CROSS,HUB,POCKET";
+                return false;
+            }
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--out", value, matched)) {
+            error = "options: --out requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.out_path = value;
+            continue;
+        }
+
+        if (!option_value(argc, argv, i, "--snapshot", value, matched)) {
+            error = "options: --snapshot requires a file path";
+            return false;
+        }
+        if (matched) {
+            options.snapshot_path = value;
+            continue;
+        }
+
+        error = std::string("options: unknown option ") + argv[i] + "\n" + kUsage;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--help") {
+            std::cout << kUsage;
+            return 0;
+        }
+    }
+
+    Options options;
+    std::string error;
+    if (!parse_options(argc, argv, options, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    GeneratedNetwork net;
+    try {
+        net = generate_network(options.params);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    int per_mode[3] = {0, 0, 0};
+    for (const GeneratedEdge& e : net.edges) {
+        ++per_mode[e.mode];
+    }
+    std::cerr << "generated: " << net.n << " stations (grid " << net.side << " wide), " << net.edges.size()
+              << " edges (metro " << per_mode[0] << ", bus " << per_mode[1] << ", rail " << per_mode[2] << "), "
+              << net.requests.size() << " queries, " << net.matrices.size() << " matrices\n";
+
+    if (!options.snapshot_path.empty()) {
+        const FrozenGraph fg = freeze_graph(generated_graph(net));
+        if (!write_snapshot(options.snapshot_path, fg, net.model, error, options.threads)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::cerr << "snapshot: " << options.snapshot_path << "\n";
+    }
+
+    std::ofstream file;
+    if (!options.out_path.empty()) {
+        file.open(options.out_path, std::ios::binary);
+        if (!file) {
+            std::cerr << "generate_network: cannot open " << options.out_path << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.out_path.empty() ? std::cout : file;
+    if (options.snapshot_path.empty()) {
+        write_network_text(out, net);
+    } else {
+        write_requests_text(out, net);
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "generate_network: write failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -244,80 +244,49 @@
     return line.trim();
   }
 
-  function extractFirstRoute(output) {
-    if (!output) {
-      return "";
-    }
-    const pattern = /Path:\s*([^\r\n]+)/g;
-    let match = null;
-    while ((match = pattern.exec(output)) !== null) {
-      const path = match[1].trim();
-      if (path && path !== "unreachable") {
-        return path;
+  // Первый достижимый маршрут отчета (--format json) в текстовом виде
+  // "u-[mode]->v ...", как его читает parseRoute.
+  function firstRouteFromResult(result) {
+    const requests = result && Array.isArray(result.requests) ? result.requests : [];
+    for (const request of requests) {
+      for (const route of request.routes || []) {
+        if (!route.reachable) {
+          continue;
+        }
+        if (!route.steps || route.steps.length === 0) {
+          return String(request.start);
+        }
+        return route.steps
+          .map((step) => `${step.from}-[${step.mode}]->${step.to}`)
+          .join(" ");
       }
     }
     return "";
   }
 
-  function parseBackendZones(output) {
+  // Зоны отчета (--format json) в виде, который ждет renderReport.
+  function zonesFromResult(result) {
     const zones = {
       metro: null,
       bus: null,
       rail: null,
       all: null,
     };
-    if (!output) {
-      return zones;
-    }
-
-    const lines = output.split(/\r?\n/);
-    let currentMode = null;
-
-    lines.forEach((rawLine) => {
-      const line = rawLine.trim();
-      const headerMatch = line.match(/^ISOLATED ZONES \(([^)]+)\)$/);
-      if (headerMatch) {
-        currentMode = headerMatch[1];
-        zones[currentMode] = { components: [], none: false };
-        return;
-      }
-
-      if (!currentMode) {
+    const source = result && result.zones ? result.zones : {};
+    Object.keys(zones).forEach((mode) => {
+      const list = source[mode];
+      if (!Array.isArray(list)) {
         return;
       }
-
-      if (!line) {
-        currentMode = null;
-        return;
-      }
-
-      if (line === "None") {
-        zones[currentMode] = { components: [], none: true };
-        currentMode = null;
-        return;
-      }
-
-      const componentMatch = line.match(/^(\d+)\.\s+(\d+)\s+stations:\s+(.+)$/);
-      if (componentMatch) {
-        const index = Number(componentMatch[1]);
-        const size = Number(componentMatch[2]);
-        const stations = componentMatch[3]
-          .trim()
-          .split(/\\s+/)
-          .map((value) => Number(value))
-          .filter((value) => Number.isInteger(value));
-
-        if (!zones[currentMode]) {
-          zones[currentMode] = { components: [], none: false };
-        }
-        zones[currentMode].components.push({
-          index,
-          size,
+      zones[mode] = {
+        components: list.map((stations, i) => ({
+          index: i + 1,
+          size: stations.length,
           stations,
-        });
-      }
+        })),
+        none: list.length === 0,
+      };
     });
-
     return zones;
   }
 
@@ -325,7 +294,7 @@
     const response = await fetch(BACKEND_ENDPOINT, {
       method: "POST",
       headers: { "Content-Type": "application/json" },
-      body: JSON.stringify({ input: inputText }),
+      body: JSON.stringify({ input: inputText, format: "json" }),
     });
 
     let payload = {};
@@ -365,10 +334,10 @@
       }
 
       reportState.backendError = null;
-      reportState.zones = parseBackendZones(result.stdout);
+      reportState.zones = zonesFromResult(result.result);
       renderReport(reportState);
 
-      const routeFromBackend = extractFirstRoute(result.stdout);
+      const routeFromBackend = firstRouteFromResult(result.result);
       if (routeFromBackend && routeEl && !routeEl.value.trim()) {
         routeEl.value = routeFromBackend;
         if (canUpdateBuildStatus()) {
@@ -871,10 +840,10 @@
       }
 
       reportState.backendError = null;
-      reportState.zones = parseBackendZones(result.stdout);
+      reportState.zones = zonesFromResult(result.result);
       renderReport(reportState);
 
-      const routeFromBackend = extractFirstRoute(result.stdout);
+      const routeFromBackend = firstRouteFromResult(result.result);
       if (!routeFromBackend || routeFromBackend === "unreachable") {
         setStatus("Маршрут не найден");
         return;
@@ -1,13 +1,16 @@
 #!/usr/bin/env python3
 import argparse
+import http.client
 import json
 import os
+import queue
+import select
 from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
 from pathlib import Path
 import subprocess
 import sys
 import time
-from urllib.parse import urlparse
+from urllib.parse import parse_qs, urlparse
 
 ROOT = Path(__file__).resolve().parent
 DEFAULT_FRONTEND_DIR = ROOT / "frontend"
@@ -77,11 +80,74 @@ def try_patch_input(text: str) -> str:
     return f"{text}\n0\n"
 
 
+STATS_PREFIX = '{"stats":'
+
+
+def split_stats(stderr: str):
+    """Take the --stats JSON line (the last non-empty stderr line) out of stderr."""
+    lines = stderr.splitlines(keepends=True)
+    for i in range(len(lines) - 1, -1, -1):
+        line = lines[i].strip()
+        if not line:
+            continue
+        if not line.startswith(STATS_PREFIX):
+            break
+        try:
+            stats = json.loads(line)["stats"]
+        except (ValueError, KeyError, TypeError):
+            break
+        del lines[i]
+        return "".join(lines), stats
+    return stderr, None
+
+
+class ServiceClient:
+    """Keep-alive client for the resident backend (railway_navigator --serve)."""
+
+    def __init__(self, url, timeout):
+        parsed = urlparse(url if "://" in url else f"http://{url}")
+        self.host = parsed.hostname or "127.0.0.1"
+        self.port = parsed.port or 8090
+        self.timeout = timeout
+        self._pool = queue.LifoQueue()
+
+    def _connection(self):
+        """A pooled connection the service has not closed, or a new one."""
+        while True:
+            try:
+                conn = self._pool.get_nowait()
+            except queue.Empty:
+                return http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+            # An idle keep-alive socket turns readable only when the service closed it.
+            if conn.sock is not None and not select.select([conn.sock], [], [], 0)[0]:
+                return conn
+            conn.close()
+
+    def post(self, path, body):
+        # A POST is not resent: once any byte has gone out, the service may have
+        # acted on it. Closed pooled connections are dropped before sending instead.
+        conn = self._connection()
+        try:
+            conn.request("POST", path, body=body, headers={"Content-Type": "text/plain"})
+            response = conn.getresponse()
+            data = response.read()
+        except (OSError, http.client.HTTPException):
+            conn.close()
+            raise
+        if response.getheader("Connection", "").lower() == "close":
+            conn.close()
+        else:
+            self._pool.put(conn)
+        return json.loads(data.decode("utf-8"))
+
+
 class RailwayServer(ThreadingHTTPServer):
-    def __init__(self, server_address, handler_cls, backend_path, timeout):
+    def __init__(self, server_address, handler_cls, backend_path, timeout, service_url=None, stats=True):
         super().__init__(server_address, handler_cls)
         self.backend_path = Path(backend_path)
         self.backend_timeout = timeout
+        self.backend_stats = stats
+        self.service = ServiceClient(service_url, timeout) if service_url else None
 
 
 class Handler(SimpleHTTPRequestHandler):
@@ -98,9 +164,12 @@ class Handler(SimpleHTTPRequestHandler):
         self.send_error(404, "Not Found")
 
     def do_POST(self):
-        if urlparse(self.path).path.rstrip("/") != "/api/run":
+        url = urlparse(self.path)
+        if url.path.rstrip("/") != "/api/run":
             self.send_error(404, "Not Found")
             return
+        # format=json: the report comes back parsed in "result" (backend --format json).
+        output_format = parse_qs(url.query).get("format", ["text"])[-1]
 
         length = int(self.headers.get("Content-Length", "0"))
         raw = self.rfile.read(length)
@@ -115,6 +184,8 @@ class Handler(SimpleHTTPRequestHandler):
                     self.send_json(400, {"ok": False, "error": "invalid json"})
                     return
                 input_text = payload.get("input", "") if isinstance(payload, dict) else ""
+                if isinstance(payload, dict) and "format" in payload:
+                    output_format = payload["format"]
             else:
                 input_text = raw.decode("utf-8", errors="replace")
 
@@ -122,8 +193,17 @@ class Handler(SimpleHTTPRequestHandler):
             self.send_json(400, {"ok": False, "error": "input must be a string"})
             return
 
+        if output_format not in ("text", "json"):
+            self.send_json(400, {"ok": False, "error": "format must be text or json"})
+            return
+        as_json = output_format == "json"
+
         input_text = try_patch_input(input_text)
 
+        if self.server.service is not None:
+            self.proxy_to_service(input_text, as_json)
+            return
+
         backend_path = self.server.backend_path
         if not backend_path.exists():
             self.send_json(
@@ -138,8 +218,13 @@ class Handler(SimpleHTTPRequestHandler):
 
         start = time.time()
         try:
+            command = [str(backend_path)]
+            if self.server.backend_stats:
+                command.append("--stats")
+            if as_json:
+                command.append("--format=json")
             result = subprocess.run(
-                [str(backend_path)],
+                command,
                 input=input_text,
                 text=True,
                 capture_output=True,
@@ -154,13 +239,33 @@ class Handler(SimpleHTTPRequestHandler):
             return
 
         duration_ms = int((time.time() - start) * 1000)
+        stderr, stats = split_stats(result.stderr)
         payload = {
             "ok": result.returncode == 0,
             "exit_code": result.returncode,
             "stdout": result.stdout,
-            "stderr": result.stderr,
+            "stderr": stderr,
             "duration_ms": duration_ms,
         }
+        if as_json and result.returncode == 0:
+            try:
+                payload["result"] = json.loads(result.stdout)
+                payload["stdout"] = ""
+            except json.JSONDecodeError:
+                pass
+        if stats is not None:
+            payload["stats"] = stats
+        self.send_json(200, payload)
+
+    def proxy_to_service(self, input_text, as_json=False):
+        # stats=1: the service adds the counters of this request as "stats".
+        params = [name for name, on in (("format=json", as_json), ("stats=1", self.server.backend_stats)) if on]
+        path = "/api/run" + ("?" + "&".join(params) if params else "")
+        try:
+            payload = self.server.service.post(path, input_text.encode("utf-8"))
+        except (OSError, http.client.HTTPException, ValueError) as exc:
+            self.send_json(200, {"ok": False, "error": f"service error: {exc}"})
+            return
         self.send_json(200, payload)
 
     def send_json(self, status, payload):
@@ -188,6 +293,18 @@ def build_arg_parser():
         default=os.environ.get("BACKEND_BIN", str(DEFAULT_BACKEND_BIN)),
         help="path to backend binary",
     )
+    parser.add_argument(
+        "--service",
+        default=os.environ.get("BACKEND_SERVICE"),
+        help="URL of a resident backend (railway_navigator --serve); "
+        "when set, /api/run is proxied there instead of spawning the binary",
+    )
+    parser.add_argument(
+        "--no-stats",
+        dest="stats",
+        action="store_false",
+        help="do not run the backend with --stats (no 'stats' field in responses)",
+    )
     parser.add_argument(
         "--timeout",
         type=int,
@@ -208,7 +325,7 @@ def main():
         print(f"Frontend directory not found: {frontend_dir}", file=sys.stderr)
         return 2
 
-    if not backend_path.exists():
+    if not backend_path.exists() and not args.service:
         print(
             f"Warning: backend binary not found: {backend_path}", file=sys.stderr
         )
@@ -217,10 +334,15 @@ def main():
         *handler_args, directory=str(frontend_dir), **handler_kwargs
     )
 
-    server = RailwayServer((args.host, args.port), handler, backend_path, args.timeout)
+    server = RailwayServer(
+        (args.host, args.port), handler, backend_path, args.timeout, args.service, args.stats
+    )
     url = f"http://{args.host}:{args.port}/"
     print(f"Serving frontend from {frontend_dir}")
-    print(f"Backend binary: {backend_path}")
+    if args.service:
+        print(f"Backend service: {args.service}")
+    else:
+        print(f"Backend binary: {backend_path}")
     print(f"Open: {url}")
 
     try: